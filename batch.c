@@ -0,0 +1,443 @@
+/**
+ * @file batch.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the batch mode. Commands are
+ * parsed in place, run without prompts or banners, and their results are
+ * written to a fully buffered output. The time taken by every command is
+ * recorded in a histogram per kind of command with power of two buckets.
+ *
+ * Every command locks the shards of the user index that hold the users it
+ * reads or changes, so several inputs can be run at the same time from
+ * different threads (see server.c).
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include "nodes.h"
+#include "functions.h"
+#include "user_index.h"
+#include "feed.h"
+#include "wal.h"
+#include "histogram.h"
+#include "checkpoint.h"
+#include "search.h"
+#include "trending.h"
+#include "password.h"
+#include "batch.h"
+
+#define DEFAULT_FEED_SIZE 10
+#define MAX_FEED_SIZE 1000
+#define SEARCH_RESULTS 20
+#define DEFAULT_TRENDING_SIZE 10
+
+// The kinds of commands
+typedef enum command
+{
+   COMMAND_ADDUSER,
+   COMMAND_PASSWD,
+   COMMAND_AUTH,
+   COMMAND_POST,
+   COMMAND_DELPOST,
+   COMMAND_DELPOSTID,
+   COMMAND_FRIEND,
+   COMMAND_UNFRIEND,
+   COMMAND_FEED,
+   COMMAND_CHECKPOINT,
+   COMMAND_SEARCH,
+   COMMAND_TRENDING,
+   NUM_COMMANDS
+} command_t;
+
+static const char *command_names[NUM_COMMANDS] = {
+   "ADDUSER", "PASSWD", "AUTH", "POST", "DELPOST", "DELPOSTID", "FRIEND", "UNFRIEND", "FEED", "CHECKPOINT", "SEARCH", "TRENDING"
+};
+
+/*
+   Function that returns the next space separated word of a line and moves the cursor past it.
+   Return NULL when the line has no more words.
+*/
+static char *next_word(char **cursor)
+{
+   char *word = *cursor;
+   while (*word == ' ' || *word == '\t') {
+      word++;
+   }
+   if (*word == '\0') {
+      *cursor = word;
+      return NULL;
+   }
+
+   char *end = word;
+   while (*end != '\0' && *end != ' ' && *end != '\t') {
+      end++;
+   }
+   if (*end != '\0') {
+      *end = '\0';
+      end++;
+   }
+   *cursor = end;
+   return word;
+}
+
+
+/*
+   Function that returns the shards of the user index that hold a user's friends.
+*/
+static shard_mask_t friend_shards(const user_t *user)
+{
+   shard_mask_t mask = 0;
+   for (unsigned int i = 0; i < user->friends.count; i++) {
+      mask |= (shard_mask_t)1 << index_user_by_id(user->friends.ids[i])->shard;
+   }
+   return mask;
+}
+
+
+/*
+   Function that finds a user and locks the shards of the user and of the user's friends,
+   for writing or for reading. The friends can change while no shard is locked, so the
+   shards are locked again until they cover all the friends. The locked shards are stored
+   in read_mask and write_mask. Return the user, or NULL with no shard locked if there is no such user.
+*/
+static user_t *lock_user_and_friends(const char *username, _Bool write_user, _Bool write_friends,
+                                     shard_mask_t *read_mask, shard_mask_t *write_mask)
+{
+   shard_mask_t own = (shard_mask_t)1 << index_shard_of(username);
+   shard_mask_t friends = 0;
+   while (1) {
+      *write_mask = (write_user ? own : 0) | (write_friends ? friends : 0);
+      *read_mask = (own | friends) & ~*write_mask;
+      index_lock_shards(*read_mask, *write_mask);
+
+      user_t *user = index_find_user(username);
+      if (user == NULL) {
+         index_unlock_shards(*read_mask, *write_mask);
+         return NULL;
+      }
+      shard_mask_t needed = friend_shards(user);
+      if ((needed & ~friends) == 0) {
+         return user;
+      }
+      index_unlock_shards(*read_mask, *write_mask);
+      friends = needed;
+   }
+}
+
+
+/*
+   Function that writes a post found by a search to the output.
+*/
+static void write_search_result(const post_t *post, void *output)
+{
+   fprintf(output, "%lu %s: %s\n", post->id, index_user_by_id(post->author)->username, post->content);
+}
+
+
+/*
+   Function that runs one command on a user whose shards are already locked.
+   Return NULL on success or the reason of the failure.
+*/
+static const char *run_user_command(command_t command, user_t *user, char *arguments, FILE *output)
+{
+   switch (command) {
+      case COMMAND_POST:
+         while (*arguments == ' ' || *arguments == '\t') {
+            arguments++;
+         }
+         if (*arguments == '\0') {
+            return "missing text";
+         }
+         add_post(user, arguments);
+         return NULL;
+
+      case COMMAND_DELPOST: {
+         char *number = next_word(&arguments);
+         if (number == NULL) {
+            return "missing post number";
+         }
+         return delete_post(user, atoi(number)) ? NULL : "no such post";
+      }
+
+      case COMMAND_DELPOSTID: {
+         char *id = next_word(&arguments);
+         if (id == NULL) {
+            return "missing post id";
+         }
+         return delete_post_by_id(user, strtoul(id, NULL, 10)) ? NULL : "no such post";
+      }
+
+      case COMMAND_FEED: {
+         char *size = next_word(&arguments);
+         int limit = size != NULL ? atoi(size) : DEFAULT_FEED_SIZE;
+         if (limit <= 0 || limit > MAX_FEED_SIZE) {
+            return "invalid number of posts";
+         }
+
+         post_t *page[MAX_FEED_SIZE];
+         size_t count = feed_page(user, 0, page, limit);
+         for (size_t i = 0; i < count; i++) {
+            fprintf(output, "%lu %s: %s\n", page[i]->id, index_user_by_id(page[i]->author)->username, page[i]->content);
+         }
+         return NULL;
+      }
+
+      default:
+         return "unknown command";
+   }
+}
+
+
+/*
+   Function that runs one command. The arguments follow the command name in the line.
+   The shards of the users that the command reads or changes are locked while it runs,
+   so commands can run from several threads at the same time.
+   Return NULL on success or the reason of the failure.
+*/
+static const char *run_command(command_t command, char *arguments, FILE *output, user_t **users)
+{
+   if (command == COMMAND_CHECKPOINT) {
+      char *path = next_word(&arguments);
+      if (path == NULL) {
+         return "missing file name";
+      }
+      switch (checkpoint_start(path)) {
+         case 0:
+            return NULL;
+         case CHECKPOINT_RUNNING:
+            return "a checkpoint is already running";
+         default:
+            return "the checkpoint thread can not be created";
+      }
+   }
+   if (command == COMMAND_SEARCH) {
+      // the search index has a lock of its own
+      while (*arguments == ' ' || *arguments == '\t') {
+         arguments++;
+      }
+      if (*arguments == '\0') {
+         return "missing query";
+      }
+      search_posts(arguments, SEARCH_RESULTS, write_search_result, output);
+      return NULL;
+   }
+   if (command == COMMAND_TRENDING) {
+      char *window_name = next_word(&arguments);
+      char *size = next_word(&arguments);
+      trending_window_t window = TRENDING_HOUR;
+      if (window_name != NULL && strcmp(window_name, "minute") == 0) {
+         window = TRENDING_MINUTE;
+      } else if (window_name != NULL && strcmp(window_name, "hour") != 0) {
+         return "the window is minute or hour";
+      }
+      int limit = size != NULL ? atoi(size) : DEFAULT_TRENDING_SIZE;
+      if (limit <= 0 || limit > TRENDING_MAX_TOP) {
+         return "invalid number of hashtags";
+      }
+
+      trending_tag_t top[TRENDING_MAX_TOP];
+      size_t count = trending_top(window, time(NULL), top, limit);
+      for (size_t i = 0; i < count; i++) {
+         fprintf(output, "%lu %s\n", top[i].count, top[i].tag);
+      }
+      return NULL;
+   }
+
+   char *username = next_word(&arguments);
+   if (username == NULL) {
+      return "missing username";
+   }
+
+   shard_mask_t own = (shard_mask_t)1 << index_shard_of(username);
+   shard_mask_t read_mask = 0;
+   shard_mask_t write_mask = own;
+   user_t *user;
+   const char *error;
+
+   credential_t credential;
+
+   switch (command) {
+      case COMMAND_ADDUSER:
+      case COMMAND_PASSWD: {
+         char *password = next_word(&arguments);
+         if (password == NULL || strlen(password) > PASSWORD_MAX_LENGTH) {
+            return "missing or too long password";
+         }
+         // hashing takes milliseconds, it is done before the shard is locked
+         password_hash(password, &credential);
+         index_lock_shards(0, own);
+         if (command == COMMAND_ADDUSER) {
+            error = insert_user_credential(users, username, &credential) != NULL ? NULL : "username taken or too long";
+         } else if ((user = index_find_user(username)) != NULL) {
+            set_credential(user, &credential);
+            error = NULL;
+         } else {
+            error = "unknown user";
+         }
+         index_unlock_shards(0, own);
+         return error;
+      }
+
+      case COMMAND_AUTH: {
+         char *password = next_word(&arguments);
+         if (password == NULL) {
+            return "missing password";
+         }
+         // the credential is copied so that the password is checked without the lock
+         index_lock_shards(own, 0);
+         user = index_find_user(username);
+         if (user != NULL) {
+            credential = user->credential;
+         }
+         index_unlock_shards(own, 0);
+         if (user == NULL) {
+            return "unknown user";
+         }
+         return password_verify(password, &credential) ? NULL : "wrong password";
+      }
+
+      case COMMAND_POST:
+         // the new post is pushed to the friends' timelines
+         user = lock_user_and_friends(username, 1, 1, &read_mask, &write_mask);
+         break;
+
+      case COMMAND_FEED:
+         // feeds are read under read locks, unless the user's timeline needs to be built first
+         user = lock_user_and_friends(username, 0, 0, &read_mask, &write_mask);
+         if (user != NULL && (user->timeline == NULL || !user->timeline->built)) {
+            index_unlock_shards(read_mask, write_mask);
+            user = lock_user_and_friends(username, 1, 0, &read_mask, &write_mask);
+         }
+         break;
+
+      case COMMAND_FRIEND:
+      case COMMAND_UNFRIEND: {
+         char *friend_name = next_word(&arguments);
+         if (friend_name == NULL) {
+            return "missing friend";
+         }
+
+         // friendships go both ways, both users change
+         write_mask |= (shard_mask_t)1 << index_shard_of(friend_name);
+         index_lock_shards(0, write_mask);
+         user = index_find_user(username);
+         if (user == NULL) {
+            error = "unknown user";
+         } else if (command == COMMAND_FRIEND) {
+            error = add_friend(user, friend_name) ? NULL : "unknown user or already friends";
+         } else {
+            error = delete_friend(user, friend_name) ? NULL : "not friends";
+         }
+         index_unlock_shards(0, write_mask);
+         return error;
+      }
+
+      case COMMAND_DELPOST:
+      case COMMAND_DELPOSTID:
+         // only the user changes
+         index_lock_shards(0, write_mask);
+         user = index_find_user(username);
+         if (user == NULL) {
+            index_unlock_shards(0, write_mask);
+         }
+         break;
+
+      default:
+         return "unknown command";
+   }
+
+   // no shard is locked when the user was not found
+   if (user == NULL) {
+      return "unknown user";
+   }
+   error = run_user_command(command, user, arguments, output);
+   index_unlock_shards(read_mask, write_mask);
+   return error;
+}
+
+
+/*
+   Function that runs every command of the input and writes the results to the output.
+   The number of commands, the commands per second and the latency of every kind of
+   command are written to the report file at the end, unless it is NULL. The output is not
+   flushed before the end, so the caller chooses how it is buffered.
+   Returns the number of commands that failed.
+*/
+size_t run_batch(FILE *input, FILE *output, FILE *report, user_t **users)
+{
+   histogram_t histograms[NUM_COMMANDS];
+   memset(histograms, 0, sizeof(histograms));
+   size_t failures = 0;
+   size_t unknown = 0;
+
+   char *line = NULL;
+   size_t line_size = 0;
+   ssize_t length;
+   unsigned long long start = histogram_now_ns();
+
+   while ((length = getline(&line, &line_size, input)) > 0) {
+      line[strcspn(line, "\r\n")] = '\0';
+      char *cursor = line;
+      char *name = next_word(&cursor);
+      if (name == NULL || name[0] == '#') {
+         continue;
+      }
+
+      command_t command = 0;
+      while (command < NUM_COMMANDS && strcmp(name, command_names[command]) != 0) {
+         command++;
+      }
+      if (command == NUM_COMMANDS) {
+         fprintf(output, "ERR unknown command %s\n", name);
+         failures++;
+         unknown++;
+         continue;
+      }
+
+      unsigned long long command_start = histogram_now_ns();
+      const char *error = run_command(command, cursor, output, users);
+
+      // a change is only acknowledged once it is in the log
+      if (error == NULL && wal_commit() != 0) {
+         error = "the change could not be logged";
+      }
+      histogram_add(&histograms[command], histogram_now_ns() - command_start);
+
+      if (error != NULL) {
+         fprintf(output, "ERR %s\n", error);
+         failures++;
+      } else {
+         fprintf(output, "OK\n");
+      }
+   }
+   free(line);
+   fflush(output);
+
+   if (report == NULL) {
+      return failures;
+   }
+
+   double seconds = (histogram_now_ns() - start) / 1e9;
+   size_t total = unknown;
+   for (int i = 0; i < NUM_COMMANDS; i++) {
+      total += histograms[i].count;
+   }
+
+   fprintf(report, "%zu commands (%zu failed) in %.3f s: %.0f ops/s\n",
+           total, failures, seconds, seconds > 0 ? total / seconds : 0.0);
+   fprintf(report, "%-9s %10s %10s %10s %10s %10s\n", "command", "count", "mean ns", "p50 ns", "p99 ns", "max ns");
+   for (int i = 0; i < NUM_COMMANDS; i++) {
+      const histogram_t *histogram = &histograms[i];
+      if (histogram->count == 0) {
+         continue;
+      }
+      fprintf(report, "%-9s %10zu %10llu %10llu %10llu %10llu\n", command_names[i], histogram->count,
+              histogram->total_ns / histogram->count, histogram_percentile(histogram, 0.50),
+              histogram_percentile(histogram, 0.99), histogram->max_ns);
+   }
+   return failures;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file batch.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the batch mode, which runs a stream of commands
+ * without the menu, one command per line:
+ *
+ *   ADDUSER <username> <password>
+ *   PASSWD <username> <password>
+ *   AUTH <username> <password>
+ *   POST <username> <text>
+ *   DELPOST <username> <post number>
+ *   DELPOSTID <username> <post id>
+ *   FRIEND <username> <friend>
+ *   UNFRIEND <username> <friend>
+ *   FEED <username> [number of posts]
+ *   CHECKPOINT <file>
+ *   SEARCH <words, #hashtags and @mentions, OR between alternatives>
+ *   TRENDING [minute|hour] [number of hashtags]
+ *
+ * Post numbers count from the user's newest post, as in the menu, while post ids, which
+ * FEED and SEARCH print first on every line, never change.
+ * Every command prints "OK" or "ERR <reason>"; FEED and SEARCH first print one line per post,
+ * TRENDING one line per hashtag with its count, over the last hour unless minute is given.
+ * AUTH answers "ERR wrong password" when the password is not the user's.
+ * CHECKPOINT answers as soon as the checkpoint has started.
+ * Empty lines and lines starting with '#' are ignored.
+ */
+
+#ifndef __A2_BATCH_H__
+#define __A2_BATCH_H__
+#include <stdio.h>
+#include "nodes.h"
+
+/*
+   Function that runs every command of the input and writes the results to the output.
+   The number of commands, the commands per second and the latency of every kind of
+   command are written to the report file at the end, unless it is NULL. The output is not
+   flushed before the end, so the caller chooses how it is buffered.
+   Returns the number of commands that failed.
+*/
+size_t run_batch(FILE *input, FILE *output, FILE *report, user_t **users);
+
+
+#endif
@@ -0,0 +1,2605 @@
+/**
+ * @file benchmark.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file is the benchmark suite of the user operations. For every scale,
+ * it generates a file of that many users, loads it, times the operations on
+ * the loaded users and writes one line of JSON per operation, so the results
+ * of two versions can be compared by a script. The same scales and seed
+ * always generate the same users and run the same operations. The memory
+ * of the process is written after the load and after the teardown; its
+ * peak covers every scale run so far, so the scales go from the smallest.
+ * After the load, the bytes per user and per post of the pools and the text
+ * arena are written next to those of one malloc per node and per text.
+ *
+ * The passwords are hashed with 1 round unless --rounds is given, so the
+ * load times show the parsing and the data structures; the hashing has its
+ * own benchmark (benchmark password).
+ *
+ * Given the name of a benchmark instead, it runs that benchmark of one part
+ * of the program, such as the log or the search, and prints a table. It is
+ * a program of its own, built with:
+ *
+ *   gcc -Wall -O2 -o benchmark benchmark.c generator.c functions.c user_index.c snapshot.c pool.c
+ *       text_arena.c friend_set.c recommend.c feed.c batch.c server.c wal.c histogram.c checkpoint.c
+ *       search.c trending.c user_table.c password.c csv_load.c output.c metrics.c post_list.c -lpthread -lm
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <assert.h>
+#include <malloc.h>
+#include "nodes.h"
+#include "functions.h"
+#include "user_index.h"
+#include "histogram.h"
+#include "password.h"
+#include "generator.h"
+#include "output.h"
+#include "wal.h"
+#include "snapshot.h"
+#include "checkpoint.h"
+#include "search.h"
+#include "trending.h"
+#include "user_table.h"
+#include "post_list.h"
+#include "csv_load.h"
+#include "friend_set.h"
+#include "text_arena.h"
+#include "recommend.h"
+#include "feed.h"
+
+#define MAX_SCALES 16
+#define OPERATIONS 100000
+#define MISS_PERCENT 10
+#define RECOVERY_RECORDS 100
+#define BENCH_FRIENDS 8
+#define BENCH_POSTS 2
+#define BENCH_BASELINE_CHANGES 200000
+#define BENCH_WORD_BITS 16
+#define BENCH_HASHTAG_BITS 10
+#define BENCH_MENTIONS 100000
+#define BENCH_QUERIES 200
+#define BENCH_LIMIT 10
+#define BENCH_TAG_BITS 20
+#define BENCH_POSTS_PER_SECOND 1000
+#define BENCH_TOP 5
+#define BENCH_DELETES 1000
+#define BENCH_PASSES 5
+#define BENCH_PASSWORD_SIZE 24
+#define BENCH_MIGRATION_USERS 1000000
+#define BENCH_FRIEND_COLUMNS 3
+#define BENCH_LOAD_POSTS 3
+#define BENCH_SAMPLE_USERS 10000
+#define BENCH_FRIEND_QUERIES 200000
+#define BENCH_PAGES 10000
+#define BENCH_PAGE_SIZE 10
+#define BENCH_COMPLETE_QUERIES 100000
+#define BENCH_MATCHES 10
+#define BENCH_ADDED 1000
+#define BENCH_INDEX_USERS 10000
+#define BENCH_INDEX_FINDS 100000
+#define BENCH_LIST_FINDS 1000
+#define BENCH_MEMBER_FRIENDS 10
+#define BENCH_MEMBER_QUERIES 100000
+#define BENCH_SUGGESTIONS 10
+#define BENCH_POPULAR_USERS 100
+#define BENCH_FEED_PAGE 10
+#define BENCH_FEED_READS 80       // percent of the operations
+#define BENCH_FEED_POSTS 15
+#define BENCH_FRIEND_POSTS 20
+#define BENCH_FIRST_PAGE_READS 100
+
+// The settings of a run of the suite
+typedef struct suite
+{
+    size_t scales[MAX_SCALES];
+    int num_scales;
+    unsigned int rounds;
+    unsigned int seed;
+} suite_t;
+
+// A benchmark of one part of the program, run with its name and arguments
+typedef struct operation
+{
+    const char *name;
+    const char *arguments;
+    int num_arguments;
+    int (*run)(char **arguments);     // returns -1 if the arguments are not valid
+    const char *description;
+} operation_t;
+
+// The totals computed by a pass of the scan benchmark
+typedef struct scan_totals
+{
+    size_t name_bytes;
+    size_t friends;
+    size_t posts;
+} scan_totals_t;
+
+// A pass of the scan benchmark over the users, through the list or the table
+typedef void (*scan_t)(const user_t *users, const user_table_t *table, scan_totals_t *totals);
+
+// A friend as it was stored before the friend sets: a copy of the username in a linked list
+typedef struct name_node
+{
+    char username[30];
+    struct name_node *next;
+} name_node_t;
+
+// A friend operation of the friend benchmark
+typedef struct friend_query
+{
+    user_t *user;
+    user_t *other;
+    char other_name[30];
+    _Bool added;                // the operation made them friends
+} friend_query_t;
+
+// A post of a singly linked list of posts, as the posts were kept before the blocks
+typedef struct post_node
+{
+    const post_t *post;
+    struct post_node *next;
+} post_node_t;
+
+static credential_t bench_credential;    // hashed once, so the benchmarks time the changes and not PBKDF2
+
+
+/*
+   Function that writes the result of an operation as a line of JSON, with the
+   throughput if the operation wrote a number of bytes.
+*/
+static void report(const suite_t *suite, const char *operation, size_t users, size_t ops,
+                   unsigned long long ns, size_t bytes)
+{
+   printf("{\"benchmark\":\"%s\",\"users\":%zu,\"ops\":%zu,\"seconds\":%.6f,\"ns_per_op\":%.1f,",
+          operation, users, ops, ns / 1e9, ops > 0 ? (double)ns / ops : 0.0);
+   if (bytes > 0) {
+      printf("\"bytes\":%zu,\"mb_per_s\":%.1f,", bytes, ns > 0 ? bytes / (ns / 1e9) / 1e6 : 0.0);
+   }
+   printf("\"rounds\":%u,\"seed\":%u}\n", suite->rounds, suite->seed);
+   fflush(stdout);
+}
+
+
+/*
+   Function that sends the standard output to /dev/null, as the operations print their messages.
+   Return a copy of the standard output to give to restore_stdout, or -1 on error.
+*/
+static int sink_stdout()
+{
+   fflush(stdout);
+   int sink = open("/dev/null", O_WRONLY);
+   if (sink < 0) {
+      return -1;
+   }
+   int saved = dup(STDOUT_FILENO);
+   dup2(sink, STDOUT_FILENO);
+   close(sink);
+   return saved;
+}
+
+
+/*
+   Function that gives the standard output back after sink_stdout.
+*/
+static void restore_stdout(int saved)
+{
+   fflush(stdout);
+   if (saved >= 0) {
+      dup2(saved, STDOUT_FILENO);
+      close(saved);
+   }
+}
+
+
+/*
+   Function that makes the usernames looked up by the benchmark, some of which are not users.
+   Return an array of count names of 30 characters.
+*/
+static char (*make_names(size_t count, size_t users, unsigned int *seed))[30]
+{
+   char (*names)[30] = malloc(count * sizeof(*names));
+   if (names == NULL) {
+      return NULL;
+   }
+   for (size_t i = 0; i < count; i++) {
+      if (rand_r(seed) % 100 < MISS_PERCENT) {
+         snprintf(names[i], sizeof(names[i]), "nobody%zu", i);
+      } else {
+         snprintf(names[i], sizeof(names[i]), "user%zu", (size_t)rand_r(seed) % users);
+      }
+   }
+   return names;
+}
+
+
+/*
+   Function that times the lookup of random usernames.
+*/
+static void time_find_user(const suite_t *suite, user_t *users, size_t count, unsigned int *seed)
+{
+   char (*names)[30] = make_names(OPERATIONS, count, seed);
+   if (names == NULL) {
+      return;
+   }
+   // a miss prints a message
+   int saved = sink_stdout();
+   unsigned long long start = histogram_now_ns();
+   for (size_t i = 0; i < OPERATIONS; i++) {
+      find_user(users, names[i]);
+   }
+   fflush(stdout);
+   unsigned long long ns = histogram_now_ns() - start;
+   restore_stdout(saved);
+   report(suite, "find_user", count, OPERATIONS, ns, 0);
+   free(names);
+}
+
+
+/*
+   Function that times new friendships between random users.
+*/
+static void time_add_friend(const suite_t *suite, size_t count, unsigned int *seed)
+{
+   char (*names)[30] = make_names(OPERATIONS, count, seed);
+   user_t **friends_of = malloc(OPERATIONS * sizeof(user_t *));
+   if (names == NULL || friends_of == NULL) {
+      free(names);
+      free(friends_of);
+      return;
+   }
+   for (size_t i = 0; i < OPERATIONS; i++) {
+      friends_of[i] = index_user_by_id(rand_r(seed) % count);
+   }
+   unsigned long long start = histogram_now_ns();
+   for (size_t i = 0; i < OPERATIONS; i++) {
+      add_friend(friends_of[i], names[i]);
+   }
+   report(suite, "add_friend", count, OPERATIONS, histogram_now_ns() - start, 0);
+   free(names);
+   free(friends_of);
+}
+
+
+/*
+   Function that times the deletion of posts at random positions of random users.
+*/
+static void time_delete_post(const suite_t *suite, size_t count, unsigned int *seed)
+{
+   // the users with posts and how many they have left
+   unsigned int *authors = malloc(count * sizeof(unsigned int));
+   int *num_posts = calloc(count, sizeof(int));
+   if (authors == NULL || num_posts == NULL) {
+      free(authors);
+      free(num_posts);
+      return;
+   }
+   size_t num_authors = 0;
+   for (unsigned int id = 0; id < count; id++) {
+      num_posts[id] = index_user_by_id(id)->posts.count;
+      if (num_posts[id] > 0) {
+         authors[num_authors++] = id;
+      }
+   }
+
+   size_t deleted = 0;
+   unsigned long long total_ns = 0;
+   while (deleted < OPERATIONS && num_authors > 0) {
+      size_t pick = rand_r(seed) % num_authors;
+      unsigned int id = authors[pick];
+      int number = 1 + rand_r(seed) % num_posts[id];
+      user_t *user = index_user_by_id(id);
+
+      unsigned long long start = histogram_now_ns();
+      delete_post(user, number);
+      total_ns += histogram_now_ns() - start;
+
+      deleted++;
+      if (--num_posts[id] == 0) {
+         authors[pick] = authors[--num_authors];
+      }
+   }
+   report(suite, "delete_post", count, deleted, total_ns, 0);
+   free(authors);
+   free(num_posts);
+}
+
+
+/*
+   Function that times the display of all the posts, with the output sent to /dev/null,
+   which is not paged, and a yes to every question of the display in case it is.
+*/
+static void time_display_all_posts(const suite_t *suite, user_t *users, size_t count)
+{
+   FILE *answers = tmpfile();
+   if (answers == NULL) {
+      return;
+   }
+   for (size_t i = 0; i <= count / 2; i++) {
+      fputs("Y\n", answers);
+   }
+   fflush(answers);
+   rewind(answers);
+
+   int saved_stdout = sink_stdout();
+   int saved_stdin = dup(STDIN_FILENO);
+   dup2(fileno(answers), STDIN_FILENO);
+   clearerr(stdin);
+
+   size_t bytes = output_bytes_written();
+   unsigned long long start = histogram_now_ns();
+   display_all_posts(users);
+   fflush(stdout);
+   unsigned long long ns = histogram_now_ns() - start;
+
+   restore_stdout(saved_stdout);
+   dup2(saved_stdin, STDIN_FILENO);
+   clearerr(stdin);
+   close(saved_stdin);
+   fclose(answers);
+   report(suite, "display_all_posts", count, count, ns, output_bytes_written() - bytes);
+}
+
+
+/*
+   Function that reads a size of the process from /proc/self/status, such as VmRSS for the memory
+   it uses now or VmHWM for the most it has used. Return the size in bytes, or 0 if it can not be read.
+*/
+static size_t process_memory(const char *field)
+{
+   FILE *status = fopen("/proc/self/status", "r");
+   if (status == NULL) {
+      return 0;
+   }
+   char line[128];
+   size_t length = strlen(field);
+   size_t kilobytes = 0;
+   while (fgets(line, sizeof(line), status) != NULL) {
+      if (strncmp(line, field, length) == 0 && line[length] == ':') {
+         kilobytes = strtoul(line + length + 1, NULL, 10);
+         break;
+      }
+   }
+   fclose(status);
+   return kilobytes * 1024;
+}
+
+
+/*
+   Function that writes the memory of the process as a line of JSON: the resident memory, the most
+   it has used so far, whatever the scale, and the memory held by the slabs of the user and post pools.
+*/
+static void report_memory(const suite_t *suite, const char *operation, size_t users)
+{
+   pool_stats_t user_stats;
+   pool_stats_t post_stats;
+   get_pool_stats(&user_stats, &post_stats);
+   printf("{\"benchmark\":\"%s\",\"users\":%zu,\"rss_bytes\":%zu,\"peak_rss_bytes\":%zu,"
+          "\"user_pool_bytes\":%zu,\"post_pool_bytes\":%zu,\"rounds\":%u,\"seed\":%u}\n",
+          operation, users, process_memory("VmRSS"), process_memory("VmHWM"), user_stats.bytes,
+          post_stats.bytes, suite->rounds, suite->seed);
+   fflush(stdout);
+}
+
+/*
+   Function that allocates with malloc a node for every loaded user and post and a copy of every
+   post's text, as they were allocated before the pools and the text arena, and writes the bytes
+   per user and per post they take next to the bytes the pools and the arena take.
+*/
+static void report_node_memory(const suite_t *suite, size_t users)
+{
+   pool_stats_t user_stats;
+   pool_stats_t post_stats;
+   get_pool_stats(&user_stats, &post_stats);
+   size_t num_users = index_user_count();
+   size_t num_posts = post_stats.live;
+   void **nodes = malloc((num_users + 2 * num_posts + 1) * sizeof(void *));
+   assert(nodes != NULL);
+
+   // the heap counts the headers and the rounding of every allocation
+   size_t num_nodes = 0;
+   size_t start = mallinfo2().uordblks;
+   for (unsigned int id = 0; id < num_users; id++) {
+      nodes[num_nodes++] = malloc(sizeof(user_t));
+   }
+   size_t user_bytes = mallinfo2().uordblks - start;
+   start = mallinfo2().uordblks;
+   for (unsigned int id = 0; id < num_users; id++) {
+      post_cursor_t cursor;
+      for (post_t *post = post_list_seek(&index_user_by_id(id)->posts, 0, &cursor); post != NULL;
+           post = post_list_next(&cursor)) {
+         nodes[num_nodes++] = malloc(sizeof(post_t));
+         nodes[num_nodes++] = malloc(post->length + 1);
+      }
+   }
+   size_t post_bytes = mallinfo2().uordblks - start;
+   for (size_t i = 0; i < num_nodes; i++) {
+      free(nodes[i]);
+   }
+   free(nodes);
+
+   size_t pool_post_bytes = post_stats.bytes + text_arena_reserved();
+   printf("{\"benchmark\":\"memory_per_node\",\"users\":%zu,\"pool_bytes_per_user\":%.1f,"
+          "\"malloc_bytes_per_user\":%.1f,\"pool_bytes_per_post\":%.1f,\"malloc_bytes_per_post\":%.1f,"
+          "\"rounds\":%u,\"seed\":%u}\n",
+          users, num_users > 0 ? (double)user_stats.bytes / num_users : 0.0,
+          num_users > 0 ? (double)user_bytes / num_users : 0.0,
+          num_posts > 0 ? (double)pool_post_bytes / num_posts : 0.0,
+          num_posts > 0 ? (double)post_bytes / num_posts : 0.0, suite->rounds, suite->seed);
+   fflush(stdout);
+}
+
+/*
+   Function that runs every operation on a generated file of count users.
+   Return 0 on success and 1 on error.
+*/
+static int run_scale(const suite_t *suite, size_t count)
+{
+   FILE *file = tmpfile();
+   if (file == NULL) {
+      perror("Error creating the CSV file");
+      return 1;
+   }
+   generator_options_t options;
+   generator_default_options(&options);
+   options.users = count;
+   options.seed = suite->seed;
+   generate_users_csv(file, &options, NULL);
+   rewind(file);
+
+   unsigned long long start = histogram_now_ns();
+   user_t *users = read_CSV_and_create_users(file, NULL);
+   report(suite, "read_CSV_and_create_users", count, count, histogram_now_ns() - start, 0);
+   report_memory(suite, "memory_after_load", count);
+   report_node_memory(suite, count);
+   fclose(file);
+   if (index_user_count() != count) {
+      fprintf(stderr, "Loaded %zu users instead of %zu\n", index_user_count(), count);
+      teardown(users);
+      return 1;
+   }
+
+   unsigned int seed = suite->seed;
+   time_find_user(suite, users, count, &seed);
+   time_add_friend(suite, count, &seed);
+   time_display_all_posts(suite, users, count);
+   time_delete_post(suite, count, &seed);
+
+   start = histogram_now_ns();
+   teardown(users);
+   report(suite, "teardown", count, count, histogram_now_ns() - start, 0);
+   report_memory(suite, "memory_after_teardown", count);
+   return 0;
+}
+
+
+/*
+   Function that reads a comma separated list of scales. Return the number of scales, 0 on error.
+*/
+static int parse_scales(const char *text, size_t *scales)
+{
+   int count = 0;
+   while (*text != '\0' && count < MAX_SCALES) {
+      char *end;
+      long scale = strtol(text, &end, 10);
+      if (end == text || scale <= 0 || (*end != ',' && *end != '\0')) {
+         return 0;
+      }
+      scales[count++] = scale;
+      text = *end == ',' ? end + 1 : end;
+   }
+   return *text == '\0' ? count : 0;
+}
+
+
+// A thread of the log benchmark
+typedef struct bench_thread
+{
+    size_t records;
+    unsigned int number;
+} bench_thread_t;
+
+
+/*
+   Function that appends and commits post records, one at a time, like a client of the server.
+*/
+static void *run_bench_thread(void *argument)
+{
+   bench_thread_t *thread = argument;
+   char name[30];
+   snprintf(name, sizeof(name), "walbench%u", thread->number);
+   for (size_t i = 0; i < thread->records; i++) {
+      wal_log(WAL_POST, name, "A post written by the log benchmark, about as long as a real one.", i, 0);
+      wal_commit();
+   }
+   return NULL;
+}
+
+
+/*
+   Function that writes records to a log, cuts the log in the middle of the last one and
+   checks that the others are replayed, then that records appended after the cut are too.
+   Return 0 on success and 1 on error.
+*/
+static int check_recovery(const char *path)
+{
+   char username[30];
+   unlink(path);
+   if (wal_open(path, WAL_SYNC_GROUP, 0) != 0) {
+      return 1;
+   }
+   credential_t credential;
+   char text[CREDENTIAL_TEXT_SIZE];
+   password_hash("password", &credential);
+   credential_encode(&credential, text);
+   for (int i = 0; i < RECOVERY_RECORDS; i++) {
+      snprintf(username, sizeof(username), "walbench%d", i);
+      wal_log(WAL_ADD_USER, username, text, 0, 0);
+   }
+   wal_close();
+
+   // a crash in the middle of the last record
+   struct stat file_stat;
+   if (stat(path, &file_stat) != 0 || truncate(path, file_stat.st_size - 5) != 0) {
+      return 1;
+   }
+
+   user_t *users = NULL;
+   wal_replay_stats_t stats;
+   int result = wal_replay(path, &users, 0, &stats);
+   size_t recovered = index_user_count();
+   teardown(users);
+   _Bool cut_ok = result == 0 && stats.records == RECOVERY_RECORDS - 1 && stats.truncated > 0
+                  && recovered == RECOVERY_RECORDS - 1;
+
+   // the log can be appended to after the cut
+   if (wal_open(path, WAL_SYNC_GROUP, 0) != 0) {
+      return 1;
+   }
+   wal_log(WAL_ADD_USER, "walbench_last", text, 0, 0);
+   wal_close();
+
+   users = NULL;
+   result = wal_replay(path, &users, 0, &stats);
+   _Bool append_ok = result == 0 && stats.records == RECOVERY_RECORDS && stats.truncated == 0
+                     && index_find_user("walbench_last") != NULL;
+   teardown(users);
+   unlink(path);
+
+   printf("recovery after a cut record: %s\n", cut_ok && append_ok ? "ok" : "FAILED");
+   return cut_ok && append_ok ? 0 : 1;
+}
+
+
+/*
+   Function that measures the records per second with a sync per record and with group
+   commit, from 1 to max_threads threads, then checks that a log cut in the middle of a
+   record is recovered. Return 0 on success and 1 on error.
+*/
+static int wal_benchmark(const char *path, size_t records, int max_threads)
+{
+   const wal_sync_t modes[] = { WAL_SYNC_EACH, WAL_SYNC_GROUP };
+   const char *mode_names[] = { "each", "group" };
+   pthread_t *threads = malloc(max_threads * sizeof(pthread_t));
+   bench_thread_t *bench_threads = malloc(max_threads * sizeof(bench_thread_t));
+   if (threads == NULL || bench_threads == NULL) {
+      free(threads);
+      free(bench_threads);
+      return 1;
+   }
+
+   printf("%-6s %8s %10s %10s %12s\n", "sync", "threads", "records", "syncs", "records/s");
+   for (int mode = 0; mode < 2; mode++) {
+      for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+         unlink(path);
+         if (wal_open(path, modes[mode], 0) != 0) {
+            perror("Error opening the log");
+            free(threads);
+            free(bench_threads);
+            return 1;
+         }
+
+         unsigned long long start = histogram_now_ns();
+         for (int i = 0; i < num_threads; i++) {
+            bench_threads[i].records = records / num_threads;
+            bench_threads[i].number = i;
+            pthread_create(&threads[i], NULL, run_bench_thread, &bench_threads[i]);
+         }
+         for (int i = 0; i < num_threads; i++) {
+            pthread_join(threads[i], NULL);
+         }
+         double seconds = (histogram_now_ns() - start) / 1e9;
+
+         wal_stats_t stats;
+         wal_get_stats(&stats);
+         wal_close();
+         printf("%-6s %8d %10llu %10llu %12.0f\n", mode_names[mode], num_threads,
+                (unsigned long long)stats.records, (unsigned long long)stats.syncs,
+                seconds > 0 ? stats.records / seconds : 0.0);
+         fflush(stdout);
+      }
+   }
+   free(threads);
+   free(bench_threads);
+
+   return check_recovery(path);
+}
+
+
+/*
+   Function that runs the log benchmark: benchmark wal <file> <records> <max threads>.
+   Return -1 if the arguments are not valid.
+*/
+static int run_wal(char **arguments)
+{
+   if (atoi(arguments[1]) <= 0 || atoi(arguments[2]) <= 0) {
+      return -1;
+   }
+   return wal_benchmark(arguments[0], atoi(arguments[1]), atoi(arguments[2]));
+}
+
+/*
+   Function that writes the name of a user of the checkpoint benchmark.
+*/
+static void bench_username(char *username, size_t size, size_t number)
+{
+   snprintf(username, size, "cp%zu", number);
+}
+
+
+/*
+   Function that makes a random change to one of the first num_users users and records its latency.
+*/
+static void make_change(size_t count, unsigned int *seed, histogram_t *histogram)
+{
+   user_t *user = index_user_by_id(rand_r(seed) % count);
+   char friend_name[30];
+   bench_username(friend_name, sizeof(friend_name), rand_r(seed) % count);
+   int kind = rand_r(seed) % 100;
+
+   unsigned long long start = histogram_now_ns();
+   if (kind < 40) {
+      add_post(user, "A post made while the checkpoint benchmark runs.");
+   } else if (kind < 60) {
+      add_friend(user, friend_name);
+   } else if (kind < 75) {
+      delete_friend(user, friend_name);
+   } else if (kind < 90) {
+      delete_post(user, 1);
+   } else {
+      set_credential(user, &bench_credential);
+   }
+   histogram_add(histogram, histogram_now_ns() - start);
+}
+
+
+/*
+   Function that prints a line of a latency table.
+*/
+static void print_latency(const char *name, const histogram_t *histogram)
+{
+   printf("%-18s %10zu %10llu %10llu %10llu %10llu %10llu\n", name, histogram->count,
+          histogram->count > 0 ? histogram->total_ns / histogram->count : 0,
+          histogram_percentile(histogram, 0.50), histogram_percentile(histogram, 0.99),
+          histogram_percentile(histogram, 0.999), histogram->max_ns);
+}
+
+
+/*
+   Function that creates num_users users with friends and posts, then measures the latency
+   of changes made to them with and without a checkpoint running, and prints both.
+   Return 0 on success and 1 on error.
+*/
+static int checkpoint_benchmark(const char *path, size_t count)
+{
+   user_t *users = NULL;
+   char username[30];
+   char friend_name[30];
+   unsigned int seed = 42;
+
+   password_hash("password", &bench_credential);
+   unsigned long long start = histogram_now_ns();
+   for (size_t i = 0; i < count; i++) {
+      bench_username(username, sizeof(username), i);
+      insert_user_credential(&users, username, &bench_credential);
+   }
+   for (size_t i = 0; i < count; i++) {
+      for (int j = 0; j < BENCH_FRIENDS / 2; j++) {
+         bench_username(friend_name, sizeof(friend_name), rand_r(&seed) % count);
+         add_friend(index_user_by_id(i), friend_name);
+      }
+      for (int j = 0; j < BENCH_POSTS; j++) {
+         add_post(index_user_by_id(i), "A post of a user created by the checkpoint benchmark.");
+      }
+   }
+   printf("created %zu users in %.1f s\n", count, (histogram_now_ns() - start) / 1e9);
+
+   histogram_t baseline;
+   histogram_t during;
+   memset(&baseline, 0, sizeof(baseline));
+   memset(&during, 0, sizeof(during));
+   for (size_t i = 0; i < BENCH_BASELINE_CHANGES; i++) {
+      make_change(count, &seed, &baseline);
+   }
+
+   start = histogram_now_ns();
+   if (checkpoint_start(path) != 0) {
+      perror("Error starting the checkpoint");
+      teardown(users);
+      return 1;
+   }
+   unsigned long long start_latency = histogram_now_ns() - start;
+   while (checkpoint_running()) {
+      make_change(count, &seed, &during);
+   }
+   checkpoint_stats_t result;
+   checkpoint_wait(&result);
+
+   printf("checkpoint of %zu users: %s in %.1f ms, started in %.1f us\n", result.users,
+          result.result == 0 ? "written" : "FAILED", result.seconds * 1e3, start_latency / 1e3);
+   printf("users copied by the foreground: %zu, mean %.1f us, max %.1f us\n", result.preserved,
+          result.preserved > 0 ? result.preserve_total_ns / 1e3 / result.preserved : 0.0,
+          result.preserve_max_ns / 1e3);
+   printf("%-18s %10s %10s %10s %10s %10s %10s\n", "changes", "count", "mean ns", "p50 ns", "p99 ns", "p99.9 ns", "max ns");
+   print_latency("no checkpoint", &baseline);
+   print_latency("during checkpoint", &during);
+
+   snapshot_t *snapshot = snapshot_open(path);
+   _Bool valid = snapshot != NULL && snapshot->header->user_count == count;
+   if (snapshot != NULL) {
+      snapshot_close(snapshot);
+   }
+   printf("checkpoint file: %s\n", valid ? "ok" : "INVALID");
+
+   teardown(users);
+   return result.result == 0 && valid ? 0 : 1;
+}
+
+/*
+   Function that runs the checkpoint benchmark: benchmark checkpoint <file> <users>.
+   Return -1 if the arguments are not valid.
+*/
+static int run_checkpoint(char **arguments)
+{
+   if (atol(arguments[1]) <= 0) {
+      return -1;
+   }
+   return checkpoint_benchmark(arguments[0], atol(arguments[1]));
+}
+
+/*
+   Function that returns a random rank below 2^bits, the probability of a rank being inversely
+   proportional to the rank as with the words of a text: the ranks from 2^b - 1 to 2^(b+1) - 2
+   are all as likely together for every b.
+*/
+static unsigned int skewed_rank(int bits, unsigned int *seed)
+{
+   unsigned int first = (1u << (rand_r(seed) % bits)) - 1;
+   return first + rand_r(seed) % (first + 1);
+}
+
+
+/*
+   Function that writes the word of a rank of the search benchmark's vocabulary.
+*/
+static void bench_word(char *word, size_t size, unsigned int rank)
+{
+   size_t length = 0;
+   word[length++] = 'w';
+   do {
+      word[length++] = 'a' + rank % 26;
+      rank /= 26;
+   } while (rank > 0 && length + 1 < size);
+   word[length] = '\0';
+}
+
+
+/*
+   Function that counts the posts visited by a search.
+*/
+static void count_visit(const post_t *post, void *context)
+{
+   (void)post;
+   (*(size_t *)context)++;
+}
+
+
+/*
+   Function that runs a query BENCH_QUERIES times and prints its latency.
+*/
+static void bench_query(const char *query)
+{
+   histogram_t histogram;
+   memset(&histogram, 0, sizeof(histogram));
+   size_t found = 0;
+   for (int i = 0; i < BENCH_QUERIES; i++) {
+      size_t visited = 0;
+      unsigned long long start = histogram_now_ns();
+      found = search_posts(query, BENCH_LIMIT, count_visit, &visited);
+      histogram_add(&histogram, histogram_now_ns() - start);
+   }
+   printf("%-24s %10zu %10.1f %10.1f %10.1f %10.1f\n", query, found,
+          histogram.total_ns / 1e3 / histogram.count, histogram_percentile(&histogram, 0.50) / 1e3,
+          histogram_percentile(&histogram, 0.99) / 1e3, histogram.max_ns / 1e3);
+}
+
+
+/*
+   Function that indexes num_posts generated posts and measures the indexing
+   throughput and the latency of a few kinds of queries.
+   Return 0 on success and 1 on error.
+*/
+static int search_benchmark(size_t num_posts)
+{
+   char text[512];
+   char word[16];
+   unsigned int seed = 42;
+
+   // the posts are created first, so that only the indexing is measured
+   post_t **posts = malloc(num_posts * sizeof(post_t *));
+   if (posts == NULL) {
+      fprintf(stderr, "Error allocating the posts\n");
+      return 1;
+   }
+   size_t text_bytes = 0;
+   for (size_t i = 0; i < num_posts; i++) {
+      size_t length = 0;
+      int words = 8 + rand_r(&seed) % 9;
+      for (int j = 0; j < words; j++) {
+         bench_word(word, sizeof(word), skewed_rank(BENCH_WORD_BITS, &seed));
+         length += snprintf(text + length, sizeof(text) - length, "%s%s", j > 0 ? " " : "", word);
+      }
+      for (int j = rand_r(&seed) % 3; j > 0; j--) {
+         length += snprintf(text + length, sizeof(text) - length, " #Tag%u", skewed_rank(BENCH_HASHTAG_BITS, &seed));
+      }
+      if (rand_r(&seed) % 4 == 0) {
+         length += snprintf(text + length, sizeof(text) - length, " @user%u", rand_r(&seed) % BENCH_MENTIONS);
+      }
+      posts[i] = create_post(text);
+      text_bytes += length;
+   }
+
+   unsigned long long start = histogram_now_ns();
+   for (size_t i = 0; i < num_posts; i++) {
+      search_index_post(posts[i]);
+   }
+   double seconds = (histogram_now_ns() - start) / 1e9;
+
+   search_stats_t index;
+   search_get_stats(&index);
+   printf("indexed %zu posts (%.1f MB) in %.2f s: %.0f posts/s, %.1f MB/s\n", num_posts,
+          text_bytes / 1e6, seconds, num_posts / seconds, text_bytes / 1e6 / seconds);
+   printf("%zu terms, %zu postings in %.1f MB, %.2f bytes per posting\n", index.terms,
+          index.postings, index.bytes / 1e6, index.postings > 0 ? (double)index.bytes / index.postings : 0.0);
+
+   char common[16];
+   char rare[16];
+   char other[32];
+   char query[64];
+   bench_word(common, sizeof(common), 0);
+   bench_word(rare, sizeof(rare), 1u << (BENCH_WORD_BITS - 4));
+   printf("%-24s %10s %10s %10s %10s %10s\n", "query", "posts", "mean us", "p50 us", "p99 us", "max us");
+   bench_query(common);
+   bench_query(rare);
+   bench_query("#tag0");
+   bench_query("@user42");
+   snprintf(query, sizeof(query), "#tag1 %s", common);
+   bench_query(query);
+   bench_word(other, sizeof(other), 1);
+   snprintf(query, sizeof(query), "%s AND %s", common, other);
+   bench_query(query);
+   snprintf(query, sizeof(query), "%s OR #tag2", rare);
+   bench_query(query);
+
+   free(posts);
+   teardown(NULL);
+   return 0;
+}
+
+/*
+   Function that runs the search benchmark: benchmark search <posts>.
+   Return -1 if the arguments are not valid.
+*/
+static int run_search(char **arguments)
+{
+   if (atol(arguments[0]) <= 0) {
+      return -1;
+   }
+   return search_benchmark(atol(arguments[0]));
+}
+
+/*
+   Function that prints the top hashtags of a window at a time.
+*/
+static void print_top(const char *name, trending_window_t window, time_t now)
+{
+   trending_tag_t top[BENCH_TOP];
+   size_t count = trending_top(window, now, top, BENCH_TOP);
+   printf("%-12s", name);
+   for (size_t i = 0; i < count; i++) {
+      printf(" %s:%lu", top[i].tag, top[i].count);
+   }
+   printf("\n");
+}
+
+
+/*
+   Function that counts the hashtags of num_posts generated posts, made over a few hours,
+   and prints the posts per second, the memory used and the top hashtags of each window.
+   Return 0 on success and 1 on error.
+*/
+static int trending_benchmark(size_t num_posts)
+{
+   char text[256];
+   unsigned int seed = 42;
+   post_t post;
+   memset(&post, 0, sizeof(post));
+   post.content = text;
+   size_t tags = 0;
+   time_t start_time = 1700000000;
+
+   trending_clear();
+   unsigned long long start = histogram_now_ns();
+   for (size_t i = 0; i < num_posts; i++) {
+      // a trend that only lasts for the last 10 minutes shows in both windows
+      size_t length = snprintf(text, sizeof(text), "Posted from the trending benchmark");
+      int num_tags = 1 + rand_r(&seed) % 3;
+      for (int j = 0; j < num_tags; j++) {
+         length += snprintf(text + length, sizeof(text) - length, " #Tag%u", skewed_rank(BENCH_TAG_BITS, &seed));
+      }
+      if (i + BENCH_POSTS_PER_SECOND * 600 >= num_posts && i % 4 == 0) {
+         length += snprintf(text + length, sizeof(text) - length, " #BreakingNews");
+         num_tags++;
+      }
+      tags += num_tags;
+      post.created = start_time + i / BENCH_POSTS_PER_SECOND;
+      trending_add_post(&post);
+   }
+   double seconds = (histogram_now_ns() - start) / 1e9;
+   time_t end_time = start_time + num_posts / BENCH_POSTS_PER_SECOND;
+
+   printf("counted %zu posts (%zu hashtags, up to %u different) in %.2f s: %.0f posts/s, %.0f hashtags/s\n",
+          num_posts, tags, 1u << BENCH_TAG_BITS, seconds, num_posts / seconds, tags / seconds);
+   printf("memory: %.1f MB for %d windows, whatever the number of different hashtags\n",
+          trending_memory() / 1e6, NUM_TRENDING_WINDOWS);
+   double confidence;
+   double error = trending_error_bound(&confidence);
+   printf("posts span %.1f hours at %d posts/s; a count is too high by less than %.3f%% of the hashtags"
+          " of its window with a probability of %.1f%%\n", (end_time - start_time) / 3600.0,
+          BENCH_POSTS_PER_SECOND, 100 * error, 100 * confidence);
+   print_top("last minute", TRENDING_MINUTE, end_time);
+   print_top("last hour", TRENDING_HOUR, end_time);
+   trending_clear();
+   return 0;
+}
+
+/*
+   Function that runs the trending benchmark: benchmark trending <posts>.
+   Return -1 if the arguments are not valid.
+*/
+static int run_trending(char **arguments)
+{
+   if (atol(arguments[0]) <= 0) {
+      return -1;
+   }
+   return trending_benchmark(atol(arguments[0]));
+}
+
+/*
+   Function that prints a line of the latency table of the deletion benchmark.
+*/
+static void print_delete_latency(const char *name, const histogram_t *histogram)
+{
+   printf("%-12s %10zu %12.1f %12.1f %12.1f %12.1f\n", name, histogram->count,
+          histogram->count > 0 ? histogram->total_ns / 1e3 / histogram->count : 0.0,
+          histogram_percentile(histogram, 0.50) / 1e3, histogram_percentile(histogram, 0.99) / 1e3,
+          histogram->max_ns / 1e3);
+}
+
+
+/*
+   Function that gives a user num_posts posts, then measures the latency of deleting posts from
+   the middle of the list by position and random posts by id, and prints both.
+   Return 0 on success and 1 on error.
+*/
+static int delete_benchmark(size_t num_posts)
+{
+   user_t *users = NULL;
+   user_t *user = insert_user(&users, "bench", "password");
+   unsigned long *ids = malloc(num_posts * sizeof(unsigned long));
+   if (user == NULL || ids == NULL) {
+      fprintf(stderr, "Error creating the posts\n");
+      free(ids);
+      return 1;
+   }
+   for (size_t i = 0; i < num_posts; i++) {
+      ids[i] = add_post(user, "A post of the deletion benchmark #bench")->id;
+   }
+
+   // random order of the ids, shuffled with Fisher-Yates
+   unsigned int seed = 42;
+   for (size_t i = num_posts - 1; i > 0; i--) {
+      size_t j = rand_r(&seed) % (i + 1);
+      unsigned long id = ids[i];
+      ids[i] = ids[j];
+      ids[j] = id;
+   }
+
+   histogram_t by_position;
+   histogram_t by_id;
+   memset(&by_position, 0, sizeof(by_position));
+   memset(&by_id, 0, sizeof(by_id));
+   size_t remaining = num_posts;
+   _Bool failed = 0;
+   for (size_t i = 0; i < BENCH_DELETES && remaining > 0; i++) {
+      unsigned long long start = histogram_now_ns();
+      failed |= !delete_post(user, remaining / 2 + 1);
+      histogram_add(&by_position, histogram_now_ns() - start);
+      remaining--;
+   }
+   for (size_t i = 0; i < num_posts && by_id.count < BENCH_DELETES; i++) {
+      // skip the posts already deleted by position
+      if (find_post(ids[i]) == NULL) {
+         continue;
+      }
+      unsigned long long start = histogram_now_ns();
+      failed |= !delete_post_by_id(user, ids[i]);
+      histogram_add(&by_id, histogram_now_ns() - start);
+   }
+
+   printf("deleting from a user with %zu posts\n", num_posts);
+   printf("%-12s %10s %12s %12s %12s %12s\n", "deletes", "count", "mean us", "p50 us", "p99 us", "max us");
+   print_delete_latency("by position", &by_position);
+   print_delete_latency("by id", &by_id);
+
+   free(ids);
+   teardown(users);
+   return failed ? 1 : 0;
+}
+
+/*
+   Function that runs the deletion benchmark: benchmark delete <posts>.
+   Return -1 if the arguments are not valid.
+*/
+static int run_delete(char **arguments)
+{
+   if (atol(arguments[0]) <= 0) {
+      return -1;
+   }
+   return delete_benchmark(atol(arguments[0]));
+}
+
+/*
+   Function that totals the username lengths, friends and posts of the users through the linked list.
+*/
+static void scan_list(const user_t *users, const user_table_t *table, scan_totals_t *totals)
+{
+   (void)table;
+   memset(totals, 0, sizeof(*totals));
+   for (const user_t *user = users; user != NULL; user = user->next) {
+      totals->name_bytes += strlen(user->username);
+      totals->friends += user->friends.count;
+      post_cursor_t cursor;
+      for (const post_t *current = post_list_seek(&user->posts, 0, &cursor); current != NULL; current = post_list_next(&cursor)) {
+         totals->posts++;
+      }
+   }
+}
+
+
+/*
+   Function that totals the same values through the columns of the table.
+*/
+static void scan_columns(const user_t *users, const user_table_t *table, scan_totals_t *totals)
+{
+   (void)users;
+   // the lengths and counts are the differences between consecutive offsets
+   totals->name_bytes = table->name_offsets[table->count] - table->count;
+   totals->friends = 0;
+   totals->posts = 0;
+   for (size_t i = 0; i < table->count; i++) {
+      totals->friends += table->friend_offsets[i + 1] - table->friend_offsets[i];
+   }
+   for (size_t i = 0; i < table->count; i++) {
+      totals->posts += table->post_offsets[i + 1] - table->post_offsets[i];
+   }
+}
+
+
+/*
+   Function that totals the same values through the rows of the table.
+*/
+static void scan_rows(const user_t *users, const user_table_t *table, scan_totals_t *totals)
+{
+   (void)users;
+   memset(totals, 0, sizeof(*totals));
+   size_t cursor = 0;
+   user_row_t row;
+   while (user_table_next(table, &cursor, &row)) {
+      totals->name_bytes += strlen(row.username);
+      totals->friends += row.friend_count;
+      totals->posts += row.post_count;
+   }
+}
+
+
+/*
+   Function that runs a kind of pass of the scan benchmark BENCH_PASSES times and prints the time of the fastest one.
+   Return true if its totals are the expected ones.
+*/
+static _Bool time_scan(const char *name, scan_t scan, const user_t *users, const user_table_t *table,
+                       size_t count, const scan_totals_t *expected)
+{
+   scan_totals_t totals;
+   unsigned long long best_ns = ~0ull;
+   for (int pass = 0; pass < BENCH_PASSES; pass++) {
+      unsigned long long start = histogram_now_ns();
+      scan(users, table, &totals);
+      unsigned long long ns = histogram_now_ns() - start;
+      if (ns < best_ns) {
+         best_ns = ns;
+      }
+   }
+   _Bool same = memcmp(&totals, expected, sizeof(scan_totals_t)) == 0;
+   printf("%-14s %10.2f %12.1f %s\n", name, best_ns / 1e6, count / (best_ns / 1e9) / 1e6, same ? "" : "WRONG TOTALS");
+   return same;
+}
+
+
+/*
+   Function that creates num_users users with friends and posts, then compares the time
+   of a pass over all of them through the linked list and through the table.
+   Return 0 on success and 1 on error.
+*/
+static int user_table_benchmark(size_t count)
+{
+   user_t *users = NULL;
+   char username[30];
+   unsigned int seed = 42;
+   credential_t credential;
+   password_hash("password", &credential);
+
+   unsigned long long start = histogram_now_ns();
+   for (size_t i = 0; i < count; i++) {
+      snprintf(username, sizeof(username), "scan%zu", i);
+      insert_user_credential(&users, username, &credential);
+   }
+   for (size_t i = 0; i < count; i++) {
+      for (int j = 0; j < BENCH_FRIENDS / 2; j++) {
+         snprintf(username, sizeof(username), "scan%u", rand_r(&seed) % (unsigned int)count);
+         add_friend(index_user_by_id(i), username);
+      }
+   }
+   // the posts are added in a random order of the users, as they would be over time
+   for (size_t i = 0; i < count * BENCH_POSTS; i++) {
+      add_post(index_user_by_id(rand_r(&seed) % count), "A post of the scan benchmark.");
+   }
+   printf("created %zu users in %.1f s\n", count, (histogram_now_ns() - start) / 1e9);
+
+   start = histogram_now_ns();
+   user_table_t *table = user_table_build();
+   printf("table built in %.1f ms\n", (histogram_now_ns() - start) / 1e6);
+
+   scan_totals_t expected;
+   scan_list(users, table, &expected);
+   printf("%-14s %10s %12s\n", "full scan", "best ms", "M users/s");
+   _Bool valid = time_scan("linked list", scan_list, users, table, count, &expected);
+   valid &= time_scan("table rows", scan_rows, users, table, count, &expected);
+   valid &= time_scan("table columns", scan_columns, users, table, count, &expected);
+
+   user_table_free(table);
+   teardown(users);
+   return valid ? 0 : 1;
+}
+
+/*
+   Function that runs the scan benchmark: benchmark scan <users>.
+   Return -1 if the arguments are not valid.
+*/
+static int run_scan(char **arguments)
+{
+   if (atol(arguments[0]) <= 0) {
+      return -1;
+   }
+   return user_table_benchmark(atol(arguments[0]));
+}
+
+/*
+   Function that hashes the passwords of num_users generated users, as a CSV file of users is
+   migrated to credentials, with 1, 2, 4, ... up to max_threads threads, then verifies them all.
+   Prints the hashes per second, per core and the time of the whole migration.
+   Return 0 on success and 1 on error.
+*/
+static int password_benchmark(size_t count, int max_threads)
+{
+   credential_t *credentials = malloc(count * sizeof(credential_t));
+   password_job_t *jobs = malloc(count * sizeof(password_job_t));
+   char *passwords = malloc(count * BENCH_PASSWORD_SIZE);
+   if (credentials == NULL || jobs == NULL || passwords == NULL) {
+      fprintf(stderr, "Error allocating the passwords\n");
+      free(credentials);
+      free(jobs);
+      free(passwords);
+      return 1;
+   }
+   for (size_t i = 0; i < count; i++) {
+      snprintf(&passwords[i * BENCH_PASSWORD_SIZE], BENCH_PASSWORD_SIZE, "pw%zu", i);
+      jobs[i].credential = &credentials[i];
+      jobs[i].password = &passwords[i * BENCH_PASSWORD_SIZE];
+   }
+
+   printf("PBKDF2-HMAC-SHA256, %d rounds, %d processors\n", PASSWORD_ITERATIONS, password_threads());
+   printf("%8s %12s %12s %16s %12s\n", "threads", "hashes", "hashes/s", "hashes/s/core", "seconds");
+   double rate = 0;
+   for (int threads = 1; threads <= max_threads; threads *= 2) {
+      unsigned long long start = histogram_now_ns();
+      password_hash_all(jobs, count, threads);
+      double seconds = (histogram_now_ns() - start) / 1e9;
+      int cores = threads < password_threads() ? threads : password_threads();
+      rate = count / seconds;
+      printf("%8d %12zu %12.0f %16.0f %12.2f\n", threads, count, rate, rate / cores, seconds);
+   }
+   printf("a migration of %d users takes %.0f s at the last rate\n", BENCH_MIGRATION_USERS, BENCH_MIGRATION_USERS / rate);
+
+   // a wrong password for every tenth user
+   for (size_t i = 0; i < count; i += 10) {
+      passwords[i * BENCH_PASSWORD_SIZE] = 'x';
+   }
+   unsigned long long start = histogram_now_ns();
+   size_t verified = password_verify_all(jobs, count, max_threads);
+   double seconds = (histogram_now_ns() - start) / 1e9;
+   size_t expected = count - (count + 9) / 10;
+   printf("verified %zu of %zu passwords with %d threads in %.2f s: %.0f verifications/s, %s\n", verified, count,
+          max_threads, seconds, count / seconds, verified == expected ? "ok" : "WRONG");
+
+   free(credentials);
+   free(jobs);
+   free(passwords);
+   return verified == expected ? 0 : 1;
+}
+
+/*
+   Function that runs the password benchmark: benchmark password <users> <max threads>.
+   Return -1 if the arguments are not valid.
+*/
+static int run_password(char **arguments)
+{
+   if (atol(arguments[0]) <= 0 || atoi(arguments[1]) <= 0) {
+      return -1;
+   }
+   return password_benchmark(atol(arguments[0]), atoi(arguments[1]));
+}
+
+/*
+   Function that writes a generated CSV file of rows users, each with friends and posts, for the load benchmark.
+*/
+static void generate_csv(FILE *file, size_t rows)
+{
+   unsigned int seed = 42;
+   fprintf(file, "Username,Password,Friends,,,Posts,,\n");
+   for (size_t i = 0; i < rows; i++) {
+      fprintf(file, "user%zu,password%zu", i, i);
+      for (int j = 0; j < BENCH_FRIEND_COLUMNS; j++) {
+         // some friends are blank, as in the real file
+         if (rand_r(&seed) % 4 == 0) {
+            fprintf(file, ", ");
+         } else {
+            fprintf(file, ",user%u", rand_r(&seed) % (unsigned int)rows);
+         }
+      }
+      for (int j = 0; j < BENCH_LOAD_POSTS; j++) {
+         fprintf(file, ",Post %d of user%zu: loading the users of a generated file with many threads #load%u @user%u",
+                 j, i, rand_r(&seed) % 100, rand_r(&seed) % (unsigned int)rows);
+      }
+      fprintf(file, "\n");
+   }
+}
+
+
+/*
+   Function that writes the loaded users to a snapshot, then starts from the snapshot as the
+   program does, and prints the time to open it and to load its users next to the CSV loads.
+   The users are freed, both those given and those of the snapshot. Return 0 on success and 1 on error.
+*/
+static int time_snapshot_load(user_t *users, size_t expected_users, size_t expected_posts)
+{
+   char path[] = "/tmp/benchmark_snapshotXXXXXX";
+   int fd = mkstemp(path);
+   if (fd < 0) {
+      perror("Error creating the snapshot file");
+      return 1;
+   }
+   close(fd);
+   unsigned long long start = histogram_now_ns();
+   if (snapshot_write(path, users) != 0) {
+      perror("Error writing the snapshot");
+      unlink(path);
+      teardown(users);
+      return 1;
+   }
+   unsigned long long write_ns = histogram_now_ns() - start;
+   struct stat snapshot_stat;
+   size_t bytes = stat(path, &snapshot_stat) == 0 ? snapshot_stat.st_size : 0;
+
+   // the users are saved in the snapshot, they are freed to be loaded again
+   teardown(users);
+   start = histogram_now_ns();
+   snapshot_t *snapshot = snapshot_open(path);
+   unsigned long long open_ns = histogram_now_ns() - start;
+   unlink(path);
+   if (snapshot == NULL) {
+      fprintf(stderr, "Error opening the snapshot\n");
+      return 1;
+   }
+   start = histogram_now_ns();
+   users = snapshot_load_users(snapshot);
+   unsigned long long load_ns = histogram_now_ns() - start;
+
+   size_t num_posts = 0;
+   for (unsigned int id = 0; id < index_user_count(); id++) {
+      num_posts += index_user_by_id(id)->posts.count;
+   }
+   int result = 0;
+   if (index_user_count() != expected_users || num_posts != expected_posts) {
+      fprintf(stderr, "the snapshot loaded %zu users and %zu posts instead of %zu and %zu\n",
+              index_user_count(), num_posts, expected_users, expected_posts);
+      result = 1;
+   }
+   double seconds = (open_ns + load_ns) / 1e9;
+   printf("%8s %10s %10s %10s %10s %10s %12s %10s\n", "", "users", "write s", "open s", "load s",
+          "total s", "rows/s", "MB/s");
+   printf("%8s %10zu %10.3f %10.3f %10.3f %10.3f %12.0f %10.2f\n", "snapshot", index_user_count(),
+          write_ns / 1e9, open_ns / 1e9, load_ns / 1e9, seconds, index_user_count() / seconds,
+          bytes / seconds / 1e6);
+
+   // the posts point into the snapshot, so the users are freed before it is closed
+   teardown(users);
+   snapshot_close(snapshot);
+   return result;
+}
+
+
+/*
+   Function that generates a CSV file of about megabytes MB, then loads it with 1, 2, 4, ...
+   up to max_threads threads and prints the time of every phase of the load, including the
+   hashing of the passwords with the full rounds, then the time to start from a snapshot instead.
+   Return 0 on success and 1 on error.
+*/
+static int csv_load_benchmark(size_t megabytes, int max_threads)
+{
+   FILE *file = tmpfile();
+   if (file == NULL) {
+      perror("Error creating the CSV file");
+      return 1;
+   }
+   // a generated row takes about 330 bytes
+   size_t rows = megabytes * 1000000 / 330 + 1;
+   generate_csv(file, rows);
+   fflush(file);
+
+   load_stats_t stats;
+   user_t *users;
+   size_t expected_users = 0;
+   size_t expected_posts = 0;
+   int result = 0;
+
+   printf("%8s %10s %10s %10s %10s %10s %12s %10s\n", "threads", "rows", "parse s", "hash s",
+          "merge s", "total s", "rows/s", "MB/s");
+   for (int threads = 1; threads <= max_threads && result == 0; threads *= 2) {
+      rewind(file);
+      users = read_CSV_parallel(file, threads, &stats);
+
+      // every run must load the same users and posts
+      size_t num_posts = 0;
+      for (unsigned int id = 0; id < index_user_count(); id++) {
+         num_posts += index_user_by_id(id)->posts.count;
+      }
+      if (threads == 1) {
+         expected_users = index_user_count();
+         expected_posts = num_posts;
+      } else if (index_user_count() != expected_users || num_posts != expected_posts) {
+         fprintf(stderr, "%d threads loaded %zu users and %zu posts instead of %zu and %zu\n",
+                 threads, index_user_count(), num_posts, expected_users, expected_posts);
+         result = 1;
+      }
+
+      printf("%8d %10zu %10.3f %10.3f %10.3f %10.3f %12.0f %10.2f\n", threads, stats.rows,
+             stats.parse_seconds, stats.hash_seconds, stats.merge_seconds, stats.seconds,
+             stats.rows / stats.seconds, stats.bytes / stats.seconds / 1e6);
+      if (threads * 2 > max_threads && result == 0) {
+         // the last users loaded are saved, to time the start from a snapshot of the same users
+         result = time_snapshot_load(users, expected_users, expected_posts);
+      } else {
+         teardown(users);
+      }
+   }
+   fclose(file);
+   return result;
+}
+
+/*
+   Function that runs the load benchmark: benchmark load <megabytes> <max threads>.
+   Return -1 if the arguments are not valid.
+*/
+static int run_load(char **arguments)
+{
+   if (atol(arguments[0]) <= 0 || atoi(arguments[1]) <= 0) {
+      return -1;
+   }
+   return csv_load_benchmark(atol(arguments[0]), atoi(arguments[1]));
+}
+
+/*
+   Function that returns a random user number from 0 to count - 1, small numbers being more
+   likely, so that a few users have many friends.
+*/
+static size_t skewed_user(size_t count, unsigned int *seed)
+{
+   int bits = 1;
+   while (((size_t)1 << bits) < count) {
+      bits++;
+   }
+   size_t first = ((size_t)1 << (rand_r(seed) % bits)) - 1;
+   return (first + rand_r(seed) % (first + 1)) % count;
+}
+
+
+/*
+   Function that prints a line of the time table of the friend benchmark.
+*/
+static void print_time(const char *name, unsigned long long ns, size_t count)
+{
+   printf("%-34s %10.1f\n", name, (double)ns / count);
+}
+
+
+/*
+   Function that creates num_users users with friends, then compares the memory of their friend
+   sets with lists of friend usernames, and the time of friend operations by username and by id.
+   Return 0 on success and 1 on error.
+*/
+static int friend_benchmark(size_t count)
+{
+   user_t *users = NULL;
+   char username[30];
+   unsigned int seed = 42;
+   credential_t credential;
+   password_hash("password", &credential);
+
+   unsigned long long start = histogram_now_ns();
+   for (size_t i = 0; i < count; i++) {
+      snprintf(username, sizeof(username), "friend%zu", i);
+      insert_user_credential(&users, username, &credential);
+   }
+   for (size_t i = 0; i < count; i++) {
+      for (int j = 0; j < BENCH_FRIENDS / 2; j++) {
+         add_friend_id(index_user_by_id(i), skewed_user(count, &seed));
+      }
+   }
+   printf("created %zu users in %.1f s\n", count, (histogram_now_ns() - start) / 1e9);
+
+   // every friendship is in both users' sets
+   size_t edges = 0;
+   size_t set_bytes = 0;
+   unsigned int most_friends = 0;
+   for (unsigned int id = 0; id < count; id++) {
+      const friend_set_t *set = &index_user_by_id(id)->friends;
+      edges += set->count;
+      set_bytes += sizeof(friend_set_t) + (set->capacity + set->slot_count) * sizeof(unsigned int);
+      if (set->count > most_friends) {
+         most_friends = set->count;
+      }
+   }
+   size_t list_bytes = edges * sizeof(name_node_t) + count * sizeof(name_node_t *);
+   printf("%zu friendships, up to %u friends per user\n", edges / 2, most_friends);
+   printf("%-34s %10.1f MB %8.1f bytes per friend\n", "friend sets of ids", set_bytes / 1e6, (double)set_bytes / edges);
+   printf("%-34s %10.1f MB %8.1f bytes per friend\n", "lists of usernames (before)", list_bytes / 1e6, (double)list_bytes / edges);
+
+   // the queries are asked about a sample of the users, half of them about a friend
+   friend_query_t *queries = malloc(BENCH_FRIEND_QUERIES * sizeof(friend_query_t));
+   name_node_t **lists = calloc(count, sizeof(name_node_t *));
+   assert(queries != NULL && lists != NULL);
+   size_t sample = count < BENCH_SAMPLE_USERS ? count : BENCH_SAMPLE_USERS;
+   for (size_t i = 0; i < BENCH_FRIEND_QUERIES; i++) {
+      user_t *user = index_user_by_id(rand_r(&seed) % sample * (count / sample));
+      user_t *other = index_user_by_id(skewed_user(count, &seed));
+      if (user->friends.count > 0 && rand_r(&seed) % 2 == 0) {
+         other = index_user_by_id(user->friends.ids[rand_r(&seed) % user->friends.count]);
+      }
+      queries[i].user = user;
+      queries[i].other = other;
+      strcpy(queries[i].other_name, other->username);
+
+      // the list of the user's friends' usernames, as the friends were stored before
+      if (lists[user->id] == NULL) {
+         for (unsigned int j = user->friends.count; j > 0; j--) {
+            name_node_t *node = malloc(sizeof(name_node_t));
+            assert(node != NULL);
+            strcpy(node->username, index_user_by_id(user->friends.ids[j - 1])->username);
+            node->next = lists[user->id];
+            lists[user->id] = node;
+         }
+      }
+   }
+
+   printf("%-34s %10s\n", "friend operation", "ns per op");
+   size_t found[3] = { 0, 0, 0 };
+   start = histogram_now_ns();
+   for (size_t i = 0; i < BENCH_FRIEND_QUERIES; i++) {
+      const name_node_t *node = lists[queries[i].user->id];
+      while (node != NULL && strcmp(node->username, queries[i].other_name) != 0) {
+         node = node->next;
+      }
+      found[0] += node != NULL;
+   }
+   print_time("are friends, list of usernames", histogram_now_ns() - start, BENCH_FRIEND_QUERIES);
+
+   start = histogram_now_ns();
+   for (size_t i = 0; i < BENCH_FRIEND_QUERIES; i++) {
+      user_t *other = index_find_user(queries[i].other_name);
+      found[1] += other != NULL && are_friends(queries[i].user, other);
+   }
+   print_time("are friends, username to id", histogram_now_ns() - start, BENCH_FRIEND_QUERIES);
+
+   start = histogram_now_ns();
+   for (size_t i = 0; i < BENCH_FRIEND_QUERIES; i++) {
+      found[2] += are_friends(queries[i].user, queries[i].other);
+   }
+   print_time("are friends, ids", histogram_now_ns() - start, BENCH_FRIEND_QUERIES);
+
+   // only the friendships added are deleted again, so both kinds work on the same sets
+   size_t added[2] = { 0, 0 };
+   start = histogram_now_ns();
+   for (size_t i = 0; i < BENCH_FRIEND_QUERIES; i++) {
+      queries[i].added = add_friend(queries[i].user, queries[i].other_name);
+      added[0] += queries[i].added;
+   }
+   unsigned long long add_ns = histogram_now_ns() - start;
+   start = histogram_now_ns();
+   for (size_t i = 0; i < BENCH_FRIEND_QUERIES; i++) {
+      if (queries[i].added) {
+         delete_friend(queries[i].user, queries[i].other_name);
+      }
+   }
+   unsigned long long delete_ns = histogram_now_ns() - start;
+   print_time("add friend, username", add_ns, BENCH_FRIEND_QUERIES);
+   print_time("delete friend, username", delete_ns, added[0]);
+
+   start = histogram_now_ns();
+   for (size_t i = 0; i < BENCH_FRIEND_QUERIES; i++) {
+      queries[i].added = add_friend_id(queries[i].user, queries[i].other->id);
+      added[1] += queries[i].added;
+   }
+   add_ns = histogram_now_ns() - start;
+   start = histogram_now_ns();
+   for (size_t i = 0; i < BENCH_FRIEND_QUERIES; i++) {
+      if (queries[i].added) {
+         delete_friend_id(queries[i].user, queries[i].other->id);
+      }
+   }
+   delete_ns = histogram_now_ns() - start;
+   print_time("add friend, id", add_ns, BENCH_FRIEND_QUERIES);
+   print_time("delete friend, id", delete_ns, added[1]);
+
+   for (size_t i = 0; i < count; i++) {
+      while (lists[i] != NULL) {
+         name_node_t *next = lists[i]->next;
+         free(lists[i]);
+         lists[i] = next;
+      }
+   }
+   free(lists);
+   free(queries);
+   teardown(users);
+
+   _Bool valid = found[0] == found[1] && found[1] == found[2] && added[0] == added[1];
+   if (!valid) {
+      printf("the kinds of operations do not agree\n");
+   }
+   return valid ? 0 : 1;
+}
+
+/*
+   Function that runs the friend benchmark: benchmark friend <users>.
+   Return -1 if the arguments are not valid.
+*/
+static int run_friend(char **arguments)
+{
+   if (atol(arguments[0]) <= 1) {
+      return -1;
+   }
+   return friend_benchmark(atol(arguments[0]));
+}
+
+/*
+   Function that gives a user num_posts posts, then compares the time to read random pages of
+   them from the blocks and by walking the posts one by one. Return 0 on success and 1 on error.
+*/
+static int post_page_benchmark(size_t num_posts)
+{
+   user_t *users = NULL;
+   credential_t credential;
+   password_hash("password", &credential);
+   user_t *user = insert_user_credential(&users, "bench", &credential);
+   post_node_t *nodes = malloc(num_posts * sizeof(post_node_t));
+   size_t *pages = malloc(BENCH_PAGES * sizeof(size_t));
+   if (user == NULL || nodes == NULL || pages == NULL) {
+      fprintf(stderr, "Error creating the posts\n");
+      free(nodes);
+      free(pages);
+      return 1;
+   }
+
+   // the same posts in a linked list, newest first
+   for (size_t i = 0; i < num_posts; i++) {
+      nodes[num_posts - 1 - i].post = add_post(user, "A post of the page benchmark #bench");
+      nodes[num_posts - 1 - i].next = i > 0 ? &nodes[num_posts - i] : NULL;
+   }
+   size_t num_pages = (num_posts + BENCH_PAGE_SIZE - 1) / BENCH_PAGE_SIZE;
+   unsigned int seed = 42;
+   for (size_t i = 0; i < BENCH_PAGES; i++) {
+      pages[i] = rand_r(&seed) % num_pages;
+   }
+
+   post_t *page[BENCH_PAGE_SIZE];
+   unsigned long checksum[2] = { 0, 0 };
+   unsigned long long start = histogram_now_ns();
+   for (size_t i = 0; i < BENCH_PAGES; i++) {
+      size_t count = post_list_page(&user->posts, pages[i] * BENCH_PAGE_SIZE, page, BENCH_PAGE_SIZE);
+      for (size_t j = 0; j < count; j++) {
+         checksum[0] += page[j]->id;
+      }
+   }
+   unsigned long long chunk_ns = histogram_now_ns() - start;
+
+   start = histogram_now_ns();
+   for (size_t i = 0; i < BENCH_PAGES; i++) {
+      const post_node_t *node = &nodes[0];
+      for (size_t skip = pages[i] * BENCH_PAGE_SIZE; skip > 0; skip--) {
+         node = node->next;
+      }
+      for (size_t j = 0; j < BENCH_PAGE_SIZE && node != NULL; j++, node = node->next) {
+         checksum[1] += node->post->id;
+      }
+   }
+   unsigned long long list_ns = histogram_now_ns() - start;
+
+   printf("reading %d random pages of %d posts from a user with %zu posts\n", BENCH_PAGES, BENCH_PAGE_SIZE, num_posts);
+   printf("%-24s %12s\n", "posts kept in", "us per page");
+   printf("%-24s %12.2f\n", "blocks", chunk_ns / 1e3 / BENCH_PAGES);
+   printf("%-24s %12.2f\n", "linked list", list_ns / 1e3 / BENCH_PAGES);
+
+   free(nodes);
+   free(pages);
+   teardown(users);
+   if (checksum[0] != checksum[1]) {
+      printf("the pages are not the same\n");
+      return 1;
+   }
+   return 0;
+}
+
+/*
+   Function that runs the page benchmark: benchmark page <posts>.
+   Return -1 if the arguments are not valid.
+*/
+static int run_page(char **arguments)
+{
+   if (atol(arguments[0]) <= 0) {
+      return -1;
+   }
+   return post_page_benchmark(atol(arguments[0]));
+}
+
+/*
+   Function that writes a made-up username that is unique for every number, two names and the number.
+*/
+static void made_up_username(size_t number, char *username, size_t size)
+{
+   static const char *names[] = {
+      "Arthur", "Hermione", "Malfoy", "Gilderoy", "Filch", "Vernon", "Kreacher", "Parvati",
+      "Pansy", "Luna", "Cedric", "Minerva", "Severus", "Albus", "Remus", "Sirius",
+      "Nymphadora", "Bellatrix", "Dudley", "Petunia", "Rubeus", "Neville", "Ginny", "Fred",
+      "George", "Percy", "Molly", "Bill", "Charlie", "Fleur", "Viktor", "Cho",
+      "Dean", "Seamus", "Lavender", "Padma", "Oliver", "Katie", "Angelina", "Lee",
+      "Ernie", "Hannah", "Justin", "Susan", "Zacharias", "Terry", "Michael", "Anthony",
+      "Marcus", "Gregory", "Vincent", "Millicent", "Blaise", "Theodore", "Daphne", "Astoria",
+      "Horace", "Pomona", "Filius", "Sybill", "Quirinus", "Dolores", "Cornelius", "Rufus"
+   };
+   size_t num_names = sizeof(names) / sizeof(names[0]);
+   // the number is scrambled so that the names do not come in order
+   size_t scrambled = number * 2654435761u % 4294967291u;
+   char name[64];
+   snprintf(name, sizeof(name), "%s%s%zu", names[scrambled % num_names], names[scrambled / num_names % num_names], number);
+   assert(strlen(name) < size);
+   strcpy(username, name);
+}
+
+
+/*
+   Function that times index_complete for random prefixes of a given length of the usernames,
+   or for prefixes that match nothing if length is 0, and prints a line of the results.
+*/
+static void time_prefixes(size_t num_users, size_t length, unsigned int *seed)
+{
+   char username[30];
+   char prefix[40];
+   user_t *matches[BENCH_MATCHES];
+   histogram_t latency;
+   memset(&latency, 0, sizeof(latency));
+   size_t found = 0;
+   for (size_t i = 0; i < BENCH_COMPLETE_QUERIES; i++) {
+      made_up_username(rand_r(seed) % num_users, username, sizeof(username));
+      if (length == 0) {
+         snprintf(prefix, sizeof(prefix), "Zz%s", username);  // no name starts with Zz
+      } else {
+         snprintf(prefix, sizeof(prefix), "%.*s", (int)length, username);
+      }
+      unsigned long long start = histogram_now_ns();
+      found += index_complete(prefix, matches, BENCH_MATCHES);
+      histogram_add(&latency, histogram_now_ns() - start);
+   }
+
+   char name[32];
+   snprintf(name, sizeof(name), length == 0 ? "no match" : "%zu characters", length);
+   printf("%-16s %12.1f %10llu %10llu %10.1f\n", name, (double)latency.total_ns / latency.count,
+          histogram_percentile(&latency, 0.5), histogram_percentile(&latency, 0.99), (double)found / BENCH_COMPLETE_QUERIES);
+}
+
+
+/*
+   Function that indexes num_users made-up users, then measures the latency of prefix searches
+   of the usernames, before and after more users are registered. Return 0 on success and 1 on error.
+*/
+static int complete_benchmark(size_t num_users)
+{
+   user_t *users = calloc(num_users + BENCH_ADDED, sizeof(user_t));
+   if (users == NULL) {
+      fprintf(stderr, "Error creating the users\n");
+      return 1;
+   }
+   unsigned long long start = histogram_now_ns();
+   for (size_t i = 0; i < num_users; i++) {
+      made_up_username(i, users[i].username, sizeof(users[i].username));
+      index_insert_user(&users[i]);
+   }
+   printf("indexed %zu users in %.2f s\n", num_users, (histogram_now_ns() - start) / 1e9);
+
+   size_t count;
+   start = histogram_now_ns();
+   free(index_sorted_users(&count));
+   printf("sorted them in %.2f s\n", (histogram_now_ns() - start) / 1e9);
+
+   static const size_t lengths[] = { 1, 3, 6, 10, 0 };
+   size_t num_lengths = sizeof(lengths) / sizeof(lengths[0]);
+   unsigned int seed = 42;
+   printf("%-16s %12s %10s %10s %10s\n", "prefix", "mean ns", "p50 ns", "p99 ns", "matches");
+   for (size_t i = 0; i < num_lengths; i++) {
+      time_prefixes(num_users, lengths[i], &seed);
+   }
+
+   // the users registered now are pending until the next merge
+   for (size_t i = num_users; i < num_users + BENCH_ADDED; i++) {
+      made_up_username(i, users[i].username, sizeof(users[i].username));
+      index_insert_user(&users[i]);
+   }
+   printf("with %d users pending\n", BENCH_ADDED);
+   for (size_t i = 0; i < num_lengths; i++) {
+      time_prefixes(num_users + BENCH_ADDED, lengths[i], &seed);
+   }
+   start = histogram_now_ns();
+   free(index_sorted_users(&count));
+   printf("merged them in %.2f ms\n", (histogram_now_ns() - start) / 1e6);
+
+   // every user must be in order
+   user_t **sorted = index_sorted_users(&count);
+   _Bool valid = count == num_users + BENCH_ADDED;
+   for (size_t i = 1; valid && i < count; i++) {
+      valid = strcmp(sorted[i - 1]->username, sorted[i]->username) < 0;
+   }
+   if (!valid) {
+      printf("the users are not sorted\n");
+   }
+   free(sorted);
+   index_clear();
+   free(users);
+   return valid ? 0 : 1;
+}
+
+/*
+   Function that runs the completion benchmark: benchmark complete <users>.
+   Return -1 if the arguments are not valid.
+*/
+static int run_complete(char **arguments)
+{
+   if (atol(arguments[0]) <= 0) {
+      return -1;
+   }
+   return complete_benchmark(atol(arguments[0]));
+}
+
+
+/*
+   Function that adds a username to a linked list sorted in ascending order, walking it
+   as add_user did before the index. Return the head of the list.
+*/
+static name_node_t *list_add_user(name_node_t *head, name_node_t *node)
+{
+   if (head == NULL || strcmp(node->username, head->username) < 0) {
+      node->next = head;
+      return node;
+   }
+   name_node_t *current = head;
+   while (current->next != NULL && strcmp(node->username, current->next->username) >= 0) {
+      current = current->next;
+   }
+   node->next = current->next;
+   current->next = node;
+   return head;
+}
+
+
+/*
+   Function that finds a username in a linked list, walking it as find_user did before the index.
+*/
+static const name_node_t *list_find_user(const name_node_t *head, const char *username)
+{
+   while (head != NULL && strcmp(head->username, username) != 0) {
+      head = head->next;
+   }
+   return head;
+}
+
+
+/*
+   Function that compares the user index with the sorted linked list the users were kept in
+   before, at 10000, 100000, ... up to max_users users: the time to load the users, to add one
+   more and to find one. Loading a list takes a number of comparisons that grows as the square
+   of the users, so its load time is estimated from the time to add a user to the full list.
+   Return 0 on success and 1 on error.
+*/
+static int index_benchmark(size_t max_users)
+{
+   char username[30];
+   unsigned int seed = 42;
+   password_hash("password", &bench_credential);
+
+   printf("%10s %10s %14s %14s %14s %14s %14s\n", "users", "index s", "list s (est.)",
+          "index add ns", "list add ns", "index find ns", "list find ns");
+   for (size_t count = BENCH_INDEX_USERS; count <= max_users; count *= 10) {
+      // the users are registered in a random order, as the rows of a file would be
+      size_t *order = malloc(count * sizeof(size_t));
+      name_node_t *nodes = malloc((count + BENCH_ADDED) * sizeof(name_node_t));
+      if (order == NULL || nodes == NULL) {
+         fprintf(stderr, "Error allocating %zu users\n", count);
+         free(order);
+         free(nodes);
+         return 1;
+      }
+      for (size_t i = 0; i < count; i++) {
+         order[i] = i;
+      }
+      for (size_t i = count - 1; i > 0; i--) {
+         size_t j = rand_r(&seed) % (i + 1);
+         size_t number = order[i];
+         order[i] = order[j];
+         order[j] = number;
+      }
+
+      user_t *users = NULL;
+      unsigned long long start = histogram_now_ns();
+      for (size_t i = 0; i < count; i++) {
+         snprintf(username, sizeof(username), "user%zu", order[i]);
+         insert_user_credential(&users, username, &bench_credential);
+      }
+      unsigned long long load_ns = histogram_now_ns() - start;
+
+      // the same usernames in a sorted list, linked in order rather than loaded one by one
+      size_t sorted_count;
+      user_t **sorted = index_sorted_users(&sorted_count);
+      name_node_t *head = NULL;
+      for (size_t i = sorted_count; i > 0; i--) {
+         strcpy(nodes[i - 1].username, sorted[i - 1]->username);
+         nodes[i - 1].next = head;
+         head = &nodes[i - 1];
+      }
+      free(sorted);
+
+      // the added users fall at random places of the sorted list, right after user<number>
+      start = histogram_now_ns();
+      for (size_t i = 0; i < BENCH_ADDED; i++) {
+         snprintf(username, sizeof(username), "user%zua", order[i]);
+         insert_user_credential(&users, username, &bench_credential);
+      }
+      unsigned long long index_add_ns = histogram_now_ns() - start;
+      start = histogram_now_ns();
+      for (size_t i = 0; i < BENCH_ADDED; i++) {
+         snprintf(nodes[count + i].username, sizeof(nodes[count + i].username), "user%zua", order[i]);
+         head = list_add_user(head, &nodes[count + i]);
+      }
+      unsigned long long list_add_ns = histogram_now_ns() - start;
+
+      size_t found[2] = { 0, 0 };
+      start = histogram_now_ns();
+      for (size_t i = 0; i < BENCH_INDEX_FINDS; i++) {
+         snprintf(username, sizeof(username), "user%zu", (size_t)rand_r(&seed) % count);
+         found[0] += index_find_user(username) != NULL;
+      }
+      unsigned long long index_find_ns = histogram_now_ns() - start;
+      start = histogram_now_ns();
+      for (size_t i = 0; i < BENCH_LIST_FINDS; i++) {
+         snprintf(username, sizeof(username), "user%zu", (size_t)rand_r(&seed) % count);
+         found[1] += list_find_user(head, username) != NULL;
+      }
+      unsigned long long list_find_ns = histogram_now_ns() - start;
+
+      // adding the users one by one to a list walks half of it on average
+      double list_add_mean = (double)list_add_ns / BENCH_ADDED;
+      printf("%10zu %10.3f %14.3f %14.1f %14.1f %14.1f %14.1f\n", count, load_ns / 1e9,
+             list_add_mean * count / 2 / 1e9, (double)index_add_ns / BENCH_ADDED, list_add_mean,
+             (double)index_find_ns / BENCH_INDEX_FINDS, (double)list_find_ns / BENCH_LIST_FINDS);
+      fflush(stdout);
+
+      teardown(users);
+      free(order);
+      free(nodes);
+      if (found[0] != BENCH_INDEX_FINDS || found[1] != BENCH_LIST_FINDS) {
+         printf("some users were not found\n");
+         return 1;
+      }
+   }
+   return 0;
+}
+
+
+/*
+   Function that runs the index benchmark: benchmark index <max users>.
+   Return -1 if the arguments are not valid.
+*/
+static int run_index(char **arguments)
+{
+   if (atol(arguments[0]) < BENCH_INDEX_USERS) {
+      return -1;
+   }
+   return index_benchmark(atol(arguments[0]));
+}
+
+
+/*
+   Function that writes copies of the rows of a CSV file of users to another file until they
+   hold at least num_posts posts. The users of every copy, and their friends, get the number of
+   the copy after their names, so every copy is a group of friends of its own.
+   Return the number of posts written.
+*/
+static size_t scale_csv(FILE *sample, FILE *file, size_t num_posts)
+{
+   char *line = NULL;
+   size_t line_size = 0;
+   char **rows = NULL;
+   size_t num_rows = 0;
+   ssize_t length;
+   // the header is written once
+   if (getline(&line, &line_size, sample) > 0) {
+      fputs(line, file);
+   }
+   while ((length = getline(&line, &line_size, sample)) > 0) {
+      char **grown = realloc(rows, (num_rows + 1) * sizeof(char *));
+      assert(grown != NULL);
+      rows = grown;
+      line[strcspn(line, "\r\n")] = '\0';
+      rows[num_rows++] = strdup(line);
+   }
+   free(line);
+
+   size_t posts = 0;
+   for (size_t copy = 0; posts < num_posts && num_rows > 0; copy++) {
+      for (size_t i = 0; i < num_rows; i++) {
+         const char *field = rows[i];
+         for (int column = 0; ; column++) {
+            size_t field_length = strcspn(field, ",");
+            _Bool blank = strspn(field, " ") == field_length;
+            fprintf(file, "%s%.*s", column > 0 ? "," : "", (int)field_length, field);
+            if (!blank && (column == 0 || (column >= 2 && column < 2 + BENCH_FRIEND_COLUMNS))) {
+               fprintf(file, "_%zx", copy);
+            } else if (!blank && column >= 2 + BENCH_FRIEND_COLUMNS) {
+               posts++;
+            }
+            if (field[field_length] == '\0') {
+               break;
+            }
+            field += field_length + 1;
+         }
+         fputc('\n', file);
+      }
+   }
+   for (size_t i = 0; i < num_rows; i++) {
+      free(rows[i]);
+   }
+   free(rows);
+   return posts;
+}
+
+
+/*
+   Function that loads the rows of a CSV file of users copied until they hold num_posts posts,
+   then prints the memory of the posts, from their nodes and text to the table that finds them
+   by id and the blocks of their authors' lists, the memory of the process, and the memory the
+   posts would take in the fixed buffers of 250 characters they had before the text arena.
+   Return 0 on success and 1 on error.
+*/
+static int post_memory_benchmark(const char *path, size_t num_posts)
+{
+   // a post as it was stored before the text arena
+   struct fixed_post
+   {
+      char content[250];
+      struct fixed_post *next;
+   };
+   FILE *sample = fopen(path, "r");
+   if (sample == NULL) {
+      perror("Error opening the CSV file");
+      return 1;
+   }
+   FILE *file = tmpfile();
+   if (file == NULL) {
+      perror("Error creating the CSV file");
+      fclose(sample);
+      return 1;
+   }
+   size_t written = scale_csv(sample, file, num_posts);
+   fclose(sample);
+   rewind(file);
+
+   // the memory is measured, not the hashing, which the load benchmark times
+   password_set_iterations(1);
+   size_t rss_before = process_memory("VmRSS");
+   load_stats_t stats;
+   user_t *users = read_CSV_parallel(file, password_threads(), &stats);
+   size_t rss = process_memory("VmRSS");
+   password_set_iterations(PASSWORD_ITERATIONS);
+   fclose(file);
+
+   pool_stats_t user_stats;
+   pool_stats_t post_stats;
+   get_pool_stats(&user_stats, &post_stats);
+   size_t posts = post_stats.live;
+   size_t text_bytes = text_arena_reserved();
+   size_t table_bytes = post_table_bytes();
+   size_t list_bytes = 0;
+   for (unsigned int id = 0; id < index_user_count(); id++) {
+      list_bytes += post_list_bytes(&index_user_by_id(id)->posts);
+   }
+   size_t total_bytes = post_stats.bytes + text_bytes + table_bytes + list_bytes;
+   size_t fixed_bytes = posts * sizeof(struct fixed_post);
+   printf("loaded %zu users and %zu posts (%zu in the file) in %.2f s, %.1f characters per post\n",
+          index_user_count(), posts, written, stats.seconds, posts > 0 ? (double)text_arena_used() / posts : 0.0);
+   printf("%-32s %12s %16s\n", "memory", "MB", "bytes per post");
+   printf("%-32s %12.1f %16.1f\n", "post nodes", post_stats.bytes / 1e6, (double)post_stats.bytes / posts);
+   printf("%-32s %12.1f %16.1f\n", "text arena", text_bytes / 1e6, (double)text_bytes / posts);
+   printf("%-32s %12.1f %16.1f\n", "post table", table_bytes / 1e6, (double)table_bytes / posts);
+   printf("%-32s %12.1f %16.1f\n", "post list blocks", list_bytes / 1e6, (double)list_bytes / posts);
+   printf("%-32s %12.1f %16.1f\n", "posts", total_bytes / 1e6, (double)total_bytes / posts);
+   printf("%-32s %12.1f %16.1f\n", "250-character buffers (before)", fixed_bytes / 1e6, (double)fixed_bytes / posts);
+   printf("%-32s %12.1f %16.1f\n", "resident memory of the load", (rss - rss_before) / 1e6, (double)(rss - rss_before) / posts);
+   printf("%-32s %12.1f\n", "resident memory of the process", rss / 1e6);
+
+   teardown(users);
+   return posts == written ? 0 : 1;
+}
+
+
+/*
+   Function that runs the post memory benchmark: benchmark posts <csv file> <posts>.
+   Return -1 if the arguments are not valid.
+*/
+static int run_posts(char **arguments)
+{
+   if (atol(arguments[1]) <= 0) {
+      return -1;
+   }
+   return post_memory_benchmark(arguments[0], atol(arguments[1]));
+}
+
+
+/*
+   Function that gives a user 10, 100, ... up to max_friends friends and measures the latency of
+   checking whether it is friends with random users, half of whom are its friends, at every size.
+   Return 0 on success and 1 on error.
+*/
+static int membership_benchmark(size_t max_friends)
+{
+   user_t *users = NULL;
+   char username[30];
+   unsigned int seed = 42;
+   password_hash("password", &bench_credential);
+   // the user, its friends and as many other users
+   size_t count = 2 * max_friends + 1;
+   for (size_t i = 0; i < count; i++) {
+      snprintf(username, sizeof(username), "member%zu", i);
+      insert_user_credential(&users, username, &bench_credential);
+   }
+   user_t *user = index_user_by_id(0);
+   user_t **others = malloc(BENCH_MEMBER_QUERIES * sizeof(user_t *));
+   if (others == NULL) {
+      fprintf(stderr, "Error allocating the queries\n");
+      teardown(users);
+      return 1;
+   }
+
+   printf("%-10s %14s %10s %10s %10s\n", "friends", "ns per check", "p50 ns", "p99 ns", "max ns");
+   _Bool valid = 1;
+   size_t num_friends = 0;
+   for (size_t size = BENCH_MEMBER_FRIENDS; size <= max_friends; size *= 10) {
+      while (num_friends < size) {
+         add_friend_id(user, ++num_friends);
+      }
+      // the ids from 1 to size are friends, the ids above max_friends are not
+      size_t expected = 0;
+      for (size_t i = 0; i < BENCH_MEMBER_QUERIES; i++) {
+         if (rand_r(&seed) % 2 == 0) {
+            others[i] = index_user_by_id(1 + rand_r(&seed) % size);
+            expected++;
+         } else {
+            others[i] = index_user_by_id(max_friends + 1 + rand_r(&seed) % max_friends);
+         }
+      }
+      // the user's own set is searched, as are_friends would search the one-friend set of the
+      // other user; the mean is timed over all the checks, as reading the clock takes longer
+      // than a check, and the percentiles include the time to read the clock
+      size_t found = 0;
+      for (size_t i = 0; i < BENCH_MEMBER_QUERIES; i++) {
+         // an untimed pass, so the first size is not timed on cold caches
+         friend_set_contains(&user->friends, others[i]->id);
+      }
+      unsigned long long start = histogram_now_ns();
+      for (size_t i = 0; i < BENCH_MEMBER_QUERIES; i++) {
+         found += friend_set_contains(&user->friends, others[i]->id);
+      }
+      unsigned long long total_ns = histogram_now_ns() - start;
+      histogram_t latency;
+      memset(&latency, 0, sizeof(latency));
+      for (size_t i = 0; i < BENCH_MEMBER_QUERIES; i++) {
+         start = histogram_now_ns();
+         found += friend_set_contains(&user->friends, others[i]->id);
+         histogram_add(&latency, histogram_now_ns() - start);
+      }
+      printf("%-10zu %14.1f %10llu %10llu %10llu\n", size, (double)total_ns / BENCH_MEMBER_QUERIES,
+             histogram_percentile(&latency, 0.50), histogram_percentile(&latency, 0.99), latency.max_ns);
+      valid &= found == 2 * expected;
+   }
+   if (!valid) {
+      printf("some friends were not found\n");
+   }
+   free(others);
+   teardown(users);
+   return valid ? 0 : 1;
+}
+
+
+/*
+   Function that runs the membership benchmark: benchmark member <max friends>.
+   Return -1 if the arguments are not valid.
+*/
+static int run_member(char **arguments)
+{
+   if (atol(arguments[0]) < BENCH_MEMBER_FRIENDS) {
+      return -1;
+   }
+   return membership_benchmark(atol(arguments[0]));
+}
+
+
+/*
+   Function that generates and loads a file of num_users users whose friends follow a power law.
+   Return the users, or NULL if the file can not be created.
+*/
+static user_t *load_generated_users(size_t num_users, unsigned int seed)
+{
+   FILE *file = tmpfile();
+   if (file == NULL) {
+      perror("Error creating the CSV file");
+      return NULL;
+   }
+   generator_options_t options;
+   generator_default_options(&options);
+   options.users = num_users;
+   options.seed = seed;
+   generate_users_csv(file, &options, NULL);
+   rewind(file);
+
+   // the graph is measured, not the hashing, which the load benchmark times
+   password_set_iterations(1);
+   load_stats_t stats;
+   user_t *users = read_CSV_parallel(file, password_threads(), &stats);
+   password_set_iterations(PASSWORD_ITERATIONS);
+   fclose(file);
+   size_t edges = 0;
+   unsigned int most_friends = 0;
+   for (unsigned int id = 0; id < index_user_count(); id++) {
+      unsigned int friends = index_user_by_id(id)->friends.count;
+      edges += friends;
+      most_friends = friends > most_friends ? friends : most_friends;
+   }
+   printf("loaded %zu users with %zu friendships, up to %u friends per user, in %.1f s\n",
+          index_user_count(), edges / 2, most_friends, stats.seconds);
+   return users;
+}
+
+
+/*
+   Function that times the recommendations of a user and adds them to a histogram.
+*/
+static void time_recommend(user_t *user, histogram_t *latency, size_t *friends)
+{
+   recommendation_t results[BENCH_SUGGESTIONS];
+   unsigned long long start = histogram_now_ns();
+   recommend_friends(user, results, BENCH_SUGGESTIONS);
+   histogram_add(latency, histogram_now_ns() - start);
+   *friends += user->friends.count;
+}
+
+
+/*
+   Function that loads num_users generated users whose friends follow a power law, then measures
+   the latency of the recommendations of random users and of the users with the most friends.
+   Return 0 on success and 1 on error.
+*/
+static int recommend_benchmark(size_t num_users, size_t queries)
+{
+   user_t *users = load_generated_users(num_users, 42);
+   if (users == NULL) {
+      return 1;
+   }
+   unsigned int seed = 42;
+   histogram_t random_latency;
+   histogram_t popular_latency;
+   memset(&random_latency, 0, sizeof(random_latency));
+   memset(&popular_latency, 0, sizeof(popular_latency));
+   size_t friends[2] = { 0, 0 };
+   char username[30];
+   for (size_t i = 0; i < queries; i++) {
+      time_recommend(index_user_by_id(rand_r(&seed) % index_user_count()), &random_latency, &friends[0]);
+      // the generator makes the users with the smallest numbers the most popular
+      snprintf(username, sizeof(username), "user%zu", i % BENCH_POPULAR_USERS);
+      time_recommend(index_find_user(username), &popular_latency, &friends[1]);
+   }
+
+   printf("%-18s %10s %10s %10s %10s %10s %10s\n", "recommendations", "count", "mean ns", "p50 ns", "p99 ns", "p99.9 ns", "max ns");
+   print_latency("random users", &random_latency);
+   print_latency("most popular", &popular_latency);
+   printf("mean friends: %.1f for the random users, %.1f for the %d most popular\n",
+          (double)friends[0] / queries, (double)friends[1] / queries, BENCH_POPULAR_USERS);
+   teardown(users);
+   return 0;
+}
+
+
+/*
+   Function that runs the recommendation benchmark: benchmark recommend <users> <queries>.
+   Return -1 if the arguments are not valid.
+*/
+static int run_recommend(char **arguments)
+{
+   if (atol(arguments[0]) <= BENCH_POPULAR_USERS || atol(arguments[1]) <= 0) {
+      return -1;
+   }
+   return recommend_benchmark(atol(arguments[0]), atol(arguments[1]));
+}
+
+
+/*
+   Function that loads num_users generated users whose friends follow a power law, then runs a
+   mix of feed reads, posts and friend changes by random users, and prints the latency of each.
+   A read is of the first page of the feed, or of the first two pages.
+   Return 0 on success and 1 on error.
+*/
+static int feed_benchmark(size_t num_users, size_t operations)
+{
+   user_t *users = load_generated_users(num_users, 42);
+   if (users == NULL) {
+      return 1;
+   }
+   unsigned int seed = 42;
+   histogram_t reads;
+   histogram_t posts;
+   histogram_t friends;
+   memset(&reads, 0, sizeof(reads));
+   memset(&posts, 0, sizeof(posts));
+   memset(&friends, 0, sizeof(friends));
+   post_t *page[BENCH_FEED_PAGE];
+   size_t read_posts = 0;
+   size_t count = index_user_count();
+   for (size_t i = 0; i < operations; i++) {
+      user_t *user = index_user_by_id(rand_r(&seed) % count);
+      int kind = rand_r(&seed) % 100;
+      if (kind < BENCH_FEED_READS) {
+         unsigned long long start = histogram_now_ns();
+         size_t found = feed_page(user, 0, page, BENCH_FEED_PAGE);
+         histogram_add(&reads, histogram_now_ns() - start);
+         read_posts += found;
+         if (found == BENCH_FEED_PAGE && rand_r(&seed) % 2 == 0) {
+            start = histogram_now_ns();
+            read_posts += feed_page(user, page[found - 1]->id, page, BENCH_FEED_PAGE);
+            histogram_add(&reads, histogram_now_ns() - start);
+         }
+      } else if (kind < BENCH_FEED_READS + BENCH_FEED_POSTS) {
+         unsigned long long start = histogram_now_ns();
+         add_post(user, "A post made while the feed benchmark runs #feed");
+         histogram_add(&posts, histogram_now_ns() - start);
+      } else {
+         user_t *other = index_user_by_id(rand_r(&seed) % count);
+         unsigned long long start = histogram_now_ns();
+         if (are_friends(user, other)) {
+            delete_friend(user, other->username);
+         } else if (other != user) {
+            add_friend(user, other->username);
+         }
+         histogram_add(&friends, histogram_now_ns() - start);
+      }
+   }
+
+   printf("%d%% feed reads, %d%% posts and %d%% friend changes; %.1f posts per page read\n", BENCH_FEED_READS,
+          BENCH_FEED_POSTS, 100 - BENCH_FEED_READS - BENCH_FEED_POSTS, reads.count > 0 ? (double)read_posts / reads.count : 0.0);
+   printf("%-18s %10s %10s %10s %10s %10s %10s\n", "operation", "count", "mean ns", "p50 ns", "p99 ns", "p99.9 ns", "max ns");
+   print_latency("feed page", &reads);
+   print_latency("post", &posts);
+   print_latency("friend change", &friends);
+   teardown(users);
+   return 0;
+}
+
+
+/*
+   Function that runs the feed benchmark: benchmark feed <users> <operations>.
+   Return -1 if the arguments are not valid.
+*/
+static int run_feed(char **arguments)
+{
+   if (atol(arguments[0]) <= 1 || atol(arguments[1]) <= 0) {
+      return -1;
+   }
+   return feed_benchmark(atol(arguments[0]), atol(arguments[1]));
+}
+
+
+/*
+   Function that orders posts from the newest to the oldest.
+*/
+static int compare_newest_first(const void *a, const void *b)
+{
+   unsigned long first = (*(post_t *const *)a)->id;
+   unsigned long second = (*(post_t *const *)b)->id;
+   return first < second ? 1 : first > second ? -1 : 0;
+}
+
+
+/*
+   Function that reads the first page of a user's feed the way display_all_posts reads the posts:
+   every post of every friend is gathered in all, then they are sorted and the newest are kept.
+   Return the number of posts stored in page.
+*/
+static size_t walk_first_page(const user_t *user, post_t **all, post_t **page, size_t limit)
+{
+   size_t count = 0;
+   for (unsigned int i = 0; i < user->friends.count; i++) {
+      const user_t *friend = index_user_by_id(user->friends.ids[i]);
+      post_cursor_t cursor;
+      for (post_t *post = post_list_seek(&friend->posts, 0, &cursor); post != NULL; post = post_list_next(&cursor)) {
+         all[count++] = post;
+      }
+   }
+   qsort(all, count, sizeof(post_t *), compare_newest_first);
+   count = count < limit ? count : limit;
+   memcpy(page, all, count * sizeof(post_t *));
+   return count;
+}
+
+
+/*
+   Function that compares the time to read the first page of a user's feed by merging the post
+   lists of its friends and by walking all their posts, for 10, 100, ... up to max_friends friends
+   with BENCH_FRIEND_POSTS posts each and pages of a few sizes. Return 0 on success and 1 on error.
+*/
+static int first_page_benchmark(size_t max_friends)
+{
+   static const size_t page_sizes[] = { 10, 50, 200 };
+   size_t num_sizes = sizeof(page_sizes) / sizeof(page_sizes[0]);
+   size_t max_page = page_sizes[num_sizes - 1];
+   user_t *users = NULL;
+   char username[30];
+   password_hash("password", &bench_credential);
+   user_t *reader = insert_user_credential(&users, "reader", &bench_credential);
+   for (size_t i = 0; i < max_friends; i++) {
+      snprintf(username, sizeof(username), "poster%zu", i);
+      insert_user_credential(&users, username, &bench_credential);
+   }
+   // the friends post in turns, so their posts are interleaved in time
+   for (int round = 0; round < BENCH_FRIEND_POSTS; round++) {
+      for (size_t i = 1; i <= max_friends; i++) {
+         add_post(index_user_by_id(i), "A post of the first page benchmark #feed");
+      }
+   }
+   post_t **all = malloc(max_friends * BENCH_FRIEND_POSTS * sizeof(post_t *));
+   post_t **merged = malloc(max_page * sizeof(post_t *));
+   post_t **walked = malloc(max_page * sizeof(post_t *));
+   if (reader == NULL || all == NULL || merged == NULL || walked == NULL) {
+      fprintf(stderr, "Error creating the posts\n");
+      free(all);
+      free(merged);
+      free(walked);
+      teardown(users);
+      return 1;
+   }
+
+   printf("%10s %10s %14s %14s %10s\n", "friends", "page", "merge us", "walk us", "speedup");
+   _Bool valid = 1;
+   size_t num_friends = 0;
+   for (size_t size = BENCH_MEMBER_FRIENDS; size <= max_friends; size *= 10) {
+      while (num_friends < size) {
+         add_friend_id(reader, ++num_friends);
+      }
+      for (size_t i = 0; i < num_sizes; i++) {
+         size_t limit = page_sizes[i];
+         // a first read of each kind brings the posts into the cache
+         size_t count[2] = { 0, 0 };
+         feed_merge_page(reader, 0, merged, limit);
+         walk_first_page(reader, all, walked, limit);
+         unsigned long long start = histogram_now_ns();
+         for (int read = 0; read < BENCH_FIRST_PAGE_READS; read++) {
+            count[0] = feed_merge_page(reader, 0, merged, limit);
+         }
+         unsigned long long merge_ns = histogram_now_ns() - start;
+         start = histogram_now_ns();
+         for (int read = 0; read < BENCH_FIRST_PAGE_READS; read++) {
+            count[1] = walk_first_page(reader, all, walked, limit);
+         }
+         unsigned long long walk_ns = histogram_now_ns() - start;
+         printf("%10zu %10zu %14.2f %14.2f %9.1fx\n", size, limit, merge_ns / 1e3 / BENCH_FIRST_PAGE_READS,
+                walk_ns / 1e3 / BENCH_FIRST_PAGE_READS, (double)walk_ns / merge_ns);
+         valid &= count[0] == count[1] && memcmp(merged, walked, count[0] * sizeof(post_t *)) == 0;
+      }
+   }
+   if (!valid) {
+      printf("the pages are not the same\n");
+   }
+   free(all);
+   free(merged);
+   free(walked);
+   teardown(users);
+   return valid ? 0 : 1;
+}
+
+
+/*
+   Function that runs the first page benchmark: benchmark first-page <max friends>.
+   Return -1 if the arguments are not valid.
+*/
+static int run_first_page(char **arguments)
+{
+   if (atol(arguments[0]) < BENCH_MEMBER_FRIENDS) {
+      return -1;
+   }
+   return first_page_benchmark(atol(arguments[0]));
+}
+
+// The benchmarks of a part of the program, each run on its own
+static const operation_t operations[] = {
+    { "wal", "<file> <records> <max threads>", 3, run_wal,
+      "measures the log's records per second with a sync per record and with group commit" },
+    { "checkpoint", "<file> <users>", 2, run_checkpoint,
+      "measures the latency of changes while a checkpoint of that many users is written" },
+    { "search", "<posts>", 1, run_search,
+      "measures how fast that many posts are indexed and how fast they are searched" },
+    { "trending", "<posts>", 1, run_trending,
+      "measures how fast the hashtags of that many posts are counted and the memory it takes" },
+    { "delete", "<posts>", 1, run_delete,
+      "measures the latency of deleting posts by position and by id from a user with that many posts" },
+    { "scan", "<users>", 1, run_scan,
+      "compares a pass over that many users through the linked list and through a user table" },
+    { "password", "<users> <max threads>", 2, run_password,
+      "measures the passwords hashed per second with 1, 2, 4, ... threads and the time to hash a CSV file of users" },
+    { "load", "<megabytes> <max threads>", 2, run_load,
+      "measures the time to load a generated CSV file of that size with 1, 2, 4, ... threads" },
+    { "friend", "<users>", 1, run_friend,
+      "compares the memory and the speed of friends stored as ids and as lists of usernames" },
+    { "page", "<posts>", 1, run_page,
+      "measures the time to read random pages of the posts of a user with that many posts" },
+    { "complete", "<users>", 1, run_complete,
+      "measures the latency of finding the usernames that start with a prefix among that many users" },
+    { "index", "<max users>", 1, run_index,
+      "compares the load, add and find times of the user index and of a sorted linked list at 10000, 100000, ... users" },
+    { "posts", "<csv file> <posts>", 2, run_posts,
+      "measures the memory of the posts of a CSV file of users copied until it has that many posts" },
+    { "member", "<max friends>", 1, run_member,
+      "measures the latency of checking a friendship of a user with 10, 100, ... friends" },
+    { "recommend", "<users> <queries>", 2, run_recommend,
+      "measures the latency of friend recommendations among that many users whose friends follow a power law" },
+    { "feed", "<users> <operations>", 2, run_feed,
+      "measures the latency of feed reads mixed with posts and friend changes among that many users" },
+    { "first-page", "<max friends>", 1, run_first_page,
+      "compares the first page of a feed merged from the friends' posts with a walk of all their posts" },
+};
+
+
+/*
+   Function that prints how to run the suite and every benchmark.
+*/
+static void print_usage(const char *program)
+{
+   fprintf(stderr, "Usage: %s [--scales <users>,<users>,...] [--rounds <password hash rounds>] [--seed <seed>]\n", program);
+   for (size_t i = 0; i < sizeof(operations) / sizeof(operations[0]); i++) {
+      fprintf(stderr, "       %s %s %s\n           %s\n", program, operations[i].name, operations[i].arguments,
+              operations[i].description);
+   }
+}
+
+
+/*
+   Function that runs the benchmark with a name, with the arguments that follow it.
+   Return 0 on success, 1 on error and -1 if there is no such benchmark or the arguments are not valid.
+*/
+static int run_operation(const char *name, int num_arguments, char **arguments)
+{
+   for (size_t i = 0; i < sizeof(operations) / sizeof(operations[0]); i++) {
+      if (strcmp(operations[i].name, name) == 0) {
+         return num_arguments == operations[i].num_arguments ? operations[i].run(arguments) : -1;
+      }
+   }
+   return -1;
+}
+
+/*
+   Usage:
+     benchmark [--scales <users>,<users>,...] [--rounds <password hash rounds>] [--seed <seed>]
+         times the user operations at every scale, 1000, 10000 and 100000 users by default,
+         and writes one line of JSON per operation and scale to the standard output
+     benchmark <benchmark> <arguments>
+         runs the benchmark of one part of the program, see print_usage for the list
+*/
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && strncmp(argv[1], "--", 2) != 0) {
+        int result = run_operation(argv[1], argc - 2, argv + 2);
+        if (result < 0) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        return result;
+    }
+
+    suite_t suite = { { 1000, 10000, 100000 }, 3, 1, 42 };
+    _Bool valid = argc % 2 == 1;
+    for (int i = 1; i + 1 < argc && valid; i += 2) {
+        if (strcmp(argv[i], "--scales") == 0) {
+            suite.num_scales = parse_scales(argv[i + 1], suite.scales);
+            valid = suite.num_scales > 0;
+        } else if (strcmp(argv[i], "--rounds") == 0 && atoi(argv[i + 1]) > 0) {
+            suite.rounds = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            suite.seed = strtoul(argv[i + 1], NULL, 10);
+        } else {
+            valid = 0;
+        }
+    }
+    if (!valid) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    password_set_iterations(suite.rounds);
+    for (int i = 0; i < suite.num_scales; i++) {
+        if (run_scale(&suite, suite.scales[i]) != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
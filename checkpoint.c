@@ -0,0 +1,274 @@
+/**
+ * @file checkpoint.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the background checkpoint, which
+ * saves a point-in-time view of the users with copy-on-write.
+ *
+ * When a checkpoint starts, it takes the list of the users, sorted by
+ * username, and a new epoch number. The checkpoint thread then copies every
+ * user whose epoch is not the checkpoint's, and marks it. Before changing a
+ * user, the foreground calls checkpoint_preserve, which copies the user
+ * first if the checkpoint thread has not reached it yet. Either way every
+ * user is copied exactly once, as it was when the checkpoint started, and
+ * the foreground only waits for the copy of the users it changes. The copies
+ * are written with the snapshot writer once they are all made.
+ *
+ * Post contents are not copied: the text arena and the mapped snapshot that
+ * hold them never move or free them while the program runs.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <pthread.h>
+#include "nodes.h"
+#include "functions.h"
+#include "user_index.h"
+#include "snapshot.h"
+#include "wal.h"
+#include "histogram.h"
+#include "post_list.h"
+#include "checkpoint.h"
+
+static pthread_mutex_t control_lock = PTHREAD_MUTEX_INITIALIZER;    // protects thread and started
+static pthread_t thread;
+static _Bool started = 0;           // the checkpoint thread has not been joined
+static pthread_mutex_t checkpoint_lock = PTHREAD_MUTEX_INITIALIZER; // protects the fields below and the users' epochs
+static unsigned int epoch = 0;
+static _Bool active = 0;            // users are still being copied, read without the lock by checkpoint_preserve
+static _Bool running = 0;           // the checkpoint thread has not finished
+static char *checkpoint_path = NULL;
+static user_t **sorted = NULL;      // the users when the checkpoint started, sorted by username
+static user_t **copies = NULL;      // the copies of the users, by id
+static size_t num_users = 0;
+static uint64_t log_records = 0;
+static unsigned long long start_ns = 0;
+static checkpoint_stats_t stats;
+
+
+/*
+   Function that copies a user's details, friends and posts. The copy is only used to write
+   the checkpoint: its friend set has no hash table and its posts are copied to a single array.
+*/
+static user_t *copy_user(const user_t *user)
+{
+   user_t *copy = calloc(1, sizeof(user_t));
+   assert(copy != NULL);
+   copy->id = user->id;
+   copy->shard = user->shard;
+   strcpy(copy->username, user->username);
+   copy->credential = user->credential;
+
+   copy->friends.count = user->friends.count;
+   copy->friends.capacity = user->friends.count;
+   copy->friends.ids = malloc((user->friends.count + 1) * sizeof(unsigned int));
+   assert(copy->friends.ids != NULL);
+   memcpy(copy->friends.ids, user->friends.ids, user->friends.count * sizeof(unsigned int));
+
+   size_t num_posts = user->posts.count;
+   if (num_posts > 0) {
+      post_t *posts = malloc(num_posts * sizeof(post_t));
+      assert(posts != NULL);
+      size_t i = 0;
+      post_cursor_t cursor;
+      for (const post_t *current = post_list_seek(&user->posts, 0, &cursor); current != NULL; current = post_list_next(&cursor), i++) {
+         posts[i] = *current;
+      }
+      // the copies are added oldest first, so the newest is at the start of the array
+      while (i > 0) {
+         post_list_push(&copy->posts, &posts[--i]);
+      }
+   }
+   return copy;
+}
+
+
+/*
+   Function that frees a copy made by copy_user.
+*/
+static void free_copy(user_t *copy)
+{
+   free(copy->friends.ids);
+   post_cursor_t cursor;
+   post_t *posts = post_list_seek(&copy->posts, 0, &cursor); // the newest post is the start of the array
+   post_list_free(&copy->posts);
+   free(posts);
+   free(copy);
+}
+
+
+/*
+   Function that copies the users the foreground has not copied yet, then writes the checkpoint.
+*/
+static void *run_checkpoint(void *argument)
+{
+   (void)argument;
+   for (size_t i = 0; i < num_users; i++) {
+      user_t *user = sorted[i];
+      pthread_mutex_lock(&checkpoint_lock);
+      if (user->checkpoint_epoch != epoch) {
+         copies[user->id] = copy_user(user);
+         user->checkpoint_epoch = epoch;
+      }
+      sorted[i] = copies[user->id];
+      pthread_mutex_unlock(&checkpoint_lock);
+   }
+
+   // every user is copied, the foreground can change them freely again
+   pthread_mutex_lock(&checkpoint_lock);
+   __atomic_store_n(&active, 0, __ATOMIC_RELEASE);
+   pthread_mutex_unlock(&checkpoint_lock);
+
+   int result = snapshot_write_users(checkpoint_path, sorted, num_users, log_records);
+   for (size_t i = 0; i < num_users; i++) {
+      free_copy(sorted[i]);
+   }
+   free(sorted);
+   free(copies);
+   sorted = NULL;
+   copies = NULL;
+
+   pthread_mutex_lock(&checkpoint_lock);
+   stats.result = result;
+   stats.seconds = (histogram_now_ns() - start_ns) / 1e9;
+   running = 0;
+   pthread_mutex_unlock(&checkpoint_lock);
+
+   if (result != 0) {
+      perror("Error writing the checkpoint");
+   } else {
+      fprintf(stderr, "Checkpoint of %zu users written to %s in %.1f ms\n",
+              stats.users, checkpoint_path, stats.seconds * 1e3);
+   }
+   return NULL;
+}
+
+
+/*
+   Function that starts a checkpoint of all the users to a snapshot file.
+   The checkpoint includes every change made before the function returns and none
+   of the changes made after. Return 0 if the checkpoint started, CHECKPOINT_RUNNING if a
+   checkpoint is already running and CHECKPOINT_NO_THREAD if its thread can not be created.
+*/
+int checkpoint_start(const char *path)
+{
+   pthread_mutex_lock(&control_lock);
+   if (checkpoint_running()) {
+      pthread_mutex_unlock(&control_lock);
+      return CHECKPOINT_RUNNING;
+   }
+   if (started) {
+      pthread_join(thread, NULL);
+      started = 0;
+   }
+
+   // no change can be in progress while the users are listed: threads change users
+   // with the shards of the index locked
+   shard_mask_t all_shards = ~(shard_mask_t)0;
+   index_lock_shards(0, all_shards);
+   pthread_mutex_lock(&checkpoint_lock);
+
+   size_t count;
+   sorted = index_sorted_users(&count);
+   copies = calloc(count + 1, sizeof(user_t *));
+   free(checkpoint_path);
+   checkpoint_path = strdup(path);
+   assert(copies != NULL && checkpoint_path != NULL);
+   num_users = count;
+   log_records = wal_position();
+   epoch++;
+
+   memset(&stats, 0, sizeof(stats));
+   stats.users = count;
+   start_ns = histogram_now_ns();
+   running = 1;
+   __atomic_store_n(&active, 1, __ATOMIC_RELEASE);
+
+   int result = 0;
+   int error = pthread_create(&thread, NULL, run_checkpoint, NULL);
+   if (error != 0) {
+      __atomic_store_n(&active, 0, __ATOMIC_RELEASE);
+      running = 0;
+      free(sorted);
+      free(copies);
+      sorted = NULL;
+      copies = NULL;
+      errno = error;
+      result = CHECKPOINT_NO_THREAD;
+   } else {
+      started = 1;
+   }
+
+   pthread_mutex_unlock(&checkpoint_lock);
+   index_unlock_shards(0, all_shards);
+   pthread_mutex_unlock(&control_lock);
+   return result;
+}
+
+
+/*
+   Function that must be called before a user's password, friends or posts are changed.
+   If a running checkpoint has not saved the user yet, the user is copied as it is now.
+*/
+void checkpoint_preserve(user_t *user)
+{
+   if (!__atomic_load_n(&active, __ATOMIC_ACQUIRE)) {
+      return; // no checkpoint is copying users
+   }
+
+   unsigned long long start = histogram_now_ns();
+   pthread_mutex_lock(&checkpoint_lock);
+   if (active && user->id < num_users && user->checkpoint_epoch != epoch) {
+      copies[user->id] = copy_user(user);
+      user->checkpoint_epoch = epoch;
+
+      unsigned long long ns = histogram_now_ns() - start;
+      stats.preserved++;
+      stats.preserve_total_ns += ns;
+      if (ns > stats.preserve_max_ns) {
+         stats.preserve_max_ns = ns;
+      }
+   }
+   pthread_mutex_unlock(&checkpoint_lock);
+}
+
+
+/*
+   Function that tells if a checkpoint is running.
+*/
+_Bool checkpoint_running()
+{
+   pthread_mutex_lock(&checkpoint_lock);
+   _Bool result = running;
+   pthread_mutex_unlock(&checkpoint_lock);
+   return result;
+}
+
+
+/*
+   Function that waits until the last checkpoint is finished and copies its statistics.
+   Return the result of the checkpoint: 0 if its file was written and -1 otherwise.
+*/
+int checkpoint_wait(checkpoint_stats_t *result_stats)
+{
+   pthread_mutex_lock(&control_lock);
+   if (started) {
+      pthread_join(thread, NULL);
+      started = 0;
+   }
+   pthread_mutex_unlock(&control_lock);
+
+   pthread_mutex_lock(&checkpoint_lock);
+   if (result_stats != NULL) {
+      *result_stats = stats;
+   }
+   int result = stats.result;
+   pthread_mutex_unlock(&checkpoint_lock);
+   return result;
+}
+
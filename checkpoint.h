@@ -0,0 +1,60 @@
+/**
+ * @file checkpoint.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the background checkpoint. A checkpoint saves
+ * the users, their friends and posts as they were when it started to a
+ * snapshot file, from a thread of its own, while the users keep changing.
+ * The snapshot can be loaded with --snapshot, and the write-ahead log
+ * records made after the checkpoint started are replayed on top of it.
+ */
+
+#ifndef __A2_CHECKPOINT_H__
+#define __A2_CHECKPOINT_H__
+#include <stddef.h>
+#include "nodes.h"
+
+// Why checkpoint_start did not start a checkpoint
+#define CHECKPOINT_RUNNING -1           // another checkpoint is still being written
+#define CHECKPOINT_NO_THREAD -2         // the thread could not be created, errno tells why
+
+// Statistics of a checkpoint
+typedef struct checkpoint_stats
+{
+    size_t users;                       // users in the checkpoint
+    size_t preserved;                   // users copied by the foreground before changing them
+    unsigned long long preserve_max_ns; // the longest copy made by the foreground
+    unsigned long long preserve_total_ns;
+    double seconds;                     // time from the start to the rename of the file
+    int result;                         // 0 if the file was written, -1 otherwise
+} checkpoint_stats_t;
+
+/*
+   Function that starts a checkpoint of all the users to a snapshot file.
+   The checkpoint includes every change made before the function returns and none
+   of the changes made after. Return 0 if the checkpoint started, CHECKPOINT_RUNNING if a
+   checkpoint is already running and CHECKPOINT_NO_THREAD if its thread can not be created.
+*/
+int checkpoint_start(const char *path);
+
+/*
+   Function that must be called before a user's password, friends or posts are changed.
+   If a running checkpoint has not saved the user yet, the user is copied as it is now.
+*/
+void checkpoint_preserve(user_t *user);
+
+/*
+   Function that tells if a checkpoint is running.
+*/
+_Bool checkpoint_running();
+
+/*
+   Function that waits until the last checkpoint is finished and copies its statistics.
+   Return the result of the checkpoint: 0 if its file was written and -1 otherwise.
+*/
+int checkpoint_wait(checkpoint_stats_t *stats);
+
+
+#endif
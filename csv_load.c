@@ -0,0 +1,393 @@
+/**
+ * @file csv_load.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the parallel CSV loader. A chunk
+ * starts at the first row that begins in its share of the bytes, so every row
+ * is parsed by exactly one thread. The threads copy the fields they keep into
+ * their arena, terminated by '\0', and drop the blank ones.
+ *
+ * The merge takes two passes over the rows in the order of the file: the
+ * first one registers the users, so they get the same ids as with the serial
+ * loader, and the second one adds the friends, which are all registered by
+ * then, and the posts. The index sorts the users by username once, the next
+ * time the sorted view is used. Between the parse and the merge, the passwords
+ * of every row are hashed with the full rounds by password_hash_all, so every
+ * user is registered once, with a credential that is never weaker than the
+ * ones of the users who sign up later.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "nodes.h"
+#include "functions.h"
+#include "user_index.h"
+#include "histogram.h"
+#include "password.h"
+#include "csv_load.h"
+#include "metrics.h"
+
+#define FRIEND_COLUMNS 3
+
+// A row parsed by a thread; its fields are the username, the password, the friends and the posts
+typedef struct parsed_row
+{
+    size_t fields;              // position of the username in the chunk's fields
+    unsigned int num_friends;
+    unsigned int num_posts;
+    credential_t credential;    // made from the password before the merge
+    user_t *user;               // set by the merge, NULL if the row adds nothing
+} parsed_row_t;
+
+// A share of the file and the arena its thread parses it into
+typedef struct chunk
+{
+    const char *data;           // the whole file
+    size_t start;               // the first row of the chunk
+    size_t end;                 // the first row of the next chunk
+    char *text;                 // the kept fields, each terminated by '\0'
+    size_t text_size;
+    size_t *fields;             // where every field starts in text
+    size_t num_fields;
+    size_t fields_capacity;
+    parsed_row_t *rows;
+    size_t num_rows;
+    size_t rows_capacity;
+    pthread_t thread;
+    _Bool threaded;             // parsed by a thread of its own, which must be joined
+} chunk_t;
+
+// The time taken by every phase of a load
+typedef struct load_phases
+{
+    double parse_seconds;
+    double hash_seconds;
+    double merge_seconds;
+} load_phases_t;
+
+
+/*
+   Function that returns where the first row of a chunk starts. The first chunk starts
+   after the header line and the others at the first row that begins in their share.
+*/
+static size_t chunk_start(const char *data, size_t size, int chunk, int num_chunks)
+{
+   const char *newline = memchr(data, '\n', size);
+   size_t first_row = newline != NULL ? (size_t)(newline - data) + 1 : size;
+   if (chunk == 0) {
+      return first_row;
+   }
+   if (chunk == num_chunks) {
+      return size;
+   }
+
+   size_t start = size * chunk / num_chunks;
+   if (start == 0) {
+      return first_row;
+   }
+   if (data[start - 1] != '\n') {
+      newline = memchr(&data[start], '\n', size - start);
+      start = newline != NULL ? (size_t)(newline - data) + 1 : size;
+   }
+   return start > first_row ? start : first_row;
+}
+
+
+/*
+   Function that checks if a field holds nothing but spaces.
+*/
+static _Bool is_blank(const char *field, size_t length)
+{
+   for (size_t i = 0; i < length; i++) {
+      if (field[i] != ' ') {
+         return 0;
+      }
+   }
+   return 1;
+}
+
+
+/*
+   Function that copies a field to the end of a chunk's arena.
+*/
+static void keep_field(chunk_t *chunk, const char *field, size_t length)
+{
+   if (chunk->num_fields == chunk->fields_capacity) {
+      chunk->fields_capacity = chunk->fields_capacity == 0 ? 256 : chunk->fields_capacity * 2;
+      chunk->fields = realloc(chunk->fields, chunk->fields_capacity * sizeof(size_t));
+      assert(chunk->fields != NULL);
+   }
+   chunk->fields[chunk->num_fields++] = chunk->text_size;
+   memcpy(&chunk->text[chunk->text_size], field, length);
+   chunk->text_size += length;
+   chunk->text[chunk->text_size++] = '\0';
+}
+
+
+/*
+   Function that returns a field of a chunk's arena.
+*/
+static const char *chunk_field(const chunk_t *chunk, size_t field)
+{
+   return &chunk->text[chunk->fields[field]];
+}
+
+
+/*
+   Function that parses a row, from line to line_end, into a chunk's arena.
+   Rows without a username or with a password that is too long are skipped.
+*/
+static void parse_row(chunk_t *chunk, const char *line, const char *line_end)
+{
+   if (line_end > line && line_end[-1] == '\r') {
+      line_end--;
+   }
+   const char *comma = memchr(line, ',', line_end - line);
+   if (comma == NULL || comma == line) {
+      return;  // an empty or malformed row
+   }
+   const char *password = comma + 1;
+   comma = memchr(password, ',', line_end - password);
+   const char *password_end = comma != NULL ? comma : line_end;
+   if (password_end - password > PASSWORD_MAX_LENGTH) {
+      return;
+   }
+
+   if (chunk->num_rows == chunk->rows_capacity) {
+      chunk->rows_capacity = chunk->rows_capacity == 0 ? 64 : chunk->rows_capacity * 2;
+      chunk->rows = realloc(chunk->rows, chunk->rows_capacity * sizeof(parsed_row_t));
+      assert(chunk->rows != NULL);
+   }
+   parsed_row_t *row = &chunk->rows[chunk->num_rows++];
+   row->fields = chunk->num_fields;
+   row->num_friends = 0;
+   row->num_posts = 0;
+   row->user = NULL;
+   keep_field(chunk, line, password - 1 - line);
+   keep_field(chunk, password, password_end - password);
+
+   // the friend columns come first, every column after them is a post
+   for (int column = 0; comma != NULL; column++) {
+      const char *field = comma + 1;
+      comma = memchr(field, ',', line_end - field);
+      const char *field_end = comma != NULL ? comma : line_end;
+      size_t length = field_end - field;
+      if (is_blank(field, length)) {
+         continue;
+      }
+      if (column < FRIEND_COLUMNS) {
+         // longer names can not be usernames
+         if (length < sizeof(((user_t *)0)->username)) {
+            keep_field(chunk, field, length);
+            row->num_friends++;
+         }
+      } else {
+         keep_field(chunk, field, length);
+         row->num_posts++;
+      }
+   }
+}
+
+
+/*
+   Function that parses every row of a chunk, run by the chunk's thread.
+*/
+static void *parse_chunk(void *argument)
+{
+   chunk_t *chunk = argument;
+
+   // the kept fields are never longer than their rows, a terminator replaces every separator
+   chunk->text = malloc(chunk->end - chunk->start + 1);
+   assert(chunk->text != NULL);
+
+   const char *line = &chunk->data[chunk->start];
+   const char *chunk_end = &chunk->data[chunk->end];
+   while (line < chunk_end) {
+      const char *newline = memchr(line, '\n', chunk_end - line);
+      const char *line_end = newline != NULL ? newline : chunk_end;
+      parse_row(chunk, line, line_end);
+      line = line_end + 1;
+   }
+   return NULL;
+}
+
+
+/*
+   Function that hashes the passwords of every parsed row with a number of threads.
+*/
+static void hash_chunks(chunk_t *chunks, int num_chunks, int threads)
+{
+   size_t count = 0;
+   for (int i = 0; i < num_chunks; i++) {
+      count += chunks[i].num_rows;
+   }
+   password_job_t *jobs = malloc((count > 0 ? count : 1) * sizeof(password_job_t));
+   assert(jobs != NULL);
+
+   size_t job = 0;
+   for (int i = 0; i < num_chunks; i++) {
+      for (size_t j = 0; j < chunks[i].num_rows; j++, job++) {
+         parsed_row_t *row = &chunks[i].rows[j];
+         jobs[job].credential = &row->credential;
+         jobs[job].password = chunk_field(&chunks[i], row->fields + 1);
+      }
+   }
+   password_hash_all(jobs, count, threads);
+   free(jobs);
+}
+
+
+/*
+   Function that merges the parsed rows into the users, in the order of the file.
+   Return the head of the users list.
+*/
+static user_t *merge_chunks(chunk_t *chunks, int num_chunks, load_phases_t *phases)
+{
+   user_t *users = NULL;
+   unsigned long long start = histogram_now_ns();
+   for (int i = 0; i < num_chunks; i++) {
+      for (size_t j = 0; j < chunks[i].num_rows; j++) {
+         parsed_row_t *row = &chunks[i].rows[j];
+         const char *username = chunk_field(&chunks[i], row->fields);
+         row->user = insert_user_credential(&users, username, &row->credential);
+         if (row->user == NULL) {
+            // the username appeared on an earlier row, or is too long and the row adds nothing
+            row->user = index_find_user(username);
+         }
+      }
+   }
+
+   // every user is registered, the friends can be linked as their rows come
+   for (int i = 0; i < num_chunks; i++) {
+      for (size_t j = 0; j < chunks[i].num_rows; j++) {
+         const parsed_row_t *row = &chunks[i].rows[j];
+         if (row->user == NULL) {
+            continue;
+         }
+         size_t field = row->fields + 2;
+         for (unsigned int k = 0; k < row->num_friends; k++, field++) {
+            const user_t *friend_user = index_find_user(chunk_field(&chunks[i], field));
+            if (friend_user != NULL) {
+               add_friend_id(row->user, friend_user->id);
+            }
+         }
+         for (unsigned int k = 0; k < row->num_posts; k++, field++) {
+            add_loaded_post(row->user, chunk_field(&chunks[i], field));
+         }
+      }
+   }
+   phases->merge_seconds = (histogram_now_ns() - start) / 1e9;
+   return users;
+}
+
+
+/*
+   Function that loads the users of a file mapped in memory with a chunk per thread.
+   Return the head of the users list.
+*/
+static user_t *load_mapped(const char *data, size_t size, int threads, size_t *rows, load_phases_t *phases)
+{
+   unsigned long long start = histogram_now_ns();
+   chunk_t *chunks = calloc(threads, sizeof(chunk_t));
+   assert(chunks != NULL);
+   for (int i = 0; i < threads; i++) {
+      chunks[i].data = data;
+      chunks[i].start = chunk_start(data, size, i, threads);
+      chunks[i].end = chunk_start(data, size, i + 1, threads);
+   }
+   for (int i = 1; i < threads; i++) {
+      chunks[i].threaded = pthread_create(&chunks[i].thread, NULL, parse_chunk, &chunks[i]) == 0;
+      if (!chunks[i].threaded) {
+         // parse the chunk on this thread instead
+         parse_chunk(&chunks[i]);
+      }
+   }
+   parse_chunk(&chunks[0]);
+   for (int i = 1; i < threads; i++) {
+      if (chunks[i].threaded) {
+         pthread_join(chunks[i].thread, NULL);
+      }
+   }
+   phases->parse_seconds = (histogram_now_ns() - start) / 1e9;
+
+   start = histogram_now_ns();
+   hash_chunks(chunks, threads, threads);
+   phases->hash_seconds = (histogram_now_ns() - start) / 1e9;
+
+   user_t *users = merge_chunks(chunks, threads, phases);
+
+   *rows = 0;
+   for (int i = 0; i < threads; i++) {
+      *rows += chunks[i].num_rows;
+      free(chunks[i].text);
+      free(chunks[i].fields);
+      free(chunks[i].rows);
+   }
+   free(chunks);
+   return users;
+}
+
+
+/*
+   Function that maps a file in memory and loads its users.
+   Return 0 on success and 1 if the file can not be mapped.
+*/
+static int load_file(FILE *file, int threads, user_t **users, load_stats_t *stats)
+{
+   struct stat file_stat;
+   if (fstat(fileno(file), &file_stat) != 0 || !S_ISREG(file_stat.st_mode)) {
+      return 1;
+   }
+
+   unsigned long long start = histogram_now_ns();
+   size_t size = file_stat.st_size;
+   size_t rows = 0;
+   load_phases_t phases = { 0, 0, 0 };
+   if (size == 0) {
+      *users = NULL;
+   } else {
+      char *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+      if (data == MAP_FAILED) {
+         return 1;
+      }
+      madvise(data, size, MADV_SEQUENTIAL);
+      METRICS_SCOPE(OP_LOAD_CSV);
+      *users = load_mapped(data, size, threads < 1 ? 1 : threads, &rows, &phases);
+      munmap(data, size);
+   }
+
+   if (stats != NULL) {
+      stats->rows = rows;
+      stats->bytes = size;
+      stats->seconds = (histogram_now_ns() - start) / 1e9;
+      stats->parse_seconds = phases.parse_seconds;
+      stats->hash_seconds = phases.hash_seconds;
+      stats->merge_seconds = phases.merge_seconds;
+   }
+   return 0;
+}
+
+
+/*
+   Function that reads the users of a CSV file with a number of threads. Files that can not be
+   mapped in memory, such as pipes, are read by read_CSV_and_create_users instead.
+   If stats is not NULL, it receives the number of rows and bytes read, the load time
+   and the time of each phase of the load.
+*/
+user_t *read_CSV_parallel(FILE *file, int threads, load_stats_t *stats)
+{
+   user_t *users;
+   if (load_file(file, threads, &users, stats) != 0) {
+      return read_CSV_and_create_users(file, stats);
+   }
+   return users;
+}
+
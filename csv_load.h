@@ -0,0 +1,30 @@
+/**
+ * @file csv_load.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the parallel CSV loader. The file is mapped in
+ * memory and split on row boundaries into one chunk per thread. Every thread
+ * parses its chunk into an arena of its own, then the rows of all the chunks
+ * are merged into the users in the order of the file, so the users, friends
+ * and posts are the same as with read_CSV_and_create_users.
+ */
+
+#ifndef __A2_CSV_LOAD_H__
+#define __A2_CSV_LOAD_H__
+#include <stdio.h>
+#include <stddef.h>
+#include "nodes.h"
+#include "functions.h"
+
+/*
+   Function that reads the users of a CSV file with a number of threads. Files that can not be
+   mapped in memory, such as pipes, are read by read_CSV_and_create_users instead.
+   If stats is not NULL, it receives the number of rows and bytes read, the load time
+   and the time of each phase of the load.
+*/
+user_t *read_CSV_parallel(FILE *file, int threads, load_stats_t *stats);
+
+
+#endif
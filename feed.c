@@ -0,0 +1,331 @@
+/**
+ * @file feed.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the news feed. Every user has a
+ * timeline of their friends' latest posts, which add_post fills
+ * by pushing each new post to the author's friends (fan-out on write).
+ * Authors with more than FANOUT_LIMIT friends are not pushed; their posts
+ * are merged in when a feed is read (fan-out on read).
+ *
+ * A timeline is built the first time the feed is read, and rebuilt after
+ * the user gets a new friend. Deleted posts and posts of former friends are
+ * skipped when the feed is read.
+ *
+ * The feed can also be read without timelines, by merging the friends' post
+ * lists (which are sorted newest first) with a heap, see feed_merge_page.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "nodes.h"
+#include "functions.h"
+#include "user_index.h"
+#include "friend_set.h"
+#include "post_list.h"
+#include "feed.h"
+
+// A friend's list of posts being merged, with its newest post not returned yet
+typedef struct heap_entry
+{
+    post_t *post;
+    post_cursor_t cursor;
+} heap_entry_t;
+
+
+/*
+   Function that adds a post to a timeline, dropping the oldest post when it is full.
+*/
+static void timeline_push(timeline_t *timeline, const post_t *post)
+{
+   timeline_entry_t entry = { post->id, post->author };
+   if (timeline->count < TIMELINE_CAPACITY) {
+      timeline->entries[(timeline->start + timeline->count) % TIMELINE_CAPACITY] = entry;
+      timeline->count++;
+   } else {
+      timeline->entries[timeline->start] = entry;
+      timeline->start = (timeline->start + 1) % TIMELINE_CAPACITY;
+   }
+}
+
+
+/*
+   Function that compares two timeline entries by post id, used to sort a timeline.
+*/
+static int compare_entries(const void *a, const void *b)
+{
+   unsigned long first = ((const timeline_entry_t *)a)->post_id;
+   unsigned long second = ((const timeline_entry_t *)b)->post_id;
+   return (first > second) - (first < second);
+}
+
+
+/*
+   Function that fills a user's timeline with the latest posts of the friends that fan out on write.
+*/
+static void timeline_build(user_t *user)
+{
+   if (user->timeline == NULL) {
+      user->timeline = malloc(sizeof(timeline_t));
+      assert(user->timeline != NULL);
+      user->timeline->entries = malloc(TIMELINE_CAPACITY * sizeof(timeline_entry_t));
+      assert(user->timeline->entries != NULL);
+   }
+
+   // no friend can have more than TIMELINE_CAPACITY posts in the timeline
+   size_t total = 0;
+   for (unsigned int i = 0; i < user->friends.count; i++) {
+      user_t *friend_user = index_user_by_id(user->friends.ids[i]);
+      if (friend_user->friends.count > FANOUT_LIMIT) {
+         continue;
+      }
+      total += friend_user->posts.count < TIMELINE_CAPACITY ? friend_user->posts.count : TIMELINE_CAPACITY;
+   }
+
+   timeline_entry_t *entries = malloc((total + 1) * sizeof(timeline_entry_t));
+   assert(entries != NULL);
+   size_t num_entries = 0;
+   for (unsigned int i = 0; i < user->friends.count; i++) {
+      user_t *friend_user = index_user_by_id(user->friends.ids[i]);
+      if (friend_user->friends.count > FANOUT_LIMIT) {
+         continue;
+      }
+      size_t count = 0;
+      post_cursor_t cursor;
+      for (post_t *current = post_list_seek(&friend_user->posts, 0, &cursor); current != NULL && count < TIMELINE_CAPACITY;
+           current = post_list_next(&cursor)) {
+         entries[num_entries].post_id = current->id;
+         entries[num_entries].author = friend_user->id;
+         num_entries++;
+         count++;
+      }
+   }
+
+   // keep the newest posts, oldest first
+   qsort(entries, num_entries, sizeof(timeline_entry_t), compare_entries);
+   size_t first = num_entries > TIMELINE_CAPACITY ? num_entries - TIMELINE_CAPACITY : 0;
+   timeline_t *timeline = user->timeline;
+   timeline->start = 0;
+   timeline->count = num_entries - first;
+   memcpy(timeline->entries, &entries[first], timeline->count * sizeof(timeline_entry_t));
+   timeline->built = 1;
+   free(entries);
+}
+
+
+/*
+   Function that pushes a new post to the timelines of its author's friends.
+   Only the timelines that were already built are updated.
+*/
+void feed_fan_out(user_t *author, post_t *post)
+{
+   if (author->friends.count > FANOUT_LIMIT) {
+      return; // read by the friends when they read their feed
+   }
+
+   for (unsigned int i = 0; i < author->friends.count; i++) {
+      user_t *friend_user = index_user_by_id(author->friends.ids[i]);
+      if (friend_user->timeline != NULL && friend_user->timeline->built) {
+         timeline_push(friend_user->timeline, post);
+      }
+   }
+}
+
+
+/*
+   Function that marks a user's timeline as out of date, it is rebuilt when the feed is next read.
+*/
+void feed_invalidate(user_t *user)
+{
+   if (user->timeline != NULL) {
+      user->timeline->built = 0;
+   }
+}
+
+
+/*
+   Function that moves a list up the max-heap until its parent's post is newer.
+*/
+static void heap_sift_up(heap_entry_t *heap, size_t position)
+{
+   while (position > 0) {
+      size_t parent = (position - 1) / 2;
+      if (heap[parent].post->id >= heap[position].post->id) {
+         break;
+      }
+      heap_entry_t swap = heap[parent];
+      heap[parent] = heap[position];
+      heap[position] = swap;
+      position = parent;
+   }
+}
+
+
+/*
+   Function that moves a list down the max-heap until the posts of both its children are older.
+*/
+static void heap_sift_down(heap_entry_t *heap, size_t size, size_t position)
+{
+   while (1) {
+      size_t newest = position;
+      size_t left = 2 * position + 1;
+      size_t right = left + 1;
+      if (left < size && heap[left].post->id > heap[newest].post->id) {
+         newest = left;
+      }
+      if (right < size && heap[right].post->id > heap[newest].post->id) {
+         newest = right;
+      }
+      if (newest == position) {
+         return;
+      }
+      heap_entry_t swap = heap[newest];
+      heap[newest] = heap[position];
+      heap[position] = swap;
+      position = newest;
+   }
+}
+
+
+/*
+   Function that replaces the newest post of the heap by the next post of the same author.
+   Return the post that was removed from the heap.
+*/
+static post_t *heap_pop(heap_entry_t *heap, size_t *size)
+{
+   post_t *newest = heap[0].post;
+   heap[0].post = post_list_next(&heap[0].cursor);
+   if (heap[0].post == NULL) {
+      heap[0] = heap[--(*size)];
+   }
+   if (*size > 0) {
+      heap_sift_down(heap, *size, 0);
+   }
+   return newest;
+}
+
+
+/*
+   Function that adds a list to the heap from its first post that is older than the cursor.
+*/
+static void heap_push_list(heap_entry_t *heap, size_t *size, const post_list_t *posts, unsigned long cursor)
+{
+   heap[*size].post = post_list_seek_before(posts, cursor, &heap[*size].cursor);
+   if (heap[*size].post != NULL) {
+      heap_sift_up(heap, *size);
+      (*size)++;
+   }
+}
+
+
+/*
+   Function that reads a page of a user's news feed, newest post first.
+   Only posts older than the cursor are returned; a cursor of 0 starts at the newest post.
+   Up to limit posts are stored in posts. Return the number of posts; the id of the
+   last one is the cursor of the next page.
+*/
+size_t feed_page(user_t *user, unsigned long cursor, post_t **posts, size_t limit)
+{
+   if (user->timeline == NULL || !user->timeline->built) {
+      timeline_build(user);
+   }
+   timeline_t *timeline = user->timeline;
+
+   // the posts of friends who do not fan out on write are merged from their own lists
+   heap_entry_t *heap = malloc((user->friends.count + 1) * sizeof(heap_entry_t));
+   assert(heap != NULL);
+   size_t heap_size = 0;
+   for (unsigned int i = 0; i < user->friends.count; i++) {
+      user_t *friend_user = index_user_by_id(user->friends.ids[i]);
+      if (friend_user->friends.count > FANOUT_LIMIT) {
+         heap_push_list(heap, &heap_size, &friend_user->posts, cursor);
+      }
+   }
+
+   // skip the timeline's posts that are not older than the cursor
+   unsigned int position = timeline->count;
+   while (position > 0 && cursor != 0
+          && timeline->entries[(timeline->start + position - 1) % TIMELINE_CAPACITY].post_id >= cursor) {
+      position--;
+   }
+
+   size_t count = 0;
+   unsigned long last_id = 0;
+   while (count < limit) {
+      // the newest post of the timeline that is still available
+      post_t *from_timeline = NULL;
+      while (position > 0 && from_timeline == NULL) {
+         const timeline_entry_t *entry = &timeline->entries[(timeline->start + position - 1) % TIMELINE_CAPACITY];
+         post_t *post = NULL;
+         if (friend_set_contains(&user->friends, entry->author)) {
+            post = find_post(entry->post_id);
+         }
+         if (post != NULL) {
+            from_timeline = post;
+         } else {
+            position--;
+         }
+      }
+
+      // the newest post among the timeline and the lists of the friends who fan out on read
+      post_t *newest;
+      if (heap_size > 0 && (from_timeline == NULL || heap[0].post->id > from_timeline->id)) {
+         newest = heap_pop(heap, &heap_size);
+      } else if (from_timeline != NULL) {
+         newest = from_timeline;
+         position--;
+      } else {
+         break;
+      }
+
+      // a post can be in both places if its author's number of friends crossed FANOUT_LIMIT
+      if (newest->id != last_id) {
+         posts[count++] = newest;
+         last_id = newest->id;
+      }
+   }
+
+   free(heap);
+   return count;
+}
+
+
+/*
+   Function that reads a page of a user's news feed by merging the post lists of all the
+   user's friends, without using the timeline. The lists are merged with a max-heap
+   holding the newest remaining post of every friend, and the merge stops after limit posts.
+   The cursor and the result are the same as feed_page's.
+*/
+size_t feed_merge_page(user_t *user, unsigned long cursor, post_t **posts, size_t limit)
+{
+   heap_entry_t *heap = malloc((user->friends.count + 1) * sizeof(heap_entry_t));
+   assert(heap != NULL);
+   size_t heap_size = 0;
+   for (unsigned int i = 0; i < user->friends.count; i++) {
+      heap_push_list(heap, &heap_size, &index_user_by_id(user->friends.ids[i])->posts, cursor);
+   }
+
+   size_t count = 0;
+   while (count < limit && heap_size > 0) {
+      posts[count++] = heap_pop(heap, &heap_size);
+   }
+
+   free(heap);
+   return count;
+}
+
+
+/*
+   Function that frees a user's timeline.
+*/
+void feed_free(user_t *user)
+{
+   if (user->timeline != NULL) {
+      free(user->timeline->entries);
+      free(user->timeline);
+      user->timeline = NULL;
+   }
+}
@@ -0,0 +1,56 @@
+/**
+ * @file feed.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the news feed: the posts of a user's friends,
+ * newest first, read one page at a time.
+ */
+
+#ifndef __A2_FEED_H__
+#define __A2_FEED_H__
+#include <stddef.h>
+#include "nodes.h"
+
+// Number of posts kept in a user's timeline
+#define TIMELINE_CAPACITY 512
+
+// Users with more friends than this do not push their posts to their friends' timelines,
+// their posts are merged into the feed when it is read instead
+#define FANOUT_LIMIT 1000
+
+/*
+   Function that pushes a new post to the timelines of its author's friends.
+   Only the timelines that were already built are updated.
+*/
+void feed_fan_out(user_t *author, post_t *post);
+
+/*
+   Function that marks a user's timeline as out of date, it is rebuilt when the feed is next read.
+*/
+void feed_invalidate(user_t *user);
+
+/*
+   Function that reads a page of a user's news feed, newest post first.
+   Only posts older than the cursor are returned; a cursor of 0 starts at the newest post.
+   Up to limit posts are stored in posts. Return the number of posts; the id of the
+   last one is the cursor of the next page.
+*/
+size_t feed_page(user_t *user, unsigned long cursor, post_t **posts, size_t limit);
+
+/*
+   Function that reads a page of a user's news feed by merging the post lists of all the
+   user's friends, without using the timeline. The lists are merged with a max-heap
+   holding the newest remaining post of every friend, and the merge stops after limit posts.
+   The cursor and the result are the same as feed_page's.
+*/
+size_t feed_merge_page(user_t *user, unsigned long cursor, post_t **posts, size_t limit);
+
+/*
+   Function that frees a user's timeline.
+*/
+void feed_free(user_t *user);
+
+
+#endif
@@ -0,0 +1,198 @@
+/**
+ * @file friend_set.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the friend sets. The ids are kept
+ * in a sorted array, so membership is a binary search and the array can be
+ * intersected with another user's friends. Once a user has HASH_THRESHOLD
+ * friends, a hash set of the same ids is added so that membership checks of
+ * popular users take constant time.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "nodes.h"
+#include "friend_set.h"
+#include "metrics.h"
+
+#define INITIAL_CAPACITY 4
+#define HASH_THRESHOLD 64
+
+
+/*
+   Function that returns the first slot of an id in the hash set.
+*/
+static unsigned int home_slot(const friend_set_t *set, unsigned int id)
+{
+   return (id * 2654435761u) & (set->slot_count - 1);
+}
+
+
+/*
+   Function that adds an id to the hash set, which must have a free slot.
+*/
+static void hash_insert(friend_set_t *set, unsigned int id)
+{
+   unsigned int mask = set->slot_count - 1;
+   unsigned int i = home_slot(set, id);
+   while (set->slots[i] != 0) {
+      i = (i + 1) & mask;
+   }
+   set->slots[i] = id + 1;
+}
+
+
+/*
+   Function that removes an id from the hash set, moving back the following ids
+   of the probe sequence so that no tombstones are needed.
+*/
+static void hash_remove(friend_set_t *set, unsigned int id)
+{
+   unsigned int mask = set->slot_count - 1;
+   unsigned int i = home_slot(set, id);
+   while (set->slots[i] != id + 1) {
+      i = (i + 1) & mask;
+   }
+
+   unsigned int hole = i;
+   for (i = (i + 1) & mask; set->slots[i] != 0; i = (i + 1) & mask) {
+      unsigned int home = home_slot(set, set->slots[i] - 1);
+      // the id can fill the hole if the hole lies between its home slot and its current slot
+      if (((i - home) & mask) >= ((i - hole) & mask)) {
+         set->slots[hole] = set->slots[i];
+         hole = i;
+      }
+   }
+   set->slots[hole] = 0;
+}
+
+
+/*
+   Function that rebuilds the hash set from the sorted ids with room for twice as many ids.
+*/
+static void hash_rebuild(friend_set_t *set)
+{
+   unsigned int slot_count = 1;
+   while (slot_count < set->count * 2) {
+      slot_count *= 2;
+   }
+
+   free(set->slots);
+   METRICS_GAUGE_ADD(GAUGE_FRIEND_SET_BYTES, ((long)slot_count - set->slot_count) * (long)sizeof(unsigned int));
+   set->slot_count = slot_count;
+   set->slots = calloc(slot_count, sizeof(unsigned int));
+   assert(set->slots != NULL);
+   for (unsigned int i = 0; i < set->count; i++) {
+      hash_insert(set, set->ids[i]);
+   }
+}
+
+
+/*
+   Function that returns the position of the first id not smaller than the given id.
+*/
+static unsigned int lower_bound(const friend_set_t *set, unsigned int id)
+{
+   unsigned int low = 0;
+   unsigned int high = set->count;
+   while (low < high) {
+      unsigned int middle = low + (high - low) / 2;
+      if (set->ids[middle] < id) {
+         low = middle + 1;
+      } else {
+         high = middle;
+      }
+   }
+   return low;
+}
+
+
+/*
+   Function that checks if an id is in the set.
+   Return true if the id was found and false otherwise.
+*/
+_Bool friend_set_contains(const friend_set_t *set, unsigned int id)
+{
+   if (set->slots != NULL) {
+      unsigned int mask = set->slot_count - 1;
+      for (unsigned int i = home_slot(set, id); set->slots[i] != 0; i = (i + 1) & mask) {
+         if (set->slots[i] == id + 1) {
+            return 1;
+         }
+      }
+      return 0;
+   }
+
+   unsigned int position = lower_bound(set, id);
+   return position < set->count && set->ids[position] == id;
+}
+
+
+/*
+   Function that adds an id to the set, keeping the ids sorted.
+   Return true if the id was added and false if it was already in the set.
+*/
+_Bool friend_set_insert(friend_set_t *set, unsigned int id)
+{
+   unsigned int position = lower_bound(set, id);
+   if (position < set->count && set->ids[position] == id) {
+      return 0;
+   }
+
+   if (set->count == set->capacity) {
+      unsigned int capacity = set->capacity == 0 ? INITIAL_CAPACITY : set->capacity * 2;
+      METRICS_GAUGE_ADD(GAUGE_FRIEND_SET_BYTES, (long)(capacity - set->capacity) * (long)sizeof(unsigned int));
+      set->capacity = capacity;
+      set->ids = realloc(set->ids, set->capacity * sizeof(unsigned int));
+      assert(set->ids != NULL);
+   }
+   memmove(&set->ids[position + 1], &set->ids[position], (set->count - position) * sizeof(unsigned int));
+   set->ids[position] = id;
+   set->count++;
+
+   // keep the hash set at most half full
+   if (set->slots != NULL && set->count * 2 <= set->slot_count) {
+      hash_insert(set, id);
+   } else if (set->count >= HASH_THRESHOLD) {
+      hash_rebuild(set);
+   }
+   return 1;
+}
+
+
+/*
+   Function that removes an id from the set.
+   Return true if the id was removed and false if it was not in the set.
+*/
+_Bool friend_set_remove(friend_set_t *set, unsigned int id)
+{
+   unsigned int position = lower_bound(set, id);
+   if (position == set->count || set->ids[position] != id) {
+      return 0;
+   }
+
+   memmove(&set->ids[position], &set->ids[position + 1], (set->count - position - 1) * sizeof(unsigned int));
+   set->count--;
+
+   if (set->slots != NULL) {
+      hash_remove(set, id);
+   }
+   return 1;
+}
+
+
+/*
+   Function that frees the memory of the set and leaves it empty.
+*/
+void friend_set_free(friend_set_t *set)
+{
+   METRICS_GAUGE_ADD(GAUGE_FRIEND_SET_BYTES, -(long)(set->capacity + set->slot_count) * (long)sizeof(unsigned int));
+   free(set->ids);
+   free(set->slots);
+   memset(set, 0, sizeof(friend_set_t));
+}
+
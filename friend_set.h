@@ -0,0 +1,42 @@
+/**
+ * @file friend_set.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the functions that manage a user's set of friend
+ * ids (see friend_set_t in nodes.h). The user index gives every username a
+ * dense id when the user is registered, so a friendship is stored as two ids
+ * of 4 bytes and compared as integers; usernames are only looked up at the
+ * edges, when a command or a file names a user.
+ */
+
+#ifndef __A2_FRIEND_SET_H__
+#define __A2_FRIEND_SET_H__
+#include "nodes.h"
+
+/*
+   Function that checks if an id is in the set.
+   Return true if the id was found and false otherwise.
+*/
+_Bool friend_set_contains(const friend_set_t *set, unsigned int id);
+
+/*
+   Function that adds an id to the set, keeping the ids sorted.
+   Return true if the id was added and false if it was already in the set.
+*/
+_Bool friend_set_insert(friend_set_t *set, unsigned int id);
+
+/*
+   Function that removes an id from the set.
+   Return true if the id was removed and false if it was not in the set.
+*/
+_Bool friend_set_remove(friend_set_t *set, unsigned int id);
+
+/*
+   Function that frees the memory of the set and leaves it empty.
+*/
+void friend_set_free(friend_set_t *set);
+
+
+#endif
@@ -12,66 +12,220 @@
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#include <time.h>
+#include <sys/types.h>
+#include <pthread.h>
 #include "nodes.h"
 #include "functions.h"
+#include "user_index.h"
+#include "pool.h"
+#include "text_arena.h"
+#include "friend_set.h"
+#include "feed.h"
+#include "wal.h"
+#include "checkpoint.h"
+#include "search.h"
+#include "trending.h"
+#include "histogram.h"
+#include "user_table.h"
+#include "password.h"
+#include "output.h"
+#include "metrics.h"
+#include "post_list.h"
 
-#define NUM_FEATURES 6
+#define NUM_FEATURES 10
 #define PATTERN_LENGTH 50
+#define FEED_PAGE_SIZE 10
+#define SEARCH_RESULTS 20
+#define TRENDING_SIZE 10
+#define POSTS_PAGE_LINES 20
+#define POSTS_PER_PAGE 10
+#define SUGGESTIONS 5
+#define LOAD_BATCH_ROWS 1024
+
+// the post table is kept in segments that never move, so posts can be found while others are added
+#define POST_SEGMENT_BITS 16
+#define POST_SEGMENT_SIZE (1ul << POST_SEGMENT_BITS)
+#define MAX_POST_SEGMENTS (1ul << 16)
+
+// protects the pools, the text arena, the users list head and adding to the post table,
+// which are shared by the users of every shard of the index
+static pthread_mutex_t alloc_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// every user and post node is allocated from these pools
+static pool_t user_pool = POOL_INITIALIZER(sizeof(user_t));
+static pool_t post_pool = POOL_INITIALIZER(sizeof(post_t));
+
+// posts by id, a deleted post's entry is NULL; post ids start at 1
+static post_t **post_table[MAX_POST_SEGMENTS];
+static unsigned long next_post_id = 1;
+
 
 /*
-   Function that creates a new user and adds it to a linked list, sorted in ascending order, at
-   the proper sorted location. Returns the head of the list.
+   Function that returns the entry of a post id in the post table.
 */
-user_t *add_user(user_t *users, const char *username, const char *password)
+static post_t **post_entry(unsigned long id)
 {
+   return &post_table[id >> POST_SEGMENT_BITS][id & (POST_SEGMENT_SIZE - 1)];
+}
+
+/*
+   Function that creates a new user, adds it at the beginning of the linked list and registers
+   it in the user index. Return the new user, or NULL if the username is already taken
+   or the username or password is too long.
+*/
+user_t *insert_user(user_t **users, const char *username, const char *password)
+{
+   if (strlen(password) > PASSWORD_MAX_LENGTH) {
+      return NULL;
+   }
+   credential_t credential;
+   password_hash(password, &credential);
+   return insert_user_credential(users, username, &credential);
+}
+
+
+/*
+   Function that creates a new user with a credential that is already made, as insert_user does.
+   Return the new user, or NULL if the username is already taken or too long.
+*/
+user_t *insert_user_credential(user_t **users, const char *username, const credential_t *credential)
+{
+   METRICS_SCOPE(OP_ADD_USER);
+   if (strlen(username) >= sizeof(((user_t *)0)->username)) {
+      return NULL; // does not fit in the user's node
+   }
+
    // create a new user node
-   user_t *new_user = malloc(sizeof(user_t));
+   pthread_mutex_lock(&alloc_lock);
+   user_t *new_user = pool_alloc(&user_pool);
+   pthread_mutex_unlock(&alloc_lock);
    assert(new_user != NULL);
-   new_user->posts = NULL;
-   new_user->friends = NULL;
+   memset(&new_user->posts, 0, sizeof(post_list_t));
+   memset(&new_user->friends, 0, sizeof(friend_set_t));
+   new_user->timeline = NULL;
+   new_user->checkpoint_epoch = 0;
    strcpy(new_user->username, username);
-   strcpy(new_user->password, password);
-   new_user->next = NULL;
+   new_user->credential = *credential;
 
-   // if the linked list is empty or the new user should be added at the beginning
-   if (users == NULL || strcmp(username, users->username) < 0){
-      new_user->next = users;
-      return new_user;
+   // usernames are unique, do not register the same user twice
+   if (!index_insert_user(new_user)) {
+      pthread_mutex_lock(&alloc_lock);
+      pool_free(&user_pool, new_user);
+      pthread_mutex_unlock(&alloc_lock);
+      return NULL;
    }
 
-   // traverse the list to find the correct position for the new user (ascending order)
-   user_t *current = users;
-   while (current->next != NULL && strcmp(username, current->next->username) >= 0){
-      current = current->next;
-   }
+   // the list only owns the nodes, so the new user is added at the beginning
+   pthread_mutex_lock(&alloc_lock);
+   new_user->next = *users;
+   *users = new_user;
+   pthread_mutex_unlock(&alloc_lock);
+   METRICS_GAUGE_ADD(GAUGE_USERS, 1);
 
-   // add new user in the middle or at the end
-   new_user->next = current->next;
-   current->next = new_user;
-   
+   char text[CREDENTIAL_TEXT_SIZE];
+   credential_encode(credential, text);
+   wal_log(WAL_ADD_USER, username, text, 0, 0);
+   return new_user;
+}
+
+
+/*
+   Function that creates a new user and adds it to the linked list and to the user index.
+   The index keeps the users sorted in ascending order for the listings. Returns the head of the list.
+*/
+user_t *add_user(user_t *users, const char *username, const char *password)
+{
+   insert_user(&users, username, password);
    return users;
 }
 
 
+/*
+   Function that changes a user's password.
+   Return true if the password was changed and false if it is too long.
+*/
+_Bool set_password(user_t *user, const char *password)
+{
+   if (strlen(password) > PASSWORD_MAX_LENGTH) {
+      return 0;
+   }
+   credential_t credential;
+   password_hash(password, &credential);
+   set_credential(user, &credential);
+   return 1;
+}
+
+
+/*
+   Function that replaces a user's credential with one that is already made.
+*/
+void set_credential(user_t *user, const credential_t *credential)
+{
+   char text[CREDENTIAL_TEXT_SIZE];
+   checkpoint_preserve(user);
+   user->credential = *credential;
+   credential_encode(credential, text);
+   wal_log(WAL_PASSWORD, user->username, text, 0, 0);
+}
+
+
+/*
+   Function that checks a user's password.
+   Return true if the password is the user's and false otherwise.
+*/
+_Bool authenticate(const user_t *user, const char *password)
+{
+   return password_verify(password, &user->credential);
+}
+
+
+/*
+   Function that prints the usernames that start like a username that was not found: with the
+   whole name, or else with its longest beginning, down to half of it, that some usernames start with.
+*/
+static void print_suggestions(const char *username)
+{
+   user_t *matches[SUGGESTIONS];
+   char prefix[30];
+   size_t length = strlen(username) < sizeof(prefix) ? strlen(username) : sizeof(prefix) - 1;
+   size_t shortest = (length + 1) / 2;
+   size_t found = 0;
+   for (; length >= shortest && length > 0 && found == 0; length--) {
+      memcpy(prefix, username, length);
+      prefix[length] = '\0';
+      found = index_complete(prefix, matches, SUGGESTIONS);
+   }
+   if (found == 0) {
+      return;
+   }
+
+   printf("\n  Did you mean: ");
+   for (size_t i = 0; i < found; i++) {
+      printf("%s%s", i > 0 ? ", " : "", matches[i]->username);
+   }
+   printf("?");
+}
+
+
 /*
    Function that searches if the user is available in the database
-   Return a pointer to the user if found and NULL if not found.
+   Return a pointer to the user if found and NULL if not found, after suggesting usernames
+   that start like the one given.
 */
 user_t *find_user(user_t *users, const char *username) 
 {
-   user_t *current = users;
-   while (current != NULL)
+   METRICS_SCOPE(OP_FIND_USER);
+   user_t *found = users != NULL ? index_find_user(username) : NULL;
+   if (found != NULL)
    {
-      if (strcmp(current->username, username) == 0)
-      {
-         // user found
-         return current;
-      }
-      current = current->next;
+      // user found
+      return found;
    }
    // user not found
    print_pattern(PATTERN_LENGTH, '-');
    printf("                 User not found.");
+   print_suggestions(username);
    print_pattern(PATTERN_LENGTH, '-');
    return NULL;
 
@@ -79,238 +233,575 @@ user_t *find_user(user_t *users, const char *username)
 
 
 /*
-   Function that creates a new friend's node.
-   Return the newly created node.
+   Function that links two users as friends. Friendship goes both ways, so each
+   user's id is added to the other user's friend set.
+   Return true if the friend was added and false if the friend is not a registered
+   user, is the user itself, or is already a friend.
 */
-friend_t *create_friend(const char *username)
+_Bool add_friend(user_t *user, const char *friend)
 {
-   friend_t *new_friend = malloc(sizeof(post_t));
-   assert(new_friend != NULL);
-   strcpy(new_friend->username, username);
-   new_friend->next = NULL;
-   return new_friend;
+   user_t *friend_user = index_find_user(friend);
+   return friend_user != NULL && add_friend_id(user, friend_user->id);
 }
 
 
 /*
-   Function that links a friend to a user. The friend's name is added into
-   a linked list, sorted in ascending.
+   Function that links two users as friends, as add_friend does, with the friend given by user id.
+   Return true if the friend was added and false if there is no such user, it is the user
+   itself, or it is already a friend.
 */
-void add_friend(user_t *user, const char *friend)
+_Bool add_friend_id(user_t *user, unsigned int friend_id)
 {
-   friend_t *new_friend = create_friend(friend);
+   METRICS_SCOPE(OP_ADD_FRIEND);
+   user_t *friend_user = index_user_by_id(friend_id);
+   if (friend_user == NULL || friend_user == user) {
+      return 0;
+   }
 
-   if (user->friends == NULL || strcmp(friend, user->friends->username) < 0) {
-      new_friend->next = user->friends;
-      user->friends = new_friend;
-   } else {
-      friend_t *current = user->friends;
-      while (current->next != NULL && strcmp(friend, current->next->username) > 0) {
-         current = current->next;
-      }
+   if (friend_set_contains(&user->friends, friend_user->id)) {
+      return 0; // already friends
+   }
+   checkpoint_preserve(user);
+   checkpoint_preserve(friend_user);
+   friend_set_insert(&user->friends, friend_user->id);
+   friend_set_insert(&friend_user->friends, user->id);
+
+   // the new friend's posts are not in the timelines yet
+   feed_invalidate(user);
+   feed_invalidate(friend_user);
+   METRICS_GAUGE_ADD(GAUGE_FRIENDSHIPS, 1);
+   wal_log(WAL_FRIEND, user->username, friend_user->username, 0, 0);
+   return 1;
+}
 
-      new_friend->next = current->next;
-      current->next = new_friend;
+
+/*
+   Function that checks if two users are friends.
+   Return true if they are friends and false otherwise.
+*/
+_Bool are_friends(user_t *user, user_t *other)
+{
+   // look in the smaller set, the larger one is more likely to be hashed anyway
+   if (user->friends.count > other->friends.count) {
+      user_t *swap = user;
+      user = other;
+      other = swap;
    }
+   return friend_set_contains(&user->friends, other->id);
 }
 
 
 /*
-   Function that removes a friend from a user's friend list.
+   Function that removes a friend from a user's friend list, and the user from the friend's list.
    Return true of the friend was deleted and false otherwise.
 */
 _Bool delete_friend(user_t *user, char *friend_name)
 {
-   friend_t *current = user->friends;
-   friend_t *previous = NULL;
+   user_t *friend_user = index_find_user(friend_name);
+   return friend_user != NULL && delete_friend_id(user, friend_user->id);
+}
 
-   // traverse the linked list to find the friend to delete
-   while (current != NULL && strcmp(current->username, friend_name) != 0) {
-      previous = current;
-      current = current->next;
+
+/*
+   Function that removes a friend given by user id, as delete_friend does.
+   Return true of the friend was deleted and false otherwise.
+*/
+_Bool delete_friend_id(user_t *user, unsigned int friend_id)
+{
+   METRICS_SCOPE(OP_DELETE_FRIEND);
+   user_t *friend_user = index_user_by_id(friend_id);
+   if (friend_user == NULL || !friend_set_contains(&user->friends, friend_id)) {
+      return 0; // false, friend not found
    }
 
-   // friend found
-   if (current != NULL) {
-      if (previous != NULL) {
-         previous->next = current->next;
-      } else {
-         user->friends = current->next;
-      }
+   checkpoint_preserve(user);
+   checkpoint_preserve(friend_user);
+   friend_set_remove(&user->friends, friend_user->id);
+   friend_set_remove(&friend_user->friends, user->id);
+   METRICS_GAUGE_ADD(GAUGE_FRIENDSHIPS, -1);
+   wal_log(WAL_UNFRIEND, user->username, friend_user->username, 0, 0);
+   return 1; // true, friend deleted
+}
+
 
-      // free the memory of the deleted friend
-      free(current);
-      return 1; // true, friend deleted
+/*
+   Function that creates a post with a given id, or with the next post id if id is 0. The ids
+   only grow, so that the lists of posts stay in the order of the ids: an id that is not above
+   every id given so far is refused. The text is copied to the text arena, unless mapped is true
+   and the post keeps pointing at it. Return the newly created post, or NULL if the id is refused.
+*/
+static post_t *create_post_with_id(const char *text, unsigned long id, _Bool mapped)
+{
+   size_t length = strlen(text);
+   pthread_mutex_lock(&alloc_lock);
+   if (id != 0 && id < next_post_id) {
+      pthread_mutex_unlock(&alloc_lock);
+      return NULL;
    }
+   post_t *new_post = pool_alloc(&post_pool);
+   assert(new_post != NULL);
+   new_post->content = mapped ? text : text_append(text, length);
+   new_post->length = length;
+   new_post->created = time(NULL);
+   new_post->author = 0;
+   new_post->chunk = NULL;
 
-   return 0; // false, friend not found
+   // register the post so that it can be found by id, the ids that are skipped stay NULL
+   if (id == 0) {
+      id = next_post_id;
+   }
+   assert((id >> POST_SEGMENT_BITS) < MAX_POST_SEGMENTS);
+   for (unsigned long segment = next_post_id >> POST_SEGMENT_BITS; segment <= id >> POST_SEGMENT_BITS; segment++) {
+      if (post_table[segment] == NULL) {
+         post_table[segment] = calloc(POST_SEGMENT_SIZE, sizeof(post_t *));
+         assert(post_table[segment] != NULL);
+      }
+   }
+   new_post->id = id;
+   __atomic_store_n(post_entry(id), new_post, __ATOMIC_RELEASE);
+   __atomic_store_n(&next_post_id, id + 1, __ATOMIC_RELEASE);
+   pthread_mutex_unlock(&alloc_lock);
+   return new_post; 
 }
 
 
 /*
-   Function that creates a new user's post.
+   Function that creates a new user's post, gives it the next post id and records when it was created.
    Return the newly created post.
 */
 post_t *create_post(const char *text)
 {
-   post_t *new_post = malloc(sizeof(post_t));
-   assert(new_post != NULL);
-   strcpy(new_post->content, text);
-   new_post->next = NULL;
-   return new_post; 
+   return create_post_with_id(text, 0, 0);
+}
+
+
+/*
+   Function that adds a post with a given id, made at a given time, to a user's posts, the feeds,
+   the search index and, if trending is true, the trending hashtags. If mapped is true, the post
+   keeps pointing at its text instead of a copy. Return the new post, or NULL if the id is refused
+   (see create_post_with_id).
+*/
+static post_t *insert_post(user_t *user, const char *text, unsigned long id, time_t created, _Bool trending,
+                           _Bool mapped)
+{
+   METRICS_SCOPE(OP_ADD_POST);
+   checkpoint_preserve(user);
+   post_t *new_post = create_post_with_id(text, id, mapped);
+   if (new_post == NULL) {
+      return NULL;
+   }
+   new_post->created = created;
+   new_post->author = user->id;
+   post_list_push(&user->posts, new_post);
+   feed_fan_out(user, new_post);
+   search_index_post(new_post);
+   if (trending) {
+      trending_add_post(new_post);
+   }
+   METRICS_GAUGE_ADD(GAUGE_POSTS, 1);
+   wal_log(WAL_POST, user->username, new_post->content, new_post->id, new_post->created);
+   return new_post;
 }
 
 
 /*
    Function that adds a post to a user's timeline. New posts are be added following LIFO.
+   The post is also pushed to the news feeds of the user's friends. Return the new post.
+*/
+post_t *add_post(user_t *user, const char *text)
+{
+   return insert_post(user, text, 0, time(NULL), 1, 0);
+}
+
+
+/*
+   Function that adds a post with a given id, made at a given time, as add_post does, for posts
+   that are loaded from a snapshot or the log. The post gets the next id if id is 0.
+   Return the new post, or NULL if the id is not above every post id given so far, as a
+   duplicate id would make a later deletion by id remove the wrong post.
+*/
+post_t *add_post_at(user_t *user, const char *text, unsigned long id, time_t created)
+{
+   return insert_post(user, text, id, created, 1, 0);
+}
+
+
+/*
+   Function that adds a post as add_post_at does, but without copying its text: the post keeps
+   pointing at text, which must stay in memory as long as the post, such as the string table of
+   a mapped snapshot. Return the new post, or NULL if the id is refused.
+*/
+post_t *add_mapped_post(user_t *user, const char *text, unsigned long id, time_t created)
+{
+   return insert_post(user, text, id, created, 1, 1);
+}
+
+
+/*
+   Function that adds a post read from a CSV file. The file does not say when the post was
+   written, so it is given the time of the load like a new post, but its hashtags are not
+   counted as trending. Return the new post.
+*/
+post_t *add_loaded_post(user_t *user, const char *text)
+{
+   return insert_post(user, text, 0, time(NULL), 0, 0);
+}
+
+
+/*
+   Function that searches a post by id.
+   Return a pointer to the post if found and NULL if there is no such post or it was deleted.
+*/
+post_t *find_post(unsigned long id)
+{
+   if (id == 0 || id >= __atomic_load_n(&next_post_id, __ATOMIC_ACQUIRE)) {
+      return NULL;
+   }
+   return __atomic_load_n(post_entry(id), __ATOMIC_ACQUIRE);
+}
+
+
+/*
+   Function that returns the largest post id given so far, 0 if no post was added.
+*/
+unsigned long last_post_id()
+{
+   return __atomic_load_n(&next_post_id, __ATOMIC_ACQUIRE) - 1;
+}
+
+
+/*
+   Function that removes a post from a user's list of posts by its id, without walking the list.
+   Return true if the post was deleted and false if the user has no post with this id.
 */
-void add_post(user_t *user, const char *text)
+_Bool delete_post_by_id(user_t *user, unsigned long id)
 {
-   post_t *new_post = create_post(text);
-   new_post->next = user->posts;
-   user->posts =  new_post;
+   METRICS_SCOPE(OP_DELETE_POST);
+   post_t *post = find_post(id);
+   if (post == NULL || post->author != user->id) {
+      return 0; // false, post not found
+   }
+
+   checkpoint_preserve(user);
+   post_list_remove(&user->posts, post);
+
+   // give the deleted post's node back to the pool, feeds and searches skip ids that are no longer found
+   __atomic_store_n(post_entry(id), NULL, __ATOMIC_RELEASE);
+   search_remove_post(post);
+   pthread_mutex_lock(&alloc_lock);
+   pool_free(&post_pool, post);
+   pthread_mutex_unlock(&alloc_lock);
+   METRICS_GAUGE_ADD(GAUGE_POSTS, -1);
+   wal_log(WAL_DELETE_POST, user->username, NULL, id, 0);
+   return 1; // true, post deleted
 }
 
 
 /*
-   Function that removes a post from a user's list of posts.
+   Function that removes a post from a user's list of posts by its position, 1 being the newest.
    Return true if the post was deleted and false otherwise.
 */
 _Bool delete_post(user_t *user, int number)
 {
-   post_t *current = user->posts;
-   post_t *previous = NULL;
-   int current_position = 1;
+   if (number < 1) {
+      return 0;
+   }
+   post_cursor_t cursor;
+   post_t *post = post_list_seek(&user->posts, number - 1, &cursor);
+   return post != NULL && delete_post_by_id(user, post->id);
+}
+
 
-   while (current != NULL && current_position != number){
-      previous = current;
-      current = current->next;
-      current_position++;
+/*
+   Function that displays a page of a specific user's posts, POSTS_PER_PAGE posts per page,
+   the first page holding the newest posts. The posts are numbered by their position.
+*/
+void display_user_posts(user_t *user, unsigned int page)
+{
+   METRICS_SCOPE(OP_DISPLAY_POSTS);
+   // check if the user has any posts
+   if (user->posts.count == 0) {
+      output_printf("\nNo posts available for %s.", user->username);
+      output_flush();
+      return;
    }
 
-   if (current != NULL) {
-      // post found
-      if (previous != NULL) {
-         previous->next = current->next;
-      } else {
-         user->posts = current->next;
-      }
+   unsigned int num_pages = (user->posts.count + POSTS_PER_PAGE - 1) / POSTS_PER_PAGE;
+   if (page < 1 || page > num_pages) {
+      page = num_pages;
+   }
+   post_t *posts[POSTS_PER_PAGE];
+   size_t first = (size_t)(page - 1) * POSTS_PER_PAGE;
+   size_t count = post_list_page(&user->posts, first, posts, POSTS_PER_PAGE);
+   for (size_t i = 0; i < count; i++) {
+      output_string("\n");
+      output_number(first + i + 1);
+      output_string("- ");
+      output_string(user->username);
+      output_string(": ");
+      output_write(posts[i]->content, posts[i]->length);
+   }
+   if (num_pages > 1) {
+      output_printf("\n\nPage %u of %u (%u posts)", page, num_pages, user->posts.count);
+   }
+   output_flush();
+}
+
+
+/*
+   Function that prints a post found by a search.
+*/
+static void print_search_result(const post_t *post, void *context)
+{
+   (void)context;
+   printf("\n%lu- %s: %s", post->id, index_user_by_id(post->author)->username, post->content);
+}
 
-      // free the memory of the deleted post
-      free(current);
-      printf("Post %d was deleted successfully!", number);
-      return 1; // true, post deleted
+
+/*
+   Function that displays the newest posts matching a search query.
+*/
+void display_search_results(const char *query)
+{
+   METRICS_SCOPE(OP_DISPLAY_SEARCH);
+   size_t found = search_posts(query, SEARCH_RESULTS, print_search_result, NULL);
+   if (found == 0) {
+      printf("\nNo posts match \"%s\".", query);
+   } else if (found > SEARCH_RESULTS) {
+      printf("\n\n%zu posts found, the newest %d are shown.", found, SEARCH_RESULTS);
    }
-   return 0; // false, post not found
 }
 
 
 /*
-   Function that displays a specific user's posts
+   Function that displays the 10 most used hashtags of the last minute and of the last hour.
 */
-void display_user_posts(user_t *user)
+void display_trending_hashtags()
 {
-   // check if the user has any posts
-   post_t* current = user->posts;
-   if (current == NULL) {
-      printf("\nNo posts available for %s.", user->username);
+   METRICS_SCOPE(OP_DISPLAY_TRENDING);
+   const char *names[NUM_TRENDING_WINDOWS] = { "last minute", "last hour" };
+   trending_tag_t top[TRENDING_SIZE];
+   time_t now = time(NULL);
+
+   for (int window = 0; window < NUM_TRENDING_WINDOWS; window++) {
+      size_t count = trending_top(window, now, top, TRENDING_SIZE);
+      printf("\nTrending in the %s:", names[window]);
+      if (count == 0) {
+         printf("\n   no hashtags");
+      }
+      for (size_t i = 0; i < count; i++) {
+         printf("\n%2zu- %s (%lu posts)", i + 1, top[i].tag, top[i].count);
+      }
+      printf("\n");
+   }
+}
+
+
+/*
+   Function that displays a specific user's news feed, 10 posts at a time, newest first.
+   After each page, it asks the user if they want to display the next page.
+*/
+void display_user_feed(user_t *user)
+{
+   METRICS_SCOPE(OP_DISPLAY_FEED);
+   post_t *page[FEED_PAGE_SIZE];
+   unsigned long cursor = 0;
+   int number = 1;
+
+   size_t count = feed_page(user, cursor, page, FEED_PAGE_SIZE);
+   if (count == 0) {
+      printf("\nNo posts in %s's news feed.", user->username);
       return;
    }
 
-   // iterate through the linked list and print each post
-   for (int i = 1; current != NULL; current = current->next, i++) {
-      printf("\n%d- %s: %s", i, user->username, current->content);
-   }  
-   
+   while (count > 0) {
+      for (size_t i = 0; i < count; i++, number++) {
+         char date[20];
+         strftime(date, sizeof(date), "%Y-%m-%d %H:%M", localtime(&page[i]->created));
+         printf("\n%d- %s (%s): %s", number, index_user_by_id(page[i]->author)->username, date, page[i]->content);
+      }
+      cursor = page[count - 1]->id;
+
+      count = feed_page(user, cursor, page, FEED_PAGE_SIZE);
+      if (count == 0) {
+         return;
+      }
+
+      char choice = 'N';
+      printf("\n\nDo you want to display the next %d posts? (Y/N): ", FEED_PAGE_SIZE);
+      if (scanf(" %c", &choice) != 1 || choice == 'n' || choice == 'N') {
+         return;  // no answer, as at the end of a file, means no
+      }
+   }
 }
 
 
 /*
-   Function that displays a specific user's friends
+   Function that compares two users by username, used to sort a list of friends.
+*/
+static int compare_usernames(const void *a, const void *b)
+{
+   const user_t *first = *(user_t *const *)a;
+   const user_t *second = *(user_t *const *)b;
+   return strcmp(first->username, second->username);
+}
+
+
+/*
+   Function that displays a specific user's friends, sorted in ascending order
 */
 void display_user_friends(user_t *user)
 {
+   METRICS_SCOPE(OP_DISPLAY_FRIENDS);
    // check if the user has any friends
-   friend_t* current = user->friends;
-   printf("\nList of %s's friends:\n", user->username);
+   unsigned int count = user->friends.count;
+   output_printf("\nList of %s's friends:\n", user->username);
 
-   if (current == NULL) {
-      printf("No friends available for %s.\n", user->username);
+   if (count == 0) {
+      output_printf("No friends available for %s.\n", user->username);
+      output_flush();
       return;
    }
 
-   // iterate through the linked list and print each friend
-   for (int i = 1; current != NULL; current = current->next, i++) {
-      printf("%d- %s\n", i, current->username);
+   // friends are stored by id, sort them by name to display them
+   user_t **friends = malloc(count * sizeof(user_t *));
+   assert(friends != NULL);
+   for (unsigned int i = 0; i < count; i++) {
+      friends[i] = index_user_by_id(user->friends.ids[i]);
+   }
+   qsort(friends, count, sizeof(user_t *), compare_usernames);
+
+   for (unsigned int i = 0; i < count; i++) {
+      output_number(i + 1);
+      output_string("- ");
+      output_string(friends[i]->username);
+      output_string("\n");
    }  
+   output_flush();
+   free(friends);
 
 }
 
 
 /*
-   Function that displays all the posts of 2 users at a time from the database.
-   After displaying 2 users' posts, it asks the user if they want to display posts of the next 2 users.
+   Function that displays the posts of a row of the user table, as display_user_posts does,
+   a line at a time through a pager. Return false if the user wants no more lines.
+*/
+static _Bool display_row_posts(const user_row_t *row, pager_t *pager)
+{
+   if (row->post_count == 0) {
+      if (!pager_next_line(pager)) {
+         return 0;
+      }
+      output_string("\nNo posts available for ");
+      output_string(row->username);
+      output_string(".");
+      return 1;
+   }
+
+   for (size_t i = 0; i < row->post_count; i++) {
+      const post_t *post = find_post(row->posts[i]);
+      if (post == NULL) {
+         continue;
+      }
+      if (!pager_next_line(pager)) {
+         return 0;
+      }
+      output_string("\n");
+      output_number(i + 1);
+      output_string("- ");
+      output_string(row->username);
+      output_string(": ");
+      output_write(post->content, post->length);
+   }
+   return 1;
+}
+
+
+/*
+   Function that displays all the posts from the database, POSTS_PAGE_LINES lines at a time.
+   After every page, it asks the user if they want to display the next page.
    If there are no more post or the user types “n” or “N”, the function returns.
+   When the output is not a terminal, such as a pipe or a file, every post is written
+   without pages and nothing is asked.
 */
 void display_all_posts(user_t *users)
 {
-   user_t *current = users;
+   METRICS_SCOPE(OP_DISPLAY_ALL_POSTS);
+   if (users == NULL) {
+      return;
+   }
 
-   while (current != NULL) {
-      
-      // display posts of the current user
-      display_user_posts(current);
+   // walk the users in ascending order through the columns of a user table
+   user_table_t *table = user_table_build();
+   size_t cursor = 0;
+   user_row_t row;
+   pager_t pager;
+   pager_start(&pager, POSTS_PAGE_LINES, "\n\nDo you want to display the next posts? (Y/N): ");
 
-      // move to the next user
-      current = current->next;
+   while (user_table_next(table, &cursor, &row) && display_row_posts(&row, &pager)) {
+   }
+   output_flush();
+   user_table_free(table);
+}
 
-      if (current != NULL) {
-         // display posts of the next user
-         display_user_posts(current);
 
-         char choice;
-         printf("\n\nDo you want to display next 2 users posts? (Y/N): ");
-         scanf(" %c", &choice);
+/*
+   Fucntion that free all users from the database before terminating the application.
+*/
+void teardown(user_t *users)
+{
+   METRICS_SCOPE(OP_TEARDOWN);
+   // a running checkpoint still reads the users and the posts' contents
+   checkpoint_wait(NULL);
 
-         if (choice == 'n' || choice == 'N') {
-            return;
-         }
+   // friend sets, post lists and timelines are the only per-user allocations outside of the pools
+   (void)users;
+   for (unsigned int id = 0; id < index_user_count(); id++) {
+      friend_set_free(&index_user_by_id(id)->friends);
+      post_list_free(&index_user_by_id(id)->posts);
+      feed_free(index_user_by_id(id));
+   }
+   for (unsigned long i = 0; i < MAX_POST_SEGMENTS && post_table[i] != NULL; i++) {
+      free(post_table[i]);
+      post_table[i] = NULL;
+   }
+   next_post_id = 1;
 
-         // move to the next user
-         current = current->next;
-      }
-   }   
+   // every node lives in one of the pools and every post's content in the text arena,
+   // so freeing the slabs and the arena frees all the users and posts
+   pool_release(&user_pool);
+   pool_release(&post_pool);
+   text_arena_release();
+   search_clear();
+   trending_clear();
+   index_clear();
+   METRICS_GAUGE_SET(GAUGE_USERS, 0);
+   METRICS_GAUGE_SET(GAUGE_POSTS, 0);
+   METRICS_GAUGE_SET(GAUGE_FRIENDSHIPS, 0);
 }
 
 
 /*
-   Fucntion that free all users from the database before terminating the application.
+   Function that copies the allocation counters of the user and post pools.
 */
-void teardown(user_t *users)
+void get_pool_stats(pool_stats_t *user_stats, pool_stats_t *post_stats)
 {
-   user_t *current = users;
-   while (current != NULL) {
-      user_t *next_user = current->next;
+   *user_stats = user_pool.stats;
+   *post_stats = post_pool.stats;
+}
 
-      // free friends linked list memory
-      friend_t *current_friend = current->friends;
-      while (current_friend != NULL) {        
-         friend_t *next_friend = current_friend->next;
-         free(current_friend);
-         current_friend = next_friend;
-      }
 
-      // free posts linked list memory
-      post_t *current_post = current->posts;
-      while (current_post != NULL) {         
-         post_t *next_post = current_post->next;
-         free(current_post);
-         current_post = next_post;
-      }
-      
-      free(current);  // free current user's memory
-      current = next_user;  // move to the next user
-   }    
+/*
+   Function that returns the bytes taken by the segments of the table that finds the posts by id.
+*/
+size_t post_table_bytes()
+{
+   size_t segments = 0;
+   while (segments < MAX_POST_SEGMENTS && post_table[segments] != NULL) {
+      segments++;
+   }
+   return segments * POST_SEGMENT_SIZE * sizeof(post_t *);
 }
 
 
@@ -325,7 +816,11 @@ void print_menu()
         "3. Manage a user's posts (display/add/remove)",
         "4. Manage a user's friends (display/add/remove)",
         "5. Display all posts",
-        "6. Exit"
+        "6. Search posts",
+        "7. Trending hashtags",
+        "8. Save a checkpoint",
+        "9. Statistics",
+        "10. Exit"
     };
    
    print_pattern(PATTERN_LENGTH, '*');
@@ -344,57 +839,195 @@ void print_menu()
    Function that prints a pattern of a specified length and character, chosen by the user.
 */
 void print_pattern(unsigned int length, char character){
-   printf("\n");
-   for(int i = 0; i < length; i++){
-      printf("%c", character);
+   output_string("\n");
+   output_repeat(character, length);
+   output_string("\n");
+   output_flush();
+}
+
+
+// A friend column that names a user whose row was not read yet
+typedef struct pending_friend
+{
+    user_t *user;
+    char username[30];
+} pending_friend_t;
+
+// A row read by the serial loader, kept until the passwords of its batch are hashed
+typedef struct loaded_row
+{
+    char *line;                 // a copy of the row, split in place
+    char *username;
+    char *cursor;               // the friend and post columns that are left
+    credential_t credential;
+} loaded_row_t;
+
+
+/*
+   Function that returns the next comma separated field of a row and moves the cursor past it.
+   The field is terminated in place. Return NULL when the row has no more fields.
+*/
+static char *next_field(char **cursor)
+{
+   char *field = *cursor;
+   if (field == NULL) {
+      return NULL;
+   }
+
+   char *comma = strchr(field, ',');
+   if (comma != NULL) {
+      *comma = '\0';
+      *cursor = comma + 1;
+   } else {
+      *cursor = NULL;
    }
-   printf("\n");
+   return field;
 }
 
 
 /*
-   Function that reads users from the text file.
+   Function that checks if a field holds nothing but spaces.
 */
-user_t *read_CSV_and_create_users(FILE *file, int num_users)
+static _Bool is_blank(const char *field)
 {
-    user_t *users = NULL;
-    char buffer[500];
-    fgets(buffer, sizeof(buffer), file);  // read and discard the header line
-    int count = 0;
-    for (int i = 0; i < num_users; i++)
-    {
-        fgets(buffer, sizeof(buffer), file);
-        buffer[strcspn(buffer, "\r\n")] = 0;  // remove newline characters
+   while (*field == ' ') {
+      field++;
+   }
+   return *field == '\0';
+}
 
-        char *token = strtok(buffer, ",");
-        char *token2 = strtok(NULL, ",");
-        users = add_user(users, token, token2);
-        char *username = token;
 
-        token = strtok(NULL, ",");
+/*
+   Function that reads users from the text file until the end of the file.
+   Rows can be of any length. Every row holds a username, a password, 3 friend
+   columns (a blank column means no friend) and then any number of posts.
+   Friends that are not users of the file are ignored. The passwords are hashed with the full
+   rounds by password_hash_all, a batch of rows at a time, before their users are registered. If stats is not NULL, it receives the number of rows and bytes read and the load time.
+*/
+user_t *read_CSV_and_create_users(FILE *file, load_stats_t *stats)
+{
+   METRICS_SCOPE(OP_LOAD_CSV);
+    user_t *users = NULL;
+    char *buffer = NULL;
+    size_t buffer_size = 0;
+    ssize_t length = 0;
+    size_t rows = 0;
+    size_t bytes = 0;
+    double hash_seconds = 0;
+    pending_friend_t *pending = NULL;
+    size_t num_pending = 0;
+    size_t pending_capacity = 0;
+    loaded_row_t batch[LOAD_BATCH_ROWS];
+    password_job_t jobs[LOAD_BATCH_ROWS];
+    int threads = password_threads();
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
 
-        user_t *current_user = users;
-        for (; current_user != NULL && strcmp(current_user->username, username) != 0; current_user = current_user->next)
-            ;
+    // read and discard the header line
+    length = getline(&buffer, &buffer_size, file);
+    if (length > 0) {
+        bytes += length;
+    }
 
-        while (token != NULL && strcmp(token, ",") != 0 && count < 3)
+    while (length > 0)
+    {
+        // read a batch of rows and hash their passwords together
+        size_t num_rows = 0;
+        while (num_rows < LOAD_BATCH_ROWS && (length = getline(&buffer, &buffer_size, file)) > 0)
         {
-            if (strcmp(token, " ") != 0)
-            {
-                add_friend(current_user, token);
+            bytes += length;
+            buffer[strcspn(buffer, "\r\n")] = 0;  // remove newline characters
+
+            loaded_row_t *row = &batch[num_rows];
+            row->line = strdup(buffer);
+            assert(row->line != NULL);
+            row->cursor = row->line;
+            row->username = next_field(&row->cursor);
+            char *password = next_field(&row->cursor);
+            if (row->username == NULL || *row->username == '\0' || password == NULL || strlen(password) > PASSWORD_MAX_LENGTH) {
+                free(row->line);
+                continue;  // skip empty or malformed rows
             }
-            token = strtok(NULL, ",");
-            count++;
+            jobs[num_rows].credential = &row->credential;
+            jobs[num_rows].password = password;
+            num_rows++;
         }
-        count = 0;
+        rows += num_rows;
+
+        struct timespec hash_start, hash_end;
+        clock_gettime(CLOCK_MONOTONIC, &hash_start);
+        password_hash_all(jobs, num_rows, threads);
+        clock_gettime(CLOCK_MONOTONIC, &hash_end);
+        hash_seconds += (hash_end.tv_sec - hash_start.tv_sec) + (hash_end.tv_nsec - hash_start.tv_nsec) / 1e9;
 
-        // token = strtok(NULL, ",");
-        while (token != NULL && strcmp(token, ",") != 0)
+        for (size_t row = 0; row < num_rows; row++)
         {
-            add_post(current_user, token);
-            token = strtok(NULL, ",");
+            char *cursor = batch[row].cursor;
+            const char *username = batch[row].username;
+            user_t *current_user = insert_user_credential(&users, username, &batch[row].credential);
+            if (current_user == NULL) {
+                // the username appeared on an earlier row, add to that user
+                current_user = index_find_user(username);
+                if (current_user == NULL) {
+                    free(batch[row].line);
+                    continue;  // the username is too long
+                }
+            }
+
+            char *field;
+            for (int i = 0; i < 3 && (field = next_field(&cursor)) != NULL; i++)
+            {
+                if (is_blank(field))
+                {
+                    continue;
+                }
+                user_t *friend_user = index_find_user(field);
+                if (friend_user != NULL)
+                {
+                    add_friend_id(current_user, friend_user->id);
+                }
+                else if (strlen(field) < sizeof(pending[0].username))
+                {
+                    // the friend's row comes later in the file, link them once every user is read
+                    if (num_pending == pending_capacity) {
+                        pending_capacity = pending_capacity == 0 ? 64 : pending_capacity * 2;
+                        pending = realloc(pending, pending_capacity * sizeof(pending_friend_t));
+                        assert(pending != NULL);
+                    }
+                    pending[num_pending].user = current_user;
+                    strcpy(pending[num_pending].username, field);
+                    num_pending++;
+                }
+            }
+
+            while ((field = next_field(&cursor)) != NULL)
+            {
+                if (!is_blank(field))
+                {
+                    add_loaded_post(current_user, field);
+                }
+            }
+            free(batch[row].line);
         }
     }
+    free(buffer);
+
+    // friends that were not registered yet when their row was read; unknown users are dropped
+    for (size_t i = 0; i < num_pending; i++)
+    {
+        add_friend(pending[i].user, pending[i].username);
+    }
+    free(pending);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (stats != NULL) {
+        stats->rows = rows;
+        stats->bytes = bytes;
+        stats->seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+        stats->parse_seconds = 0;
+        stats->hash_seconds = hash_seconds;
+        stats->merge_seconds = 0;
+    }
     return users;
 }
- 
\ No newline at end of file
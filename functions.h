@@ -10,80 +10,210 @@
 
 #ifndef __A2_FUNCTIONS_H__
 #define __A2_FUNCTIONS_H__
+#include <stdio.h>
+#include <stddef.h>
 #include "nodes.h"
+#include "pool.h"
+
+// Statistics collected while loading the users from the CSV file
+typedef struct load_stats
+{
+    size_t rows;
+    size_t bytes;
+    double seconds;
+    double parse_seconds;       // parsing by the parallel loader, 0 for the serial loader
+    double hash_seconds;        // hashing the passwords with the full rounds
+    double merge_seconds;       // merging the rows into users by the parallel loader, 0 for the serial loader
+} load_stats_t;
 
 /*
-   Function that creates a new user and adds it to a linked list, sorted in ascending order, at
-   the proper sorted location. Returns the head of the list.
+   Function that creates a new user, adds it at the beginning of the linked list and registers
+   it in the user index. Return the new user, or NULL if the username is already taken
+   or the username or password is too long.
+*/
+user_t *insert_user(user_t **users, const char *username, const char *password);
+
+/*
+   Function that creates a new user with a credential that is already made, as insert_user does.
+   Return the new user, or NULL if the username is already taken or too long.
+*/
+user_t *insert_user_credential(user_t **users, const char *username, const credential_t *credential);
+
+/*
+   Function that creates a new user and adds it to the linked list and to the user index.
+   The index keeps the users sorted in ascending order for the listings. Returns the head of the list.
 */
 user_t *add_user(user_t *users, const char *username, const char *password);
 
+/*
+   Function that changes a user's password.
+   Return true if the password was changed and false if it is too long.
+*/
+_Bool set_password(user_t *user, const char *password);
+
+/*
+   Function that replaces a user's credential with one that is already made.
+*/
+void set_credential(user_t *user, const credential_t *credential);
+
+/*
+   Function that checks a user's password.
+   Return true if the password is the user's and false otherwise.
+*/
+_Bool authenticate(const user_t *user, const char *password);
+
 /*
    Function that searches if the user is available in the database 
-   Return a pointer to the user if found and NULL if not found.
+   Return a pointer to the user if found and NULL if not found, after suggesting usernames
+   that start like the one given.
 */
 user_t *find_user(user_t *users, const char *username);
 
 
 /*
-   Function that creates a new friend's node.
-   Return the newly created node.
+   Function that links two users as friends. Friendship goes both ways, so each
+   user's id is added to the other user's friend set.
+   Return true if the friend was added and false if the friend is not a registered
+   user, is the user itself, or is already a friend.
 */
-friend_t *create_friend(const char *username);
+_Bool add_friend(user_t *user, const char *friend);
 
+/*
+   Function that links two users as friends, as add_friend does, with the friend given by user id.
+   Return true if the friend was added and false if there is no such user, it is the user
+   itself, or it is already a friend.
+*/
+_Bool add_friend_id(user_t *user, unsigned int friend_id);
 
 /*
-   Function that links a friend to a user. The friend's name is added to
-   a linked list, sorted in ascending order.
+   Function that checks if two users are friends.
+   Return true if they are friends and false otherwise.
 */
-void add_friend(user_t *user, const char *friend);
+_Bool are_friends(user_t *user, user_t *other);
 
 /*
-   Function that removes a friend from a user's friend list.
+   Function that removes a friend from a user's friend list, and the user from the friend's list.
    Return true of the friend was deleted and false otherwise.
 */
 _Bool delete_friend(user_t *user, char *friend_name);
 
 /*
-   Function that creates a new user's post.
+   Function that removes a friend given by user id, as delete_friend does.
+   Return true of the friend was deleted and false otherwise.
+*/
+_Bool delete_friend_id(user_t *user, unsigned int friend_id);
+
+/*
+   Function that creates a new user's post, gives it the next post id and records when it was created.
    Return the newly created post.
 */
 post_t *create_post(const char *text);
 
 /*
    Function that adds a post to a user's timeline. New posts are added following LIFO.
+   The post is also pushed to the news feeds of the user's friends. Return the new post.
+*/
+post_t *add_post(user_t *user, const char *text);
+
+/*
+   Function that adds a post with a given id, made at a given time, as add_post does, for posts
+   that are loaded from a snapshot or the log. The post gets the next id if id is 0.
+   Return the new post, or NULL if the id is not above every post id given so far, as a
+   duplicate id would make a later deletion by id remove the wrong post.
+*/
+post_t *add_post_at(user_t *user, const char *text, unsigned long id, time_t created);
+
+/*
+   Function that adds a post as add_post_at does, but without copying its text: the post keeps
+   pointing at text, which must stay in memory as long as the post, such as the string table of
+   a mapped snapshot. Return the new post, or NULL if the id is refused.
 */
-void add_post(user_t *user, const char *text);
+post_t *add_mapped_post(user_t *user, const char *text, unsigned long id, time_t created);
 
 /*
-   Function that removes a post from a user's list of posts.
+   Function that adds a post read from a CSV file. The file does not say when the post was
+   written, so it is given the time of the load like a new post, but its hashtags are not
+   counted as trending. Return the new post.
+*/
+post_t *add_loaded_post(user_t *user, const char *text);
+
+/*
+   Function that searches a post by id.
+   Return a pointer to the post if found and NULL if there is no such post or it was deleted.
+*/
+post_t *find_post(unsigned long id);
+
+/*
+   Function that returns the largest post id given so far, 0 if no post was added.
+*/
+unsigned long last_post_id();
+
+/*
+   Function that removes a post from a user's list of posts by its id, without walking the list.
+   Return true if the post was deleted and false if the user has no post with this id.
+*/
+_Bool delete_post_by_id(user_t *user, unsigned long id);
+
+/*
+   Function that removes a post from a user's list of posts by its position, 1 being the newest.
    Return true if the post was deleted and false otherwise.
 */
 _Bool delete_post(user_t *user, int number);
 
 /*
-   Function that  displays a specific user's posts
+   Function that displays a page of a specific user's posts, 10 posts per page, the first page
+   holding the newest posts, or the last page if there is no such page. The posts are numbered
+   by their position, as delete_post takes them.
 */
-void display_user_posts(user_t *user);
+void display_user_posts(user_t *user, unsigned int page);
+
+/*
+   Function that displays a specific user's news feed, 10 posts at a time, newest first.
+   After each page, it asks the user if they want to display the next page.
+*/
+void display_user_feed(user_t *user);
 
 
 /*
-   Function that displays a specific user's friends
+   Function that displays a specific user's friends, sorted in ascending order
 */
 void display_user_friends(user_t *user);
 
 /*
-   Function that displays all the posts of 2 users at a time from the database.
-   After displaying 2 users' posts, it asks the user if they want to display posts of the next 2 users.
+   Function that displays all the posts from the database, 20 lines at a time.
+   After every page, it asks the user if they want to display the next page.
    If there are no more post or the user types “n” or “N”, the function returns.
+   When the output is not a terminal, such as a pipe or a file, every post is written
+   without pages and nothing is asked.
 */
 void display_all_posts(user_t *users);
 
+/*
+   Function that displays the newest posts matching a search query of words, #hashtags
+   and @mentions, which can be split with OR.
+*/
+void display_search_results(const char *query);
+
+/*
+   Function that displays the 10 most used hashtags of the last minute and of the last hour.
+*/
+void display_trending_hashtags();
+
 /*
    Fucntion that free all users from the database before quitting the application.
 */
 void teardown(user_t *users);
 
+/*
+   Function that copies the allocation counters of the user and post pools.
+*/
+void get_pool_stats(pool_stats_t *user_stats, pool_stats_t *post_stats);
+
+/*
+   Function that returns the bytes taken by the segments of the table that finds the posts by id.
+*/
+size_t post_table_bytes();
+
 /*
    Function that prints the main menu with a list of options for the user to choose from
 */
@@ -96,9 +226,13 @@ void print_pattern(unsigned int length, char character);
 
 
 /* 
-   Function that reads users from the text file.
+   Function that reads users from the text file until the end of the file.
+   Rows can be of any length. Every row holds a username, a password, 3 friend
+   columns (a blank column means no friend) and then any number of posts.
+   Friends that are not users of the file are ignored. The passwords are hashed with the full
+   rounds by password_hash_all, a batch of rows at a time, before their users are registered. If stats is not NULL, it receives the number of rows and bytes read and the load time.
 */
-user_t *read_CSV_and_create_users(FILE *file, int num_users);
+user_t *read_CSV_and_create_users(FILE *file, load_stats_t *stats);
 
 
 #endif
@@ -0,0 +1,75 @@
+/**
+ * @file generate.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file is the generator of synthetic user files, with the columns of
+ * user_details.csv, for the benchmarks and for trying the program with many
+ * users. It is a program of its own, built with:
+ *
+ *   gcc -Wall -O2 -o generate generate.c generator.c -lm
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "generator.h"
+
+
+/*
+   Usage:
+     generate <users> [--friend-exponent <exponent>] [--max-friends <friends>] [--posts <mean>]
+              [--post-length <median>] [--seed <seed>] [--output <file>]
+         writes a CSV file of that many users to the output, the standard output by default,
+         and what it holds to the standard error
+*/
+int main(int argc, char *argv[])
+{
+    generator_options_t options;
+    generator_default_options(&options);
+    const char *output_path = NULL;
+
+    _Bool valid = argc >= 2 && atol(argv[1]) > 0;
+    if (valid) {
+        options.users = atol(argv[1]);
+    }
+    for (int i = 2; i + 1 < argc && valid; i += 2) {
+        if (strcmp(argv[i], "--friend-exponent") == 0 && atof(argv[i + 1]) > 1) {
+            options.friend_exponent = atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "--max-friends") == 0) {
+            options.max_friends = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--posts") == 0 && atof(argv[i + 1]) >= 0) {
+            options.posts_per_user = atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "--post-length") == 0 && atoi(argv[i + 1]) > 0) {
+            options.post_length = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            options.seed = strtoul(argv[i + 1], NULL, 10);
+        } else if (strcmp(argv[i], "--output") == 0) {
+            output_path = argv[i + 1];
+        } else {
+            valid = 0;
+        }
+    }
+    if (!valid || argc % 2 != 0) {
+        fprintf(stderr, "Usage: %s <users> [--friend-exponent <exponent>] [--max-friends <friends>] [--posts <mean>]"
+                " [--post-length <median>] [--seed <seed>] [--output <file>]\n", argv[0]);
+        return 1;
+    }
+
+    FILE *output = output_path != NULL ? fopen(output_path, "w") : stdout;
+    if (output == NULL) {
+        perror("Error opening the output file");
+        return 1;
+    }
+    generator_stats_t stats;
+    generate_users_csv(output, &options, &stats);
+    if (fclose(output) != 0) {
+        perror("Error writing the output file");
+        return 1;
+    }
+
+    fprintf(stderr, "Generated %zu users in %zu rows: %zu friends, %zu posts, %zu bytes\n",
+            options.users, stats.rows, stats.friends, stats.posts, stats.bytes);
+    return 0;
+}
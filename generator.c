@@ -0,0 +1,178 @@
+/**
+ * @file generator.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the generator of synthetic user
+ * files. The power laws are drawn by inverting the cumulative distribution of
+ * a continuous power law cut at its maximum and rounding down, and the post
+ * lengths from a normal distribution (Box-Muller) scaled into a log-normal one.
+ *
+ * A user is named as a friend with a probability proportional to rank^-s,
+ * where rank is its number plus 1 and s = 1 / (exponent - 1), which gives the
+ * number of times the users are named the same power law as the number of
+ * friends they name.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "generator.h"
+
+#define FRIEND_COLUMNS 3
+#define POST_LENGTH_SIGMA 0.6
+#define MIN_POST_LENGTH 5
+#define MAX_POST_LENGTH 1000
+#define VOCABULARY 5000
+#define HASHTAGS 200
+
+
+/*
+   Function that sets the default options: 1000 users, an exponent of 2.2 capped at 1000
+   friends, 3 posts per user of 80 characters and a seed of 42.
+*/
+void generator_default_options(generator_options_t *options)
+{
+   options->users = 1000;
+   options->friend_exponent = 2.2;
+   options->max_friends = 1000;
+   options->posts_per_user = 3;
+   options->post_length = 80;
+   options->seed = 42;
+}
+
+
+/*
+   Function that returns a random number in (0, 1).
+*/
+static double uniform(unsigned int *seed)
+{
+   return (rand_r(seed) + 0.5) / ((double)RAND_MAX + 1.0);
+}
+
+
+/*
+   Function that draws a number from 1 to max with a probability proportional to x^-exponent.
+*/
+static size_t power_law(double exponent, size_t max, unsigned int *seed)
+{
+   double value;
+   if (exponent == 1.0) {
+      value = pow(max + 1.0, uniform(seed));
+   } else {
+      double power = 1.0 - exponent;
+      value = pow(1.0 + uniform(seed) * (pow(max + 1.0, power) - 1.0), 1.0 / power);
+   }
+   return value >= (double)max ? max : (size_t)value;
+}
+
+
+/*
+   Function that draws the number of posts of a user from a geometric distribution.
+*/
+static unsigned int geometric(double mean, unsigned int *seed)
+{
+   if (mean <= 0) {
+      return 0;
+   }
+   return (unsigned int)(log(uniform(seed)) / log(mean / (mean + 1.0)));
+}
+
+
+/*
+   Function that draws the length of a post from a log-normal distribution.
+*/
+static size_t post_length(unsigned int median, unsigned int *seed)
+{
+   double normal = sqrt(-2.0 * log(uniform(seed))) * cos(2.0 * M_PI * uniform(seed));
+   double length = median * exp(POST_LENGTH_SIGMA * normal);
+   if (length < MIN_POST_LENGTH) {
+      return MIN_POST_LENGTH;
+   }
+   return length > MAX_POST_LENGTH ? MAX_POST_LENGTH : (size_t)length;
+}
+
+
+/*
+   Function that writes a post of about length characters: words, with a hashtag
+   and a mention now and then. Return the number of characters written.
+*/
+static size_t write_post(FILE *file, size_t length, size_t users, unsigned int *seed)
+{
+   size_t written = 0;
+   while (written < length) {
+      int kind = rand_r(seed) % 20;
+      int size;
+      if (kind == 0) {
+         size = fprintf(file, "%s#tag%u", written > 0 ? " " : "", (unsigned int)power_law(1.5, HASHTAGS, seed));
+      } else if (kind == 1) {
+         size = fprintf(file, "%s@user%zu", written > 0 ? " " : "", (size_t)rand_r(seed) % users);
+      } else {
+         // short and frequent words, as in a natural language
+         unsigned int word = power_law(1.8, VOCABULARY, seed);
+         size = fprintf(file, "%s", written > 0 ? " " : "");
+         do {
+            fputc('a' + word % 26, file);
+            size++;
+            word /= 26;
+         } while (word > 0);
+      }
+      written += size;
+   }
+   return written;
+}
+
+
+/*
+   Function that writes a generated CSV file of users with the header of user_details.csv.
+   If stats is not NULL, it receives what the file holds.
+*/
+void generate_users_csv(FILE *file, const generator_options_t *options, generator_stats_t *stats)
+{
+   generator_stats_t totals;
+   memset(&totals, 0, sizeof(totals));
+   unsigned int seed = options->seed;
+   size_t users = options->users;
+   size_t max_friends = options->max_friends < users ? options->max_friends : users - 1;
+   double popularity = 1.0 / (options->friend_exponent - 1.0);
+
+   totals.bytes += fprintf(file, "Username,Password,Friends,,,Posts,,\n");
+   for (size_t user = 0; user < users; user++) {
+      unsigned int password = rand_r(&seed);
+      size_t friends = max_friends > 0 ? power_law(options->friend_exponent, max_friends, &seed) : 0;
+      unsigned int posts = geometric(options->posts_per_user, &seed);
+
+      // the first row holds the posts, the friends that do not fit in it go on extra rows
+      do {
+         totals.bytes += fprintf(file, "user%zu,pw%08x", user, password);
+         for (int column = 0; column < FRIEND_COLUMNS; column++) {
+            if (friends == 0) {
+               totals.bytes += fprintf(file, ", ");
+               continue;
+            }
+            // the popular users are the ones with the smallest numbers
+            size_t friend = power_law(popularity, users, &seed) - 1;
+            if (friend == user) {
+               friend = (friend + 1) % users;
+            }
+            totals.bytes += fprintf(file, ",user%zu", friend);
+            friends--;
+            totals.friends++;
+         }
+         for (; posts > 0; posts--) {
+            fputc(',', file);
+            totals.bytes += 1 + write_post(file, post_length(options->post_length, &seed), users, &seed);
+            totals.posts++;
+         }
+         fputc('\n', file);
+         totals.bytes++;
+         totals.rows++;
+      } while (friends > 0);
+   }
+
+   if (stats != NULL) {
+      *stats = totals;
+   }
+}
@@ -0,0 +1,54 @@
+/**
+ * @file generator.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the generator of synthetic user files. The files
+ * have the columns of user_details.csv: a username, a password, 3 friend
+ * columns and the posts. The number of friends of every user follows a power
+ * law, so a few users have thousands of friends and most have one or two;
+ * the users with more than 3 friends get extra rows, which the loaders add to
+ * the user of the first row. The friends are drawn with the same power law,
+ * so the popular users are also the ones that many others name.
+ */
+
+#ifndef __A2_GENERATOR_H__
+#define __A2_GENERATOR_H__
+#include <stdio.h>
+#include <stddef.h>
+
+// The shape of a generated file
+typedef struct generator_options
+{
+    size_t users;
+    double friend_exponent;     // exponent of the power law of the friends per user, above 1
+    unsigned int max_friends;
+    double posts_per_user;      // mean of a geometric distribution
+    unsigned int post_length;   // median length of a post in characters, lengths are log-normal
+    unsigned int seed;          // the same options and seed always make the same file
+} generator_options_t;
+
+// What a generated file holds
+typedef struct generator_stats
+{
+    size_t rows;
+    size_t friends;             // friend columns that are not blank
+    size_t posts;
+    size_t bytes;
+} generator_stats_t;
+
+/*
+   Function that sets the default options: 1000 users, an exponent of 2.2 capped at 1000
+   friends, 3 posts per user of 80 characters and a seed of 42.
+*/
+void generator_default_options(generator_options_t *options);
+
+/*
+   Function that writes a generated CSV file of users with the header of user_details.csv.
+   If stats is not NULL, it receives what the file holds.
+*/
+void generate_users_csv(FILE *file, const generator_options_t *options, generator_stats_t *stats);
+
+
+#endif
@@ -0,0 +1,55 @@
+/**
+ * @file histogram.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the latency histograms.
+ */
+
+#include <time.h>
+#include "histogram.h"
+
+
+/*
+   Function that returns the current time in nanoseconds, for measuring latencies.
+*/
+unsigned long long histogram_now_ns()
+{
+   struct timespec now;
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (unsigned long long)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+
+/*
+   Function that records the latency of an operation in a histogram.
+*/
+void histogram_add(histogram_t *histogram, unsigned long long ns)
+{
+   int bucket = ns == 0 ? 0 : 63 - __builtin_clzll(ns);
+   histogram->buckets[bucket]++;
+   histogram->count++;
+   histogram->total_ns += ns;
+   if (ns > histogram->max_ns) {
+      histogram->max_ns = ns;
+   }
+}
+
+
+/*
+   Function that returns an upper bound of the latency under which the given fraction of the operations ran.
+*/
+unsigned long long histogram_percentile(const histogram_t *histogram, double fraction)
+{
+   size_t rank = (size_t)(fraction * histogram->count);
+   size_t seen = 0;
+   for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+      seen += histogram->buckets[i];
+      if (seen > rank) {
+         unsigned long long bound = i == HISTOGRAM_BUCKETS - 1 ? histogram->max_ns : (2ull << i) - 1;
+         return bound < histogram->max_ns ? bound : histogram->max_ns;
+      }
+   }
+   return histogram->max_ns;
+}
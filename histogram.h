@@ -0,0 +1,43 @@
+/**
+ * @file histogram.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the latency histograms used to report how long
+ * operations take. Buckets are powers of two, so a histogram is small and
+ * recording a latency is a few instructions.
+ */
+
+#ifndef __A2_HISTOGRAM_H__
+#define __A2_HISTOGRAM_H__
+#include <stddef.h>
+
+#define HISTOGRAM_BUCKETS 64
+
+// Latency histogram, bucket i counts the operations that took [2^i, 2^(i+1)) ns
+typedef struct histogram
+{
+    size_t count;
+    size_t buckets[HISTOGRAM_BUCKETS];
+    unsigned long long total_ns;
+    unsigned long long max_ns;
+} histogram_t;
+
+/*
+   Function that returns the current time in nanoseconds, for measuring latencies.
+*/
+unsigned long long histogram_now_ns();
+
+/*
+   Function that records the latency of an operation in a histogram.
+*/
+void histogram_add(histogram_t *histogram, unsigned long long ns);
+
+/*
+   Function that returns an upper bound of the latency under which the given fraction of the operations ran.
+*/
+unsigned long long histogram_percentile(const histogram_t *histogram, double fraction);
+
+
+#endif
@@ -7,38 +7,214 @@
  * This file is the main interface of Facebook simulation, allowing users to: 
  * - create profiles with a username and password.
  * - manage a user's profile my changing passwords.
- * - manage a user's posts; adding, deleting or displaying posts.
- * - manage a user's friends; adding, deleting or displaying friends.
+ * - manage a user's posts; adding, deleting or displaying posts a page at a time, and reading their news feed.
+ * - manage a user's friends; adding, deleting or displaying friends, and suggesting new ones.
  * - display all posts made by all the users in the included database.
+ * - search the posts by words, hashtags and mentions.
+ * - display the trending hashtags of the last minute and the last hour.
+ * - save a checkpoint of all the users in the background.
+ * - display how many times each operation ran, how long it took, and the users, posts and memory.
  */
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
+#include <errno.h>
 #include "nodes.h"
 #include "functions.h"
-
-#define NUM_FEATURES 6
+#include "user_index.h"
+#include "snapshot.h"
+#include "recommend.h"
+#include "batch.h"
+#include "server.h"
+#include "wal.h"
+#include "checkpoint.h"
+#include "password.h"
+#include "csv_load.h"
+#include "metrics.h"
+
+#define NUM_FEATURES 10
 #define PATTERN_LENGTH 50
+#define MAX_SUGGESTIONS 10
+#define BATCH_BUFFER_SIZE (1 << 20)
 
 
-int main()
+/*
+   Function that loads the users from a CSV file and reports how fast they were read.
+   Return 0 on success and 1 if the file can not be opened.
+*/
+static int load_users_from_csv(const char *path, user_t **users)
 {
-    
-    /* 
-       Loads the database of users from the file and generates the starting linked list.
-    */
-    FILE *csv_file = fopen("user_details.csv", "r");
+    FILE *csv_file = fopen(path, "r");
     if (csv_file == NULL)
     {
         perror("Error opening the CSV file");
         return 1;
     }
     // Parse CSV data and create users
-    user_t *users = read_CSV_and_create_users(csv_file, 50);
+    load_stats_t load_stats;
+    *users = read_CSV_parallel(csv_file, password_threads(), &load_stats);
 
     fclose(csv_file);
+
+    double load_seconds = load_stats.seconds > 0 ? load_stats.seconds : 1e-9;
+    fprintf(stderr, "Loaded %zu users (%zu bytes) in %.3f ms (%.3f ms hashing passwords): %.0f rows/s, %.2f MB/s\n",
+           load_stats.rows, load_stats.bytes, load_stats.seconds * 1e3, load_stats.hash_seconds * 1e3,
+           load_stats.rows / load_seconds, load_stats.bytes / load_seconds / 1e6);
+    return 0;
+}
+
+
+/*
+   Function that converts a CSV file to a snapshot file, then opens the snapshot
+   and checks that it holds the same users as the CSV file.
+   Return 0 on success and 1 on error.
+*/
+static int convert_csv_to_snapshot(const char *csv_path, const char *snapshot_path)
+{
+    user_t *users = NULL;
+    if (load_users_from_csv(csv_path, &users) != 0) {
+        return 1;
+    }
+
+    int result = 1;
+    if (snapshot_write(snapshot_path, users) != 0) {
+        perror("Error writing the snapshot");
+    } else {
+        snapshot_t *snapshot = snapshot_open(snapshot_path);
+        if (snapshot == NULL) {
+            fprintf(stderr, "Error opening the snapshot %s\n", snapshot_path);
+        } else {
+            size_t differences = snapshot_verify(snapshot, users);
+            printf("Wrote %u users, %u friends and %u posts to %s (%zu users differ)\n",
+                   snapshot->header->user_count, snapshot->header->friend_count,
+                   snapshot->header->post_count, snapshot_path, differences);
+            result = differences == 0 ? 0 : 1;
+            snapshot_close(snapshot);
+        }
+    }
+
+    teardown(users);
+    return result;
+}
+
+
+/*
+   Usage:
+     facebook [--snapshot <file>] [--wal <file> [--wal-sync each|group]] [--batch <file> | --server <socket>]
+         loads the users from user_details.csv, or from a snapshot file, then starts the menu,
+         runs the commands of a file (- for the standard input) without the menu,
+         or serves the same commands to many clients over a Unix domain socket.
+         With --wal, the changes in the log are applied on startup and every new change is logged
+     facebook --convert <csv> <snapshot>
+         converts a CSV file to a snapshot file and exits
+     facebook --loadgen <socket> <max clients> <seconds>
+         measures the throughput of a server with 1, 2, 4, ... clients
+*/
+int main(int argc, char *argv[])
+{
+    
+    /* 
+       Loads the database of users from the file and generates the starting linked list.
+    */
+    const char *snapshot_path = NULL;
+    const char *batch_path = NULL;
+    const char *socket_path = NULL;
+    const char *wal_path = NULL;
+    wal_sync_t wal_mode = WAL_SYNC_GROUP;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--convert") == 0 && argc == 4 && i == 1) {
+            return convert_csv_to_snapshot(argv[2], argv[3]);
+        } else if (strcmp(argv[i], "--loadgen") == 0 && argc == 5 && i == 1 && atoi(argv[3]) > 0 && atof(argv[4]) > 0) {
+            return run_load_generator(argv[2], atoi(argv[3]), atof(argv[4]));
+        } else if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) {
+            snapshot_path = argv[++i];
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batch_path = argv[++i];
+        } else if (strcmp(argv[i], "--server") == 0 && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (strcmp(argv[i], "--wal") == 0 && i + 1 < argc) {
+            wal_path = argv[++i];
+        } else if (strcmp(argv[i], "--wal-sync") == 0 && i + 1 < argc
+                   && (strcmp(argv[i + 1], "each") == 0 || strcmp(argv[i + 1], "group") == 0)) {
+            wal_mode = strcmp(argv[++i], "each") == 0 ? WAL_SYNC_EACH : WAL_SYNC_GROUP;
+        } else {
+            fprintf(stderr, "Usage: %s [--snapshot <file>] [--wal <file> [--wal-sync each|group]] [--batch <file> | --server <socket>]"
+                    " | --convert <csv> <snapshot> | --loadgen <socket> <max clients> <seconds>\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // the server stops on SIGINT and SIGTERM, which must be blocked before the metrics, log
+    // and checkpoint threads are created so that only its signal thread receives them
+    if (socket_path != NULL) {
+        server_block_signals();
+    }
+
+    // kill -USR1 writes the statistics to the standard error in every mode
+    metrics_start_signal_report();
+
+    user_t *users = NULL;
+    uint64_t saved_log_records = 0;
+    if (snapshot_path != NULL) {
+        snapshot_t *snapshot = snapshot_open(snapshot_path);
+        if (snapshot == NULL) {
+            fprintf(stderr, "Error opening the snapshot %s\n", snapshot_path);
+            return 1;
+        }
+        // the loaded posts point into the snapshot, it stays mapped until the program exits
+        users = snapshot_load_users(snapshot);
+        saved_log_records = snapshot->header->log_records;
+    } else if (load_users_from_csv("user_details.csv", &users) != 0) {
+        return 1;
+    }
+
+    if (wal_path != NULL) {
+        // the log holds the changes made since the users were saved, a checkpoint
+        // already includes the log's first records
+        wal_replay_stats_t replay_stats;
+        if (wal_replay(wal_path, &users, saved_log_records, &replay_stats) != 0
+            || wal_open(wal_path, wal_mode, replay_stats.records) != 0) {
+            if (replay_stats.damaged != 0) {
+                fprintf(stderr, "Error reading the log: the change at byte %zu of %s is damaged and %zu changes come before it\n",
+                        replay_stats.damaged, wal_path, replay_stats.records);
+            } else {
+                perror("Error opening the log");
+            }
+            teardown(users);
+            return 1;
+        }
+        fprintf(stderr, "Replayed %zu changes from %s (%zu already saved, %zu failed, %zu bytes of an incomplete change dropped)\n",
+                replay_stats.records - replay_stats.skipped, wal_path, replay_stats.skipped,
+                replay_stats.failed, replay_stats.truncated);
+    }
+
+    if (batch_path != NULL) {
+        FILE *batch_file = strcmp(batch_path, "-") == 0 ? stdin : fopen(batch_path, "r");
+        if (batch_file == NULL) {
+            perror("Error opening the batch file");
+            wal_close();
+            teardown(users);
+            return 1;
+        }
+        // results are only written when the buffer is full instead of after every line
+        setvbuf(stdout, NULL, _IOFBF, BATCH_BUFFER_SIZE);
+        size_t failures = run_batch(batch_file, stdout, stderr, &users);
+        if (batch_file != stdin) {
+            fclose(batch_file);
+        }
+        wal_close();
+        teardown(users);
+        return failures == 0 ? 0 : 2;
+    }
+
+    if (socket_path != NULL) {
+        int result = run_server(socket_path, &users);
+        wal_close();
+        teardown(users);
+        return result;
+    }
     
     /****************************************************************/    
 
@@ -61,13 +237,18 @@ int main()
         switch(user_inp){
             case 1:
                 char username[30];
-                char password[15];
+                char password[PASSWORD_MAX_LENGTH + 1];
                 
                 printf("Enter an upto 30 characters username: ");
                 scanf("%29s", username);
 
-                printf("Enter an upto 15 characters password: ");
-                scanf("%14s", password);
+                printf("Enter an upto 128 characters password: ");
+                scanf("%128s", password);
+
+                if (index_find_user(username) != NULL){
+                    printf("\n**** Username already taken! ****\n");
+                    break;
+                }
 
                 users = add_user(users, username, password);
 
@@ -82,9 +263,22 @@ int main()
 
                 user_t *found_user_pass = find_user(users, inp_user_pass);
                 if (found_user_pass != NULL){
-                    printf("Enter a new password (15 characters max): ");
-                    scanf("%15s", found_user_pass->password);
-                    printf("\n**** Password changed! ****\n");
+                    char current_password[PASSWORD_MAX_LENGTH + 1];
+                    printf("Enter the current password: ");
+                    scanf("%128s", current_password);
+                    if (!authenticate(found_user_pass, current_password)) {
+                        printf("\n**** Wrong password! ****\n");
+                        break;
+                    }
+
+                    char new_password[PASSWORD_MAX_LENGTH + 1];
+                    printf("Enter a new password (128 characters max): ");
+                    scanf("%128s", new_password);
+                    if (set_password(found_user_pass, new_password)) {
+                        printf("\n**** Password changed! ****\n");
+                    } else {
+                        printf("\n**** Password too long! ****\n");
+                    }
                 }
                 break;
 
@@ -94,15 +288,17 @@ int main()
                 scanf("%29s", inp_user_posts); 
 
                 user_t *found_user_posts = find_user(users, inp_user_posts);
+                unsigned int posts_page = 1;
                 while (found_user_posts != NULL){
                     
                     print_pattern(PATTERN_LENGTH, '-');
                     printf("           %s's posts", found_user_posts->username);
-                    display_user_posts(found_user_posts);
+                    display_user_posts(found_user_posts, posts_page);
                     print_pattern(PATTERN_LENGTH, '-');
 
                     unsigned short int post_choice;
-                    printf("\n1. Add a new user post\n2. Remove a user's post\n3. Return to main menu");
+                    printf("\n1. Add a new user post\n2. Remove a user's post\n3. Display the user's news feed"
+                           "\n4. Display another page of posts\n5. Return to main menu");
                     printf("\n\nYour choice: ");
                     scanf(" %hu", &post_choice);
 
@@ -110,7 +306,7 @@ int main()
                         case 1:
                             char new_post_text[250];
                             printf("Enter your post content (250 characters max): ");
-                            scanf(" %[^\n]s", new_post_text);
+                            scanf(" %249[^\n]", new_post_text);
                             add_post(found_user_posts, new_post_text);
                             printf("Post added to your profile.\n");
                             break;
@@ -121,13 +317,25 @@ int main()
                             scanf(" %hu", &post_number);
                             
                             if (delete_post(found_user_posts, post_number)) {
- 
+                                printf("Post %d was deleted successfully!", post_number);
                             } else {
                                 printf("Invalid post number. Try again.\n");
                             }
                             break;
 
                         case 3:
+                            print_pattern(PATTERN_LENGTH, '-');
+                            printf("         %s's news feed", found_user_posts->username);
+                            display_user_feed(found_user_posts);
+                            print_pattern(PATTERN_LENGTH, '-');
+                            break;
+
+                        case 4:
+                            printf("Which page do you want to display? ");
+                            scanf(" %u", &posts_page);
+                            break;
+
+                        case 5:
                             found_user_posts = NULL;
 
                     }                    
@@ -149,7 +357,7 @@ int main()
                     print_pattern(PATTERN_LENGTH, '-');
 
                     unsigned short int friend_choice;
-                    printf("\n1. Display all user's friends \n2. Add a new friend \n3. Delete a friend \n4. Return to main menu");
+                    printf("\n1. Display all user's friends \n2. Add a new friend \n3. Delete a friend \n4. Suggest new friends \n5. Return to main menu");
                     printf("\n\nYour choice: ");
                     scanf(" %hu", &friend_choice);    
 
@@ -162,8 +370,13 @@ int main()
                             char new_friend_name[30];
                             printf("Enter a new friend's name (30 characters max): ");
                             scanf(" %29s", new_friend_name);
-                            add_friend(found_user_friends, new_friend_name);
-                            printf("Friend added to the list.\n");   
+                            if (index_find_user(new_friend_name) == NULL) {
+                                printf("There is no user named %s.\n", new_friend_name);
+                            } else if (add_friend(found_user_friends, new_friend_name)) {
+                                printf("Friend added to the list.\n");   
+                            } else {
+                                printf("%s can not be added as a friend.\n", new_friend_name);
+                            }
                             break;
 
                         case 3:
@@ -181,6 +394,19 @@ int main()
                             break;
 
                         case 4:
+                            recommendation_t suggestions[MAX_SUGGESTIONS];
+                            size_t num_suggestions = recommend_friends(found_user_friends, suggestions, MAX_SUGGESTIONS);
+                            printf("\nPeople %s may know:\n", found_user_friends->username);
+                            if (num_suggestions == 0) {
+                                printf("No suggestions available for %s.\n", found_user_friends->username);
+                            }
+                            for (size_t i = 0; i < num_suggestions; i++) {
+                                printf("%zu- %s (%u mutual friend%s)\n", i + 1, suggestions[i].user->username,
+                                       suggestions[i].mutual_friends, suggestions[i].mutual_friends == 1 ? "" : "s");
+                            }
+                            break;
+
+                        case 5:
                             found_user_friends = NULL;
 
                     }
@@ -192,15 +418,51 @@ int main()
                 break;
 
             case 6:
+                char query[250];
+                printf("Enter words, #hashtags or @mentions to search (OR between alternatives): ");
+                scanf(" %249[^\n]", query);
+                display_search_results(query);
+                break;
+
+            case 7:
+                display_trending_hashtags();
+                break;
+
+            case 8:
+                char checkpoint_path[256];
+                printf("Enter the checkpoint file name: ");
+                scanf("%255s", checkpoint_path);
+                int checkpoint_result = checkpoint_start(checkpoint_path);
+                if (checkpoint_result == 0) {
+                    printf("\n**** Checkpoint started, it is saved in the background ****\n");
+                } else if (checkpoint_result == CHECKPOINT_RUNNING) {
+                    printf("\n**** A checkpoint is already running! ****\n");
+                } else {
+                    printf("\n**** The checkpoint could not be started: %s ****\n", strerror(errno));
+                }
+                break;
+
+            case 9:
+                printf("\n");
+                metrics_report(stdout);
+                break;
+
+            case 10:
                 print_pattern(PATTERN_LENGTH, '*');
                 printf("     Thank you for using Text-Based Facebook\n");
                 printf("                     Goodbye!");
                 print_pattern(PATTERN_LENGTH, '*');
+                wal_close();
                 teardown(users);
                 exit = 1;
                 
         }
 
+        // the changes made by the choice are on the disk before the next one
+        if (wal_commit() != 0) {
+            printf("\n**** The last change could not be saved! ****\n");
+        }
+
     }
 
 }
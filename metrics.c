@@ -0,0 +1,161 @@
+/**
+ * @file metrics.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the instrumentation of the user
+ * operations. The counters of every thread are kept in a list that only grows,
+ * and stay there when the thread exits, so the report still counts them.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <signal.h>
+#include <pthread.h>
+#include "histogram.h"
+#include "metrics.h"
+
+#ifndef NO_METRICS
+
+static const char *op_names[METRICS_OPS] = {
+   "add_user", "find_user", "add_friend", "delete_friend", "add_post", "delete_post",
+   "display_user_posts", "display_user_friends", "display_user_feed", "display_all_posts",
+   "display_search_results", "display_trending", "load_csv", "teardown"
+};
+
+static const char *gauge_names[METRICS_GAUGES] = {
+   "users", "posts", "friendships", "pool bytes", "text arena bytes", "friend set bytes",
+   "post list bytes"
+};
+
+__thread metrics_thread_t *metrics_local = NULL;
+long metrics_gauges[METRICS_GAUGES];
+
+// the counters of every thread that recorded an operation
+static pthread_mutex_t threads_lock = PTHREAD_MUTEX_INITIALIZER;
+static metrics_thread_t *threads = NULL;
+
+
+/*
+   Function that gives the calling thread its counters and adds them to the report.
+   Return the thread's counters.
+*/
+metrics_thread_t *metrics_register_thread()
+{
+   metrics_thread_t *thread = calloc(1, sizeof(metrics_thread_t));
+   assert(thread != NULL);
+   pthread_mutex_lock(&threads_lock);
+   thread->next = threads;
+   threads = thread;
+   pthread_mutex_unlock(&threads_lock);
+   metrics_local = thread;
+   return thread;
+}
+
+
+/*
+   Function that writes the report of the operations and the gauges to a file.
+*/
+void metrics_report(FILE *file)
+{
+   size_t calls[METRICS_OPS];
+   histogram_t latency[METRICS_OPS];
+   memset(calls, 0, sizeof(calls));
+   memset(latency, 0, sizeof(latency));
+
+   // add up the counters of the threads
+   pthread_mutex_lock(&threads_lock);
+   for (const metrics_thread_t *thread = threads; thread != NULL; thread = thread->next) {
+      for (int op = 0; op < METRICS_OPS; op++) {
+         calls[op] += thread->calls[op];
+         latency[op].count += thread->latency[op].count;
+         latency[op].total_ns += thread->latency[op].total_ns;
+         if (thread->latency[op].max_ns > latency[op].max_ns) {
+            latency[op].max_ns = thread->latency[op].max_ns;
+         }
+         for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+            latency[op].buckets[i] += thread->latency[op].buckets[i];
+         }
+      }
+   }
+   pthread_mutex_unlock(&threads_lock);
+
+   fprintf(file, "%-24s %12s %12s %12s %12s %12s\n", "operation", "calls", "mean ns", "p50 ns", "p99 ns", "max ns");
+   for (int op = 0; op < METRICS_OPS; op++) {
+      if (calls[op] == 0) {
+         continue;
+      }
+      const histogram_t *histogram = &latency[op];
+      fprintf(file, "%-24s %12zu %12.0f %12llu %12llu %12llu\n", op_names[op], calls[op],
+              histogram->count > 0 ? (double)histogram->total_ns / histogram->count : 0.0,
+              histogram_percentile(histogram, 0.5), histogram_percentile(histogram, 0.99), histogram->max_ns);
+   }
+   for (int gauge = 0; gauge < METRICS_GAUGES; gauge++) {
+      fprintf(file, "%-24s %12ld\n", gauge_names[gauge], __atomic_load_n(&metrics_gauges[gauge], __ATOMIC_RELAXED));
+   }
+   fflush(file);
+}
+
+
+/*
+   Function that waits for SIGUSR1 and writes the report to the standard error, forever.
+*/
+static void *signal_reporter(void *argument)
+{
+   sigset_t *signals = argument;
+   int signal;
+   while (sigwait(signals, &signal) == 0) {
+      metrics_report(stderr);
+   }
+   return NULL;
+}
+
+
+/*
+   Function that starts a thread that writes the report to the standard error every time the
+   program receives SIGUSR1. Return 0 on success and -1 on error.
+*/
+int metrics_start_signal_report()
+{
+   // the signal is blocked in every thread and taken by the reporter with sigwait,
+   // so the report is not written from a signal handler
+   static sigset_t signals;
+   sigemptyset(&signals);
+   sigaddset(&signals, SIGUSR1);
+   if (pthread_sigmask(SIG_BLOCK, &signals, NULL) != 0) {
+      return -1;
+   }
+
+   pthread_t reporter;
+   if (pthread_create(&reporter, NULL, signal_reporter, &signals) != 0) {
+      return -1;
+   }
+   pthread_detach(reporter);
+   return 0;
+}
+
+#else
+
+
+/*
+   Function that writes that the program was compiled without instrumentation.
+*/
+void metrics_report(FILE *file)
+{
+   fprintf(file, "There are no statistics, the program was compiled with NO_METRICS.\n");
+   fflush(file);
+}
+
+
+/*
+   Function that does nothing, as there is no report without instrumentation. Return 0.
+*/
+int metrics_start_signal_report()
+{
+   return 0;
+}
+
+#endif
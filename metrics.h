@@ -0,0 +1,152 @@
+/**
+ * @file metrics.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the instrumentation of the user operations: how
+ * many times each operation ran, a latency histogram per operation and gauges
+ * of the number of users, posts and friendships and of the memory held by the
+ * allocators.
+ *
+ * Every thread counts its operations in its own counters, which the report
+ * adds up, so recording an operation takes no lock. Only one call in
+ * METRICS_SAMPLE_RATE of the short operations is timed, the long ones always
+ * are. The report is shown by the menu and written to the standard error when
+ * the program receives SIGUSR1; a report taken while other threads run may
+ * miss the operations they are in the middle of.
+ *
+ * Compiling with -DNO_METRICS removes the instrumentation: the macros below
+ * expand to nothing and the report says that there are no statistics. Its
+ * cost is measured by running the benchmark suite built with and without it.
+ */
+
+#ifndef __A2_METRICS_H__
+#define __A2_METRICS_H__
+#include <stdio.h>
+#include "histogram.h"
+
+#define METRICS_SAMPLE_RATE 64   // a power of two
+
+// The instrumented operations. An operation reached by name and by id, such as
+// add_friend and add_friend_id, is counted once, by the function both reach.
+// The operations from METRICS_LONG_OPS on are long and always timed.
+typedef enum metrics_op
+{
+    OP_ADD_USER,
+    OP_FIND_USER,
+    OP_ADD_FRIEND,
+    OP_DELETE_FRIEND,
+    OP_ADD_POST,
+    OP_DELETE_POST,
+    OP_DISPLAY_POSTS,
+    METRICS_LONG_OPS = OP_DISPLAY_POSTS,
+    OP_DISPLAY_FRIENDS,
+    OP_DISPLAY_FEED,
+    OP_DISPLAY_ALL_POSTS,
+    OP_DISPLAY_SEARCH,
+    OP_DISPLAY_TRENDING,
+    OP_LOAD_CSV,
+    OP_TEARDOWN,
+    METRICS_OPS
+} metrics_op_t;
+
+// The gauges, values that go up and down
+typedef enum metrics_gauge
+{
+    GAUGE_USERS,
+    GAUGE_POSTS,
+    GAUGE_FRIENDSHIPS,
+    GAUGE_POOL_BYTES,           // slabs of the node pools
+    GAUGE_TEXT_BYTES,           // blocks of the text arena
+    GAUGE_FRIEND_SET_BYTES,     // arrays and hash sets of friend ids
+    GAUGE_POST_LIST_BYTES,      // blocks of the users' post lists
+    METRICS_GAUGES
+} metrics_gauge_t;
+
+// The counters of a thread
+typedef struct metrics_thread
+{
+    size_t calls[METRICS_OPS];
+    histogram_t latency[METRICS_OPS];   // of the timed calls
+    struct metrics_thread *next;
+} metrics_thread_t;
+
+// An operation in progress
+typedef struct metrics_scope
+{
+    metrics_thread_t *thread;
+    metrics_op_t op;
+    unsigned long long start;   // 0 when the call is not timed
+} metrics_scope_t;
+
+#ifndef NO_METRICS
+
+extern __thread metrics_thread_t *metrics_local;
+extern long metrics_gauges[METRICS_GAUGES];
+
+/*
+   Function that gives the calling thread its counters and adds them to the report.
+   Return the thread's counters.
+*/
+metrics_thread_t *metrics_register_thread();
+
+/*
+   Function that counts a call of an operation and starts timing it if it is one of the timed calls.
+   Return the operation in progress, for metrics_end.
+*/
+static inline metrics_scope_t metrics_begin(metrics_op_t op)
+{
+   metrics_thread_t *thread = metrics_local != NULL ? metrics_local : metrics_register_thread();
+   metrics_scope_t scope = { thread, op, 0 };
+   if (op >= METRICS_LONG_OPS || thread->calls[op] % METRICS_SAMPLE_RATE == 0) {
+      scope.start = histogram_now_ns();
+   }
+   thread->calls[op]++;
+   return scope;
+}
+
+/*
+   Function that records the latency of an operation started by metrics_begin, if it was timed.
+*/
+static inline void metrics_end(metrics_scope_t *scope)
+{
+   if (scope->start != 0) {
+      histogram_add(&scope->thread->latency[scope->op], histogram_now_ns() - scope->start);
+   }
+}
+
+/*
+   Macro that counts and times the rest of the enclosing block as an operation.
+*/
+#define METRICS_SCOPE(op) \
+   metrics_scope_t metrics_scope_ __attribute__((cleanup(metrics_end), unused)) = metrics_begin(op)
+
+/*
+   Macros that change a gauge by delta and set it to a value.
+*/
+#define METRICS_GAUGE_ADD(gauge, delta) __atomic_add_fetch(&metrics_gauges[gauge], (delta), __ATOMIC_RELAXED)
+#define METRICS_GAUGE_SET(gauge, value) __atomic_store_n(&metrics_gauges[gauge], (value), __ATOMIC_RELAXED)
+
+#else
+
+#define METRICS_SCOPE(op)
+#define METRICS_GAUGE_ADD(gauge, delta)
+#define METRICS_GAUGE_SET(gauge, value)
+
+#endif
+
+/*
+   Function that writes the report of the operations and the gauges to a file.
+*/
+void metrics_report(FILE *file);
+
+/*
+   Function that starts a thread that writes the report to the standard error every time the
+   program receives SIGUSR1. It must be called before the program starts other threads, which
+   inherit the blocked signal. Return 0 on success and -1 on error.
+*/
+int metrics_start_signal_report();
+
+
+#endif
@@ -11,29 +11,97 @@
 
 #ifndef __A2_NODES_H__
 #define __A2_NODES_H__
+#include <time.h>
+#include <stdint.h>
+
+#define CREDENTIAL_SALT_SIZE 16
+#define CREDENTIAL_HASH_SIZE 32
+
+// Structure to represent a salted hash of a user's password, see password.h
+typedef struct credential
+{
+    uint32_t iterations;        // rounds of the hash function, 0 if no password was set
+    unsigned char salt[CREDENTIAL_SALT_SIZE];
+    unsigned char hash[CREDENTIAL_HASH_SIZE];
+} credential_t;
+
+// Structure to represent a user's friends as a set of user ids. The ids are kept
+// sorted; users with many friends also get a hash set for constant time lookups.
+typedef struct friend_set
+{
+    unsigned int *ids;
+    unsigned int count;
+    unsigned int capacity;
+    unsigned int *slots;        // open addressing set of id + 1, 0 marks an empty slot
+    unsigned int slot_count;    // always a power of two, 0 when there is no hash set
+} friend_set_t;
+
+// Structure to represent a post in a user's news feed
+typedef struct timeline_entry
+{
+    unsigned long post_id;
+    unsigned int author;        // lets the feed skip former friends without reading their posts
+} timeline_entry_t;
+
+// Structure to represent a user's news feed: the friends' latest posts, oldest first,
+// in a ring buffer that drops the oldest post when it is full
+typedef struct timeline
+{
+    timeline_entry_t *entries;
+    unsigned int start;         // position of the oldest post
+    unsigned int count;
+    _Bool built;                // false until the feed is first read, and after the friends change
+} timeline_t;
+
+#define POST_CHUNK_SIZE 32
+
+// Structure to represent a block of a user's posts, oldest first
+typedef struct post_chunk
+{
+    unsigned int count;
+    struct post_chunk *older;   // the next block, with the user's older posts
+    struct post_chunk *newer;
+    struct post *posts[POST_CHUNK_SIZE];
+} post_chunk_t;
+
+// Structure to represent a user's posts in an unrolled list of blocks, the newest block first
+typedef struct post_list
+{
+    post_chunk_t *newest;
+    unsigned int count;
+} post_list_t;
+
+// Structure to represent a position in a user's posts, going from the newest to the oldest
+typedef struct post_cursor
+{
+    const post_chunk_t *chunk;
+    unsigned int index;         // the number of posts of the block that are not read yet
+} post_cursor_t;
 
 // Structure to represent a linked list of users
 typedef struct user
 {
+    unsigned int id;            // dense id given by the user index, starting at 0
+    unsigned int shard;         // shard of the user index that holds the user
+    unsigned int checkpoint_epoch; // the last checkpoint that saved the user, see checkpoint.c
     char username[30];
-    char password[15];
-    struct friend *friends;
-    struct post *posts;
+    credential_t credential;
+    friend_set_t friends;
+    post_list_t posts;
+    timeline_t *timeline;       // NULL until the user's feed is first read
     struct user *next;
 } user_t;
 
-// Structure to represent linked list of a user's friends
-typedef struct friend
-{
-    char username[30];
-    struct friend *next;
-} friend_t;
-
-// Structure to represent linked list of a user's posts
+// Structure to represent a user's post
 typedef struct post
 {
-    char content[250];
-    struct post *next;
+    unsigned long id;         // posts are numbered from 1 in the order they were added
+    time_t created;
+    unsigned int author;      // id of the user who wrote the post
+    unsigned int length;
+    const char *content;      // stored in the text arena or a mapped snapshot, terminated by '\0'
+    post_chunk_t *chunk;      // the block of the author's posts that holds the post, so a post is
+                              // removed without walking the list
 } post_t;
 
 
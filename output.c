@@ -0,0 +1,250 @@
+/**
+ * @file output.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the buffered output. The pieces
+ * of a writev are the copied texts, each run of them contiguous in the
+ * buffer, and the referenced texts in between.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include "output.h"
+
+static char buffer[OUTPUT_BUFFER_SIZE];
+static size_t used = 0;
+static struct iovec pieces[OUTPUT_MAX_PIECES];
+static int num_pieces = 0;
+static size_t written = 0;
+
+
+/*
+   Function that writes the pieces to the standard output, after what stdio holds.
+   Return 0 on success and -1 if the output could not be written.
+*/
+int output_flush()
+{
+   int result = 0;
+   fflush(stdout);
+
+   struct iovec *piece = pieces;
+   int count = num_pieces;
+   while (count > 0) {
+      ssize_t size = writev(STDOUT_FILENO, piece, count);
+      if (size < 0) {
+         if (errno == EINTR) {
+            continue;
+         }
+         result = -1;
+         break;
+      }
+      written += size;
+
+      // skip the pieces written, and the part written of the next one
+      while (count > 0 && (size_t)size >= piece->iov_len) {
+         size -= piece->iov_len;
+         piece++;
+         count--;
+      }
+      if (count > 0) {
+         piece->iov_base = (char *)piece->iov_base + size;
+         piece->iov_len -= size;
+      }
+   }
+
+   used = 0;
+   num_pieces = 0;
+   return result;
+}
+
+
+/*
+   Function that adds a piece that references text, writing the output first if there is no room.
+*/
+static void add_reference(const char *text, size_t length)
+{
+   if (num_pieces == OUTPUT_MAX_PIECES) {
+      output_flush();
+   }
+   pieces[num_pieces].iov_base = (char *)text;
+   pieces[num_pieces].iov_len = length;
+   num_pieces++;
+}
+
+
+/*
+   Function that makes room for length bytes at the end of the buffer, writing the output if needed.
+   Return where the bytes go. length must not be above OUTPUT_BUFFER_SIZE.
+*/
+static char *reserve(size_t length)
+{
+   if (used + length > OUTPUT_BUFFER_SIZE
+       || (num_pieces == OUTPUT_MAX_PIECES && (char *)pieces[num_pieces - 1].iov_base + pieces[num_pieces - 1].iov_len != &buffer[used])) {
+      output_flush();
+   }
+   return &buffer[used];
+}
+
+
+/*
+   Function that adds the length bytes just written at the end of the buffer to the pieces.
+*/
+static void commit(size_t length)
+{
+   if (length == 0) {
+      return;
+   }
+   char *start = &buffer[used];
+   used += length;
+   // a copy that follows another copy extends its piece
+   if (num_pieces > 0 && (char *)pieces[num_pieces - 1].iov_base + pieces[num_pieces - 1].iov_len == start) {
+      pieces[num_pieces - 1].iov_len += length;
+   } else {
+      add_reference(start, length);
+   }
+}
+
+
+/*
+   Function that adds text of a given length to the output. Texts of OUTPUT_COPY_LIMIT
+   characters or more are not copied and must not change until the next output_flush.
+*/
+void output_write(const char *text, size_t length)
+{
+   if (length >= OUTPUT_COPY_LIMIT) {
+      add_reference(text, length);
+      return;
+   }
+   memcpy(reserve(length), text, length);
+   commit(length);
+}
+
+
+/*
+   Function that adds a string to the output, as output_write does.
+*/
+void output_string(const char *text)
+{
+   output_write(text, strlen(text));
+}
+
+
+/*
+   Function that adds a number to the output.
+*/
+void output_number(unsigned long number)
+{
+   char digits[20];
+   size_t count = 0;
+   do {
+      digits[count++] = '0' + number % 10;
+      number /= 10;
+   } while (number > 0);
+
+   char *text = reserve(count);
+   for (size_t i = 0; i < count; i++) {
+      text[i] = digits[count - 1 - i];
+   }
+   commit(count);
+}
+
+
+/*
+   Function that adds a character repeated a number of times to the output.
+*/
+void output_repeat(char character, size_t count)
+{
+   while (count > 0) {
+      size_t length = count < OUTPUT_COPY_LIMIT ? count : OUTPUT_COPY_LIMIT;
+      memset(reserve(length), character, length);
+      commit(length);
+      count -= length;
+   }
+}
+
+
+/*
+   Function that adds formatted text to the output, as printf does.
+*/
+void output_printf(const char *format, ...)
+{
+   va_list arguments;
+   va_start(arguments, format);
+   char *text = reserve(0);
+   int length = vsnprintf(text, OUTPUT_BUFFER_SIZE - used, format, arguments);
+   va_end(arguments);
+   if (length < 0) {
+      return;
+   }
+
+   if ((size_t)length >= OUTPUT_BUFFER_SIZE - used) {
+      // it did not fit, format it again in an empty buffer or, if it is too long for the buffer, apart
+      output_flush();
+      va_start(arguments, format);
+      if (length < OUTPUT_BUFFER_SIZE) {
+         vsnprintf(buffer, OUTPUT_BUFFER_SIZE, format, arguments);
+      } else {
+         char *long_text = malloc(length + 1);
+         if (long_text != NULL) {
+            vsnprintf(long_text, length + 1, format, arguments);
+            add_reference(long_text, length);
+            output_flush();
+            free(long_text);
+         }
+         length = 0;
+      }
+      va_end(arguments);
+   }
+   commit(length);
+}
+
+
+/*
+   Function that returns the number of bytes written by the output since the program started.
+*/
+size_t output_bytes_written()
+{
+   return written;
+}
+
+
+/*
+   Function that starts a display of pages of page_lines lines, asking prompt between the pages.
+*/
+void pager_start(pager_t *pager, unsigned int page_lines, const char *prompt)
+{
+   // as with more, output sent to a file or a pipe is not paged
+   pager->page_lines = isatty(STDOUT_FILENO) ? page_lines : 0;
+   pager->lines = 0;
+   pager->prompt = prompt;
+}
+
+
+/*
+   Function that must be called before every line of a paged display. When the page is full,
+   it writes the output and asks the user if they want the next page.
+   Return false if the user does not want more lines.
+*/
+_Bool pager_next_line(pager_t *pager)
+{
+   if (pager->page_lines == 0 || pager->lines < pager->page_lines) {
+      pager->lines++;
+      return 1;
+   }
+
+   output_string(pager->prompt);
+   output_flush();
+   char choice;
+   if (scanf(" %c", &choice) != 1 || choice == 'n' || choice == 'N') {
+      return 0;  // no answer, as at the end of a file, means no
+   }
+   pager->lines = 1;
+   return 1;
+}
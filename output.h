@@ -0,0 +1,88 @@
+/**
+ * @file output.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the buffered output of the displays. Short texts
+ * are copied into a buffer and long ones, such as the posts' contents, are
+ * only referenced; the buffer and the references are written to the standard
+ * output together, with a single writev, when the buffer is full or flushed.
+ *
+ * Anything printed with stdio before the buffered output is written first,
+ * but a display must call output_flush before it prints with stdio or reads
+ * the standard input again. The output is only used by the menu's thread.
+ *
+ * A pager splits a long display into pages and asks the user if they want to
+ * see the next page before it starts. Like more, it only pages the output
+ * shown on a terminal.
+ */
+
+#ifndef __A2_OUTPUT_H__
+#define __A2_OUTPUT_H__
+#include <stddef.h>
+
+#define OUTPUT_BUFFER_SIZE (64 * 1024)
+#define OUTPUT_MAX_PIECES 64    // texts written by a single writev
+#define OUTPUT_COPY_LIMIT 128   // longer texts are referenced instead of copied
+
+// A display split in pages of a number of lines
+typedef struct pager
+{
+    unsigned int page_lines;    // 0 when the display is not split
+    unsigned int lines;         // lines started on the current page
+    const char *prompt;         // the question asked between pages
+} pager_t;
+
+/*
+   Function that adds text of a given length to the output. Texts of OUTPUT_COPY_LIMIT
+   characters or more are not copied and must not change until the next output_flush.
+*/
+void output_write(const char *text, size_t length);
+
+/*
+   Function that adds a string to the output, as output_write does.
+*/
+void output_string(const char *text);
+
+/*
+   Function that adds a number to the output.
+*/
+void output_number(unsigned long number);
+
+/*
+   Function that adds a character repeated a number of times to the output.
+*/
+void output_repeat(char character, size_t count);
+
+/*
+   Function that adds formatted text to the output, as printf does.
+*/
+void output_printf(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+/*
+   Function that writes the output to the standard output, after what stdio holds.
+   Return 0 on success and -1 if the output could not be written.
+*/
+int output_flush();
+
+/*
+   Function that returns the number of bytes written by the output since the program started.
+*/
+size_t output_bytes_written();
+
+/*
+   Function that starts a display of pages of page_lines lines, asking prompt between the pages.
+   The display is not split if the standard output is not a terminal.
+*/
+void pager_start(pager_t *pager, unsigned int page_lines, const char *prompt);
+
+/*
+   Function that must be called before every line of a paged display. When the page is full,
+   it writes the output and asks the user if they want the next page.
+   Return false if the user does not want more lines.
+*/
+_Bool pager_next_line(pager_t *pager);
+
+
+#endif
@@ -0,0 +1,470 @@
+/**
+ * @file password.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the password hashing: SHA-256
+ * (FIPS 180-4), HMAC-SHA256 (RFC 2104) and PBKDF2 (RFC 8018) with a single
+ * block of output, as long as the SHA-256 hash.
+ *
+ * The inner and outer HMAC states of a password are computed once, so every
+ * round of PBKDF2 costs two SHA-256 blocks. The bulk functions start their
+ * threads for the call; each thread takes the next range of passwords until
+ * there are none left.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/random.h>
+#include "nodes.h"
+#include "password.h"
+
+#define SHA256_BLOCK_SIZE 64
+#define CREDENTIAL_PREFIX "pbkdf2-sha256$"
+#define JOBS_PER_TAKE 16
+
+// State of a SHA-256 computation
+typedef struct sha256
+{
+    uint32_t state[8];
+    uint64_t length;                        // bytes hashed so far
+    unsigned char block[SHA256_BLOCK_SIZE]; // the bytes of the block being filled
+    size_t used;
+} sha256_t;
+
+// The work shared by the threads of a bulk function
+typedef struct bulk
+{
+    password_job_t *jobs;
+    size_t count;
+    size_t next;                            // the first job not taken yet
+    _Bool verify;
+    size_t verified;
+} bulk_t;
+
+static uint32_t iterations = PASSWORD_ITERATIONS;   // rounds of the credentials made from now on
+
+static const uint32_t round_constants[64] = {
+   0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+   0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+   0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+   0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+   0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+   0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+   0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+   0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+
+/*
+   Function that rotates a 32-bit word right.
+*/
+static uint32_t rotate(uint32_t word, int bits)
+{
+   return (word >> bits) | (word << (32 - bits));
+}
+
+
+/*
+   Function that mixes a 64-byte block into a SHA-256 state.
+*/
+static void sha256_block(uint32_t state[8], const unsigned char *block)
+{
+   uint32_t w[64];
+   for (int i = 0; i < 16; i++) {
+      w[i] = (uint32_t)block[4 * i] << 24 | (uint32_t)block[4 * i + 1] << 16
+             | (uint32_t)block[4 * i + 2] << 8 | block[4 * i + 3];
+   }
+   for (int i = 16; i < 64; i++) {
+      uint32_t s0 = rotate(w[i - 15], 7) ^ rotate(w[i - 15], 18) ^ (w[i - 15] >> 3);
+      uint32_t s1 = rotate(w[i - 2], 17) ^ rotate(w[i - 2], 19) ^ (w[i - 2] >> 10);
+      w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+   }
+
+   uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+   uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+   for (int i = 0; i < 64; i++) {
+      uint32_t t1 = h + (rotate(e, 6) ^ rotate(e, 11) ^ rotate(e, 25)) + ((e & f) ^ (~e & g))
+                    + round_constants[i] + w[i];
+      uint32_t t2 = (rotate(a, 2) ^ rotate(a, 13) ^ rotate(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + t2;
+   }
+   state[0] += a;
+   state[1] += b;
+   state[2] += c;
+   state[3] += d;
+   state[4] += e;
+   state[5] += f;
+   state[6] += g;
+   state[7] += h;
+}
+
+
+/*
+   Function that starts a SHA-256 computation.
+*/
+static void sha256_init(sha256_t *sha)
+{
+   static const uint32_t initial[8] = {
+      0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+   };
+   memcpy(sha->state, initial, sizeof(initial));
+   sha->length = 0;
+   sha->used = 0;
+}
+
+
+/*
+   Function that adds bytes to a SHA-256 computation.
+*/
+static void sha256_update(sha256_t *sha, const void *data, size_t size)
+{
+   const unsigned char *bytes = data;
+   sha->length += size;
+   while (size > 0) {
+      size_t chunk = SHA256_BLOCK_SIZE - sha->used;
+      if (chunk > size) {
+         chunk = size;
+      }
+      memcpy(sha->block + sha->used, bytes, chunk);
+      sha->used += chunk;
+      bytes += chunk;
+      size -= chunk;
+      if (sha->used == SHA256_BLOCK_SIZE) {
+         sha256_block(sha->state, sha->block);
+         sha->used = 0;
+      }
+   }
+}
+
+
+/*
+   Function that pads the last block of a SHA-256 computation and writes the 32-byte hash.
+*/
+static void sha256_final(sha256_t *sha, unsigned char *hash)
+{
+   uint64_t bits = sha->length * 8;
+   sha->block[sha->used++] = 0x80;
+   if (sha->used > SHA256_BLOCK_SIZE - 8) {
+      memset(sha->block + sha->used, 0, SHA256_BLOCK_SIZE - sha->used);
+      sha256_block(sha->state, sha->block);
+      sha->used = 0;
+   }
+   memset(sha->block + sha->used, 0, SHA256_BLOCK_SIZE - 8 - sha->used);
+   for (int i = 0; i < 8; i++) {
+      sha->block[SHA256_BLOCK_SIZE - 1 - i] = (unsigned char)(bits >> (8 * i));
+   }
+   sha256_block(sha->state, sha->block);
+   for (int i = 0; i < 8; i++) {
+      hash[4 * i] = (unsigned char)(sha->state[i] >> 24);
+      hash[4 * i + 1] = (unsigned char)(sha->state[i] >> 16);
+      hash[4 * i + 2] = (unsigned char)(sha->state[i] >> 8);
+      hash[4 * i + 3] = (unsigned char)sha->state[i];
+   }
+}
+
+
+/*
+   Function that hashes a 32-byte message from a state that has already hashed one block,
+   as both HMAC steps of a PBKDF2 round do. The message and the padding fit in one block.
+*/
+static void hash_after_key(const uint32_t key_state[8], const unsigned char *message, unsigned char *hash)
+{
+   unsigned char block[SHA256_BLOCK_SIZE];
+   uint32_t state[8];
+   memcpy(block, message, CREDENTIAL_HASH_SIZE);
+   memset(block + CREDENTIAL_HASH_SIZE, 0, SHA256_BLOCK_SIZE - CREDENTIAL_HASH_SIZE);
+   block[CREDENTIAL_HASH_SIZE] = 0x80;
+   // the length of the key block and of the message, in bits
+   block[SHA256_BLOCK_SIZE - 2] = ((SHA256_BLOCK_SIZE + CREDENTIAL_HASH_SIZE) * 8) >> 8;
+   block[SHA256_BLOCK_SIZE - 1] = ((SHA256_BLOCK_SIZE + CREDENTIAL_HASH_SIZE) * 8) & 0xff;
+
+   memcpy(state, key_state, sizeof(state));
+   sha256_block(state, block);
+   for (int i = 0; i < 8; i++) {
+      hash[4 * i] = (unsigned char)(state[i] >> 24);
+      hash[4 * i + 1] = (unsigned char)(state[i] >> 16);
+      hash[4 * i + 2] = (unsigned char)(state[i] >> 8);
+      hash[4 * i + 3] = (unsigned char)state[i];
+   }
+}
+
+
+/*
+   Function that computes PBKDF2-HMAC-SHA256 of a password and a salt with a number of rounds,
+   and writes the first 32-byte block of the result.
+*/
+static void pbkdf2(const char *password, const unsigned char *salt, size_t salt_size, uint32_t rounds,
+                   unsigned char *result)
+{
+   // keys longer than a block are hashed first
+   unsigned char key[SHA256_BLOCK_SIZE];
+   size_t key_size = strlen(password);
+   memset(key, 0, sizeof(key));
+   if (key_size > SHA256_BLOCK_SIZE) {
+      sha256_t sha;
+      sha256_init(&sha);
+      sha256_update(&sha, password, key_size);
+      sha256_final(&sha, key);
+   } else {
+      memcpy(key, password, key_size);
+   }
+
+   // the states after the key xor-ed with the inner and outer pads are the same for every round
+   unsigned char pad[SHA256_BLOCK_SIZE];
+   sha256_t inner;
+   sha256_t outer;
+   for (int i = 0; i < SHA256_BLOCK_SIZE; i++) {
+      pad[i] = key[i] ^ 0x36;
+   }
+   sha256_init(&inner);
+   sha256_update(&inner, pad, SHA256_BLOCK_SIZE);
+   for (int i = 0; i < SHA256_BLOCK_SIZE; i++) {
+      pad[i] = key[i] ^ 0x5c;
+   }
+   sha256_init(&outer);
+   sha256_update(&outer, pad, SHA256_BLOCK_SIZE);
+
+   // the first round hashes the salt and the block number 1
+   unsigned char u[CREDENTIAL_HASH_SIZE];
+   const unsigned char block_number[4] = { 0, 0, 0, 1 };
+   sha256_t sha = inner;
+   sha256_update(&sha, salt, salt_size);
+   sha256_update(&sha, block_number, sizeof(block_number));
+   sha256_final(&sha, u);
+   sha = outer;
+   sha256_update(&sha, u, CREDENTIAL_HASH_SIZE);
+   sha256_final(&sha, u);
+   memcpy(result, u, CREDENTIAL_HASH_SIZE);
+
+   for (uint32_t round = 1; round < rounds; round++) {
+      hash_after_key(inner.state, u, u);
+      hash_after_key(outer.state, u, u);
+      for (int i = 0; i < CREDENTIAL_HASH_SIZE; i++) {
+         result[i] ^= u[i];
+      }
+   }
+}
+
+
+/*
+   Function that fills a buffer with random bytes from the system.
+*/
+static void random_bytes(unsigned char *buffer, size_t size)
+{
+   while (size > 0) {
+      ssize_t got = getrandom(buffer, size, 0);
+      if (got <= 0) {
+         perror("Error reading random bytes");
+         exit(1);
+      }
+      buffer += got;
+      size -= got;
+   }
+}
+
+
+/*
+   Function that sets the rounds of the credentials made from now on.
+*/
+void password_set_iterations(uint32_t rounds)
+{
+   __atomic_store_n(&iterations, rounds > 0 ? rounds : 1, __ATOMIC_RELAXED);
+}
+
+
+/*
+   Function that makes a credential for a password, with a new random salt.
+*/
+void password_hash(const char *password, credential_t *credential)
+{
+   credential->iterations = __atomic_load_n(&iterations, __ATOMIC_RELAXED);
+   random_bytes(credential->salt, CREDENTIAL_SALT_SIZE);
+   pbkdf2(password, credential->salt, CREDENTIAL_SALT_SIZE, credential->iterations, credential->hash);
+}
+
+
+/*
+   Function that checks a password against a credential, in a time that does not depend on
+   how much of the hash matches. Return true if the password is the right one.
+*/
+_Bool password_verify(const char *password, const credential_t *credential)
+{
+   if (credential->iterations == 0) {
+      return 0; // no password was set
+   }
+   unsigned char hash[CREDENTIAL_HASH_SIZE];
+   pbkdf2(password, credential->salt, CREDENTIAL_SALT_SIZE, credential->iterations, hash);
+   unsigned char difference = 0;
+   for (int i = 0; i < CREDENTIAL_HASH_SIZE; i++) {
+      difference |= hash[i] ^ credential->hash[i];
+   }
+   return difference == 0;
+}
+
+
+/*
+   Function that writes bytes in lower case hexadecimal and returns the end of the text.
+*/
+static char *write_hex(char *text, const unsigned char *bytes, size_t size)
+{
+   static const char digits[] = "0123456789abcdef";
+   for (size_t i = 0; i < size; i++) {
+      *text++ = digits[bytes[i] >> 4];
+      *text++ = digits[bytes[i] & 0xf];
+   }
+   return text;
+}
+
+
+/*
+   Function that reads bytes written in hexadecimal and moves the text past them.
+   Return false if the text does not start with size bytes in hexadecimal.
+*/
+static _Bool read_hex(const char **text, unsigned char *bytes, size_t size)
+{
+   for (size_t i = 0; i < 2 * size; i++) {
+      char c = (*text)[i];
+      int value = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+      if (value < 0) {
+         return 0;
+      }
+      bytes[i / 2] = i % 2 == 0 ? value << 4 : bytes[i / 2] | value;
+   }
+   *text += 2 * size;
+   return 1;
+}
+
+
+/*
+   Function that writes a credential as text, in a buffer of CREDENTIAL_TEXT_SIZE bytes.
+*/
+void credential_encode(const credential_t *credential, char *text)
+{
+   text += sprintf(text, CREDENTIAL_PREFIX "%u$", credential->iterations);
+   text = write_hex(text, credential->salt, CREDENTIAL_SALT_SIZE);
+   *text++ = '$';
+   text = write_hex(text, credential->hash, CREDENTIAL_HASH_SIZE);
+   *text = '\0';
+}
+
+
+/*
+   Function that reads a credential written by credential_encode.
+   Return true on success and false if the text is not a credential.
+*/
+_Bool credential_decode(const char *text, credential_t *credential)
+{
+   if (strncmp(text, CREDENTIAL_PREFIX, strlen(CREDENTIAL_PREFIX)) != 0) {
+      return 0;
+   }
+   char *end;
+   text += strlen(CREDENTIAL_PREFIX);
+   unsigned long iterations = strtoul(text, &end, 10);
+   if (end == text || *end != '$' || iterations == 0 || iterations > UINT32_MAX) {
+      return 0;
+   }
+   text = end + 1;
+   credential->iterations = iterations;
+   return read_hex(&text, credential->salt, CREDENTIAL_SALT_SIZE) && *text++ == '$'
+          && read_hex(&text, credential->hash, CREDENTIAL_HASH_SIZE) && *text == '\0';
+}
+
+
+/*
+   Function that returns the number of processors, the default number of threads of the bulk functions.
+*/
+int password_threads()
+{
+   long processors = sysconf(_SC_NPROCESSORS_ONLN);
+   return processors > 0 ? (int)processors : 1;
+}
+
+
+/*
+   Function that hashes or verifies the jobs of a bulk function, a range at a time, until none are left.
+*/
+static void *run_bulk(void *argument)
+{
+   bulk_t *bulk = argument;
+   size_t verified = 0;
+   while (1) {
+      size_t first = __atomic_fetch_add(&bulk->next, JOBS_PER_TAKE, __ATOMIC_RELAXED);
+      if (first >= bulk->count) {
+         break;
+      }
+      size_t last = first + JOBS_PER_TAKE < bulk->count ? first + JOBS_PER_TAKE : bulk->count;
+      for (size_t i = first; i < last; i++) {
+         password_job_t *job = &bulk->jobs[i];
+         if (!bulk->verify) {
+            password_hash(job->password, job->credential);
+            continue;
+         }
+         job->verified = password_verify(job->password, job->credential);
+         if (job->verified) {
+            verified++;
+            if (job->credential->iterations < __atomic_load_n(&iterations, __ATOMIC_RELAXED)) {
+               password_hash(job->password, job->credential);
+            }
+         }
+      }
+   }
+   __atomic_fetch_add(&bulk->verified, verified, __ATOMIC_RELAXED);
+   return NULL;
+}
+
+
+/*
+   Function that runs the jobs of a bulk function on a number of threads, the calling one included.
+*/
+static void run_threads(bulk_t *bulk, int threads)
+{
+   pthread_t *workers = malloc((threads > 1 ? threads - 1 : 1) * sizeof(pthread_t));
+   int started = 0;
+   while (workers != NULL && started < threads - 1
+          && pthread_create(&workers[started], NULL, run_bulk, bulk) == 0) {
+      started++;
+   }
+   run_bulk(bulk);
+   for (int i = 0; i < started; i++) {
+      pthread_join(workers[i], NULL);
+   }
+   free(workers);
+}
+
+
+/*
+   Function that makes the credentials of count passwords, spreading the work over a number of threads.
+*/
+void password_hash_all(password_job_t *jobs, size_t count, int threads)
+{
+   bulk_t bulk = { jobs, count, 0, 0, 0 };
+   run_threads(&bulk, threads);
+}
+
+
+/*
+   Function that verifies count passwords against their credentials with a number of threads.
+   The credentials of the right passwords that were made with fewer rounds than
+   the current ones are made again with the current rounds.
+   Return the number of right passwords.
+*/
+size_t password_verify_all(password_job_t *jobs, size_t count, int threads)
+{
+   bulk_t bulk = { jobs, count, 0, 1, 0 };
+   run_threads(&bulk, threads);
+   return bulk.verified;
+}
+
@@ -0,0 +1,87 @@
+/**
+ * @file password.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the password hashing. Passwords are never
+ * stored: a user keeps a credential made of a random salt and the
+ * PBKDF2-HMAC-SHA256 hash of the password with that salt, which takes
+ * thousands of rounds of SHA-256 to compute for every password guessed.
+ *
+ * The number of rounds is stored with every credential, so it can be raised
+ * later; the credentials made with fewer rounds are hashed again the next
+ * time their password is verified in bulk.
+ *
+ * The passwords of a CSV file are hashed in bulk when it is loaded, with the
+ * same rounds as every other credential.
+ */
+
+#ifndef __A2_PASSWORD_H__
+#define __A2_PASSWORD_H__
+#include <stddef.h>
+#include <stdint.h>
+#include "nodes.h"
+
+#define PASSWORD_ITERATIONS 4096
+#define PASSWORD_MAX_LENGTH 128
+
+// Size of a credential written as text: "pbkdf2-sha256$<rounds>$<salt in hex>$<hash in hex>"
+#define CREDENTIAL_TEXT_SIZE (14 + 10 + 1 + 2 * CREDENTIAL_SALT_SIZE + 1 + 2 * CREDENTIAL_HASH_SIZE + 1)
+
+// A password to hash or to verify in bulk
+typedef struct password_job
+{
+    credential_t *credential;   // the credential to make, or to verify and upgrade
+    const char *password;
+    _Bool verified;             // set by password_verify_all
+} password_job_t;
+
+/*
+   Function that sets the rounds of the credentials made from now on, PASSWORD_ITERATIONS
+   by default. Fewer rounds are only meant for tests and benchmarks of other parts.
+*/
+void password_set_iterations(uint32_t rounds);
+
+/*
+   Function that makes a credential for a password, with a new random salt.
+*/
+void password_hash(const char *password, credential_t *credential);
+
+/*
+   Function that checks a password against a credential, in a time that does not depend on
+   how much of the hash matches. Return true if the password is the right one.
+*/
+_Bool password_verify(const char *password, const credential_t *credential);
+
+/*
+   Function that writes a credential as text, in a buffer of CREDENTIAL_TEXT_SIZE bytes.
+*/
+void credential_encode(const credential_t *credential, char *text);
+
+/*
+   Function that reads a credential written by credential_encode.
+   Return true on success and false if the text is not a credential.
+*/
+_Bool credential_decode(const char *text, credential_t *credential);
+
+/*
+   Function that returns the number of processors, the default number of threads of the bulk functions.
+*/
+int password_threads();
+
+/*
+   Function that makes the credentials of count passwords, spreading the work over a number of threads.
+*/
+void password_hash_all(password_job_t *jobs, size_t count, int threads);
+
+/*
+   Function that verifies count passwords against their credentials with a number of threads.
+   The credentials of the right passwords that were made with fewer rounds than
+   the current ones are made again with the current rounds.
+   Return the number of right passwords.
+*/
+size_t password_verify_all(password_job_t *jobs, size_t count, int threads);
+
+
+#endif
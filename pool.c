@@ -0,0 +1,107 @@
+/**
+ * @file pool.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the slab allocator used for the
+ * user, friend and post nodes. Nodes of the same kind end up next to each
+ * other in memory and freeing the whole database costs one free per slab.
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+#include "pool.h"
+#include "metrics.h"
+
+#define SLAB_BYTES (64 * 1024)
+
+/*
+   Function that rounds the node size so that every node is aligned and can hold a free list link.
+*/
+static size_t aligned_node_size(size_t size)
+{
+   size_t alignment = sizeof(void *) > sizeof(long double) ? sizeof(void *) : sizeof(long double);
+   if (size < sizeof(void *)) {
+      size = sizeof(void *);
+   }
+   return (size + alignment - 1) / alignment * alignment;
+}
+
+
+/*
+   Function that returns a node from the pool, recycling a freed node when there is one.
+*/
+void *pool_alloc(pool_t *pool)
+{
+   void *node;
+
+   if (pool->free_list != NULL) {
+      // reuse the most recently freed node
+      node = pool->free_list;
+      pool->free_list = *(void **)node;
+   } else {
+      if (pool->nodes_per_slab == 0) {
+         pool->node_size = aligned_node_size(pool->node_size);
+         pool->nodes_per_slab = (SLAB_BYTES - sizeof(pool_slab_t)) / pool->node_size;
+         if (pool->nodes_per_slab == 0) {
+            pool->nodes_per_slab = 1;
+         }
+      }
+
+      if (pool->slabs == NULL || pool->slab_used == pool->nodes_per_slab) {
+         // the newest slab is full, start a new one
+         size_t header_size = aligned_node_size(sizeof(pool_slab_t));
+         size_t slab_size = header_size + pool->nodes_per_slab * pool->node_size;
+         pool_slab_t *slab = malloc(slab_size);
+         assert(slab != NULL);
+         slab->next = pool->slabs;
+         pool->slabs = slab;
+         pool->slab_used = 0;
+         pool->stats.slabs++;
+         pool->stats.bytes += slab_size;
+         METRICS_GAUGE_ADD(GAUGE_POOL_BYTES, slab_size);
+      }
+
+      char *first_node = (char *)pool->slabs + aligned_node_size(sizeof(pool_slab_t));
+      node = first_node + pool->slab_used * pool->node_size;
+      pool->slab_used++;
+   }
+
+   pool->stats.allocations++;
+   pool->stats.live++;
+   return node;
+}
+
+
+/*
+   Function that gives a node back to the pool so that it can be recycled.
+*/
+void pool_free(pool_t *pool, void *node)
+{
+   *(void **)node = pool->free_list;
+   pool->free_list = node;
+   pool->stats.frees++;
+   pool->stats.live--;
+}
+
+
+/*
+   Function that frees all the slabs of the pool at once. Every node of the pool becomes invalid.
+*/
+void pool_release(pool_t *pool)
+{
+   pool_slab_t *current = pool->slabs;
+   while (current != NULL) {
+      pool_slab_t *next_slab = current->next;
+      free(current);
+      current = next_slab;
+   }
+   pool->slabs = NULL;
+   pool->slab_used = 0;
+   pool->free_list = NULL;
+   METRICS_GAUGE_ADD(GAUGE_POOL_BYTES, -(long)pool->stats.bytes);
+   pool->stats.live = 0;
+   pool->stats.slabs = 0;
+   pool->stats.bytes = 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file pool.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares a slab allocator for fixed-size nodes. A pool hands
+ * out nodes from large slabs, recycles freed nodes through a free list, and
+ * releases all its slabs at once.
+ */
+
+#ifndef __A2_POOL_H__
+#define __A2_POOL_H__
+#include <stddef.h>
+
+// Counters kept by every pool
+typedef struct pool_stats
+{
+    size_t allocations;   // number of nodes handed out since the pool was created
+    size_t frees;         // number of nodes given back to the free list
+    size_t live;          // number of nodes currently in use
+    size_t slabs;         // number of slabs allocated
+    size_t bytes;         // memory held by the slabs
+} pool_stats_t;
+
+// A slab of nodes, the nodes follow the header in the same allocation
+typedef struct pool_slab
+{
+    struct pool_slab *next;
+} pool_slab_t;
+
+// A pool of nodes of the same size
+typedef struct pool
+{
+    size_t node_size;
+    size_t nodes_per_slab;
+    pool_slab_t *slabs;   // the newest slab is first
+    size_t slab_used;     // number of nodes handed out from the newest slab
+    void *free_list;      // freed nodes, linked through their first bytes
+    pool_stats_t stats;
+} pool_t;
+
+/*
+   Macro that initializes a pool of nodes of a given size.
+*/
+#define POOL_INITIALIZER(size) { (size), 0, NULL, 0, NULL, { 0, 0, 0, 0, 0 } }
+
+/*
+   Function that returns a node from the pool, recycling a freed node when there is one.
+*/
+void *pool_alloc(pool_t *pool);
+
+/*
+   Function that gives a node back to the pool so that it can be recycled.
+*/
+void pool_free(pool_t *pool, void *node);
+
+/*
+   Function that frees all the slabs of the pool at once. Every node of the pool becomes invalid.
+*/
+void pool_release(pool_t *pool);
+
+
+#endif
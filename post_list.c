@@ -0,0 +1,224 @@
+/**
+ * @file post_list.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the users' post lists. A block
+ * keeps its posts oldest first, so a new post is added at the end of the
+ * newest block without moving the others, and is read from its end.
+ * Reading from a position skips the blocks before it by their counts, so a
+ * page costs the number of blocks skipped plus the size of the page.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "nodes.h"
+#include "post_list.h"
+#include "metrics.h"
+
+#define MERGE_THRESHOLD (POST_CHUNK_SIZE / 4)
+
+
+/*
+   Function that adds a post to a list as its newest post.
+*/
+void post_list_push(post_list_t *list, post_t *post)
+{
+   post_chunk_t *chunk = list->newest;
+   if (chunk == NULL || chunk->count == POST_CHUNK_SIZE) {
+      chunk = malloc(sizeof(post_chunk_t));
+      assert(chunk != NULL);
+      METRICS_GAUGE_ADD(GAUGE_POST_LIST_BYTES, sizeof(post_chunk_t));
+      chunk->count = 0;
+      chunk->older = list->newest;
+      chunk->newer = NULL;
+      if (list->newest != NULL) {
+         list->newest->newer = chunk;
+      }
+      list->newest = chunk;
+   }
+   chunk->posts[chunk->count++] = post;
+   post->chunk = chunk;
+   list->count++;
+}
+
+
+/*
+   Function that takes a block out of a list and frees it.
+*/
+static void unlink_chunk(post_list_t *list, post_chunk_t *chunk)
+{
+   if (chunk->newer != NULL) {
+      chunk->newer->older = chunk->older;
+   } else {
+      list->newest = chunk->older;
+   }
+   if (chunk->older != NULL) {
+      chunk->older->newer = chunk->newer;
+   }
+   free(chunk);
+   METRICS_GAUGE_ADD(GAUGE_POST_LIST_BYTES, -(long)sizeof(post_chunk_t));
+}
+
+
+/*
+   Function that moves the posts of a block into a neighbouring block that has room for them.
+   Return true if the block was merged and freed.
+*/
+static _Bool merge_chunk(post_list_t *list, post_chunk_t *chunk)
+{
+   post_chunk_t *older = chunk->older;
+   post_chunk_t *newer = chunk->newer;
+   post_chunk_t *into;
+   if (older != NULL && older->count + chunk->count <= POST_CHUNK_SIZE) {
+      // the posts are newer than the older block's, they go after them
+      memcpy(&older->posts[older->count], chunk->posts, chunk->count * sizeof(post_t *));
+      into = older;
+   } else if (newer != NULL && newer->count + chunk->count <= POST_CHUNK_SIZE) {
+      memmove(&newer->posts[chunk->count], newer->posts, newer->count * sizeof(post_t *));
+      memcpy(newer->posts, chunk->posts, chunk->count * sizeof(post_t *));
+      into = newer;
+   } else {
+      return 0;
+   }
+
+   for (unsigned int i = 0; i < chunk->count; i++) {
+      chunk->posts[i]->chunk = into;
+   }
+   into->count += chunk->count;
+   unlink_chunk(list, chunk);
+   return 1;
+}
+
+
+/*
+   Function that removes a post from the list that holds it. The block that held the post is
+   compacted, and merged with a neighbouring block when it becomes mostly empty.
+*/
+void post_list_remove(post_list_t *list, post_t *post)
+{
+   post_chunk_t *chunk = post->chunk;
+   unsigned int position = 0;
+   while (chunk->posts[position] != post) {
+      position++;
+   }
+   assert(position < chunk->count);
+
+   memmove(&chunk->posts[position], &chunk->posts[position + 1], (chunk->count - position - 1) * sizeof(post_t *));
+   chunk->count--;
+   list->count--;
+   post->chunk = NULL;
+
+   if (chunk->count == 0) {
+      unlink_chunk(list, chunk);
+   } else if (chunk->count <= MERGE_THRESHOLD) {
+      merge_chunk(list, chunk);
+   }
+}
+
+
+/*
+   Function that starts reading a list at a position.
+   Return the post at that position, or NULL if the list has no more posts.
+*/
+post_t *post_list_seek(const post_list_t *list, size_t position, post_cursor_t *cursor)
+{
+   const post_chunk_t *chunk = list->newest;
+   while (chunk != NULL && position >= chunk->count) {
+      position -= chunk->count;
+      chunk = chunk->older;
+   }
+   cursor->chunk = chunk;
+   cursor->index = chunk != NULL ? chunk->count - position : 0;
+   return post_list_next(cursor);
+}
+
+
+/*
+   Function that starts reading a list at its newest post older than a post id, as the lists
+   are in the order of the ids. Return that post, or NULL if there is none.
+*/
+post_t *post_list_seek_before(const post_list_t *list, unsigned long id, post_cursor_t *cursor)
+{
+   // a block whose oldest post is not older than the id has no post older than it
+   const post_chunk_t *chunk = list->newest;
+   while (chunk != NULL && id != 0 && chunk->posts[0]->id >= id) {
+      chunk = chunk->older;
+   }
+   cursor->chunk = chunk;
+   cursor->index = chunk != NULL ? chunk->count : 0;
+   post_t *post = post_list_next(cursor);
+   while (post != NULL && id != 0 && post->id >= id) {
+      post = post_list_next(cursor);
+   }
+   return post;
+}
+
+
+/*
+   Function that returns the next post, older, of a list read with a cursor, or NULL at the end of the list.
+*/
+post_t *post_list_next(post_cursor_t *cursor)
+{
+   if (cursor->index == 0) {
+      if (cursor->chunk == NULL || cursor->chunk->older == NULL) {
+         cursor->chunk = NULL;
+         return NULL;
+      }
+      cursor->chunk = cursor->chunk->older;
+      cursor->index = cursor->chunk->count;
+   }
+   return cursor->chunk->posts[--cursor->index];
+}
+
+
+/*
+   Function that stores up to limit posts of a list in posts, newest first, starting at a position.
+   Return the number of posts stored.
+*/
+size_t post_list_page(const post_list_t *list, size_t position, post_t **posts, size_t limit)
+{
+   post_cursor_t cursor;
+   size_t count = 0;
+   for (post_t *post = limit > 0 ? post_list_seek(list, position, &cursor) : NULL; post != NULL; post = post_list_next(&cursor)) {
+      posts[count++] = post;
+      if (count == limit) {
+         break;
+      }
+   }
+   return count;
+}
+
+
+/*
+   Function that returns the bytes taken by the blocks of a list.
+*/
+size_t post_list_bytes(const post_list_t *list)
+{
+   size_t bytes = 0;
+   for (const post_chunk_t *chunk = list->newest; chunk != NULL; chunk = chunk->older) {
+      bytes += sizeof(post_chunk_t);
+   }
+   return bytes;
+}
+
+
+/*
+   Function that frees the blocks of a list and leaves it empty. The posts are not freed.
+*/
+void post_list_free(post_list_t *list)
+{
+   post_chunk_t *current = list->newest;
+   while (current != NULL) {
+      post_chunk_t *older = current->older;
+      free(current);
+      METRICS_GAUGE_ADD(GAUGE_POST_LIST_BYTES, -(long)sizeof(post_chunk_t));
+      current = older;
+   }
+   list->newest = NULL;
+   list->count = 0;
+}
+
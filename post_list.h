@@ -0,0 +1,64 @@
+/**
+ * @file post_list.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the functions that manage a user's posts (see
+ * post_list_t in nodes.h). The posts are referenced from blocks of up to
+ * POST_CHUNK_SIZE posts, so reading a page of posts skips whole blocks
+ * instead of following a pointer per post. Positions are counted from 0,
+ * the newest post.
+ */
+
+#ifndef __A2_POST_LIST_H__
+#define __A2_POST_LIST_H__
+#include <stddef.h>
+#include "nodes.h"
+
+/*
+   Function that adds a post to a list as its newest post.
+*/
+void post_list_push(post_list_t *list, post_t *post);
+
+/*
+   Function that removes a post from the list that holds it. The block that held the post is
+   compacted, and merged with a neighbouring block when it becomes mostly empty.
+*/
+void post_list_remove(post_list_t *list, post_t *post);
+
+/*
+   Function that starts reading a list at a position.
+   Return the post at that position, or NULL if the list has no more posts.
+*/
+post_t *post_list_seek(const post_list_t *list, size_t position, post_cursor_t *cursor);
+
+/*
+   Function that starts reading a list at its newest post older than a post id, as the lists
+   are in the order of the ids. Return that post, or NULL if there is none.
+*/
+post_t *post_list_seek_before(const post_list_t *list, unsigned long id, post_cursor_t *cursor);
+
+/*
+   Function that returns the next post, older, of a list read with a cursor, or NULL at the end of the list.
+*/
+post_t *post_list_next(post_cursor_t *cursor);
+
+/*
+   Function that stores up to limit posts of a list in posts, newest first, starting at a position.
+   Return the number of posts stored.
+*/
+size_t post_list_page(const post_list_t *list, size_t position, post_t **posts, size_t limit);
+
+/*
+   Function that returns the bytes taken by the blocks of a list.
+*/
+size_t post_list_bytes(const post_list_t *list);
+
+/*
+   Function that frees the blocks of a list and leaves it empty. The posts are not freed.
+*/
+void post_list_free(post_list_t *list);
+
+
+#endif
@@ -0,0 +1,171 @@
+/**
+ * @file recommend.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the friend recommendations. The
+ * candidates are gathered from the friends of the user's friends, and each
+ * candidate is scored by intersecting its sorted friend ids with the user's.
+ * On x86 the intersection compares blocks of 4 ids against 4 ids with SSE2.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "nodes.h"
+#include "user_index.h"
+#include "recommend.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+/*
+   Function that counts the ids two sorted arrays of ids have in common.
+*/
+size_t intersect_count(const unsigned int *a, size_t a_count, const unsigned int *b, size_t b_count)
+{
+   size_t i = 0;
+   size_t j = 0;
+   size_t count = 0;
+
+#ifdef __SSE2__
+   // compare every id of a block of a with every id of a block of b by rotating the b block;
+   // the ids are unique inside each array, so each match is found exactly once
+   while (i + 4 <= a_count && j + 4 <= b_count) {
+      __m128i block_a = _mm_loadu_si128((const __m128i *)&a[i]);
+      __m128i block_b = _mm_loadu_si128((const __m128i *)&b[j]);
+
+      __m128i matches = _mm_cmpeq_epi32(block_a, block_b);
+      matches = _mm_or_si128(matches, _mm_cmpeq_epi32(block_a, _mm_shuffle_epi32(block_b, _MM_SHUFFLE(0, 3, 2, 1))));
+      matches = _mm_or_si128(matches, _mm_cmpeq_epi32(block_a, _mm_shuffle_epi32(block_b, _MM_SHUFFLE(1, 0, 3, 2))));
+      matches = _mm_or_si128(matches, _mm_cmpeq_epi32(block_a, _mm_shuffle_epi32(block_b, _MM_SHUFFLE(2, 1, 0, 3))));
+      count += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(matches)));
+
+      // move past the block whose largest id is the smallest
+      unsigned int last_a = a[i + 3];
+      unsigned int last_b = b[j + 3];
+      if (last_a <= last_b) {
+         i += 4;
+      }
+      if (last_b <= last_a) {
+         j += 4;
+      }
+   }
+#endif
+
+   // merge whatever is left one id at a time
+   while (i < a_count && j < b_count) {
+      if (a[i] < b[j]) {
+         i++;
+      } else if (a[i] > b[j]) {
+         j++;
+      } else {
+         count++;
+         i++;
+         j++;
+      }
+   }
+   return count;
+}
+
+
+/*
+   Function that counts the friends two users have in common.
+*/
+unsigned int mutual_friends(user_t *user, user_t *other)
+{
+   return intersect_count(user->friends.ids, user->friends.count, other->friends.ids, other->friends.count);
+}
+
+
+/*
+   Function that compares two unsigned ids, used to sort the candidates.
+*/
+static int compare_ids(const void *a, const void *b)
+{
+   unsigned int first = *(const unsigned int *)a;
+   unsigned int second = *(const unsigned int *)b;
+   return (first > second) - (first < second);
+}
+
+
+/*
+   Function that compares two suggestions, most mutual friends first and then by username.
+*/
+static int compare_recommendations(const void *a, const void *b)
+{
+   const recommendation_t *first = a;
+   const recommendation_t *second = b;
+   if (first->mutual_friends != second->mutual_friends) {
+      return first->mutual_friends > second->mutual_friends ? -1 : 1;
+   }
+   return strcmp(first->user->username, second->user->username);
+}
+
+
+/*
+   Function that finds the friends of the user's friends who are not already friends
+   of the user, ranked by number of mutual friends (ties in ascending username order).
+   Up to max_results suggestions are stored in results. Return the number of suggestions.
+*/
+size_t recommend_friends(user_t *user, recommendation_t *results, size_t max_results)
+{
+   // gather the friends of every friend
+   size_t total = 0;
+   for (unsigned int i = 0; i < user->friends.count; i++) {
+      total += index_user_by_id(user->friends.ids[i])->friends.count;
+   }
+   if (total == 0 || max_results == 0) {
+      return 0;
+   }
+
+   unsigned int *candidates = malloc(total * sizeof(unsigned int));
+   assert(candidates != NULL);
+   size_t num_candidates = 0;
+   for (unsigned int i = 0; i < user->friends.count; i++) {
+      const friend_set_t *friends = &index_user_by_id(user->friends.ids[i])->friends;
+      memcpy(&candidates[num_candidates], friends->ids, friends->count * sizeof(unsigned int));
+      num_candidates += friends->count;
+   }
+
+   // keep every candidate once, without the user and the user's current friends
+   qsort(candidates, num_candidates, sizeof(unsigned int), compare_ids);
+   size_t unique = 0;
+   for (size_t i = 0; i < num_candidates; i++) {
+      unsigned int id = candidates[i];
+      if ((unique > 0 && candidates[unique - 1] == id) || id == user->id) {
+         continue;
+      }
+      candidates[unique++] = id;
+   }
+
+   // score the candidates and keep the best ones
+   recommendation_t *scored = malloc(unique * sizeof(recommendation_t) + 1);
+   assert(scored != NULL);
+   size_t num_scored = 0;
+   size_t j = 0;
+   for (size_t i = 0; i < unique; i++) {
+      // both arrays are sorted, so the user's friends can be skipped with a single pass
+      while (j < user->friends.count && user->friends.ids[j] < candidates[i]) {
+         j++;
+      }
+      if (j < user->friends.count && user->friends.ids[j] == candidates[i]) {
+         continue;
+      }
+
+      user_t *candidate = index_user_by_id(candidates[i]);
+      scored[num_scored].user = candidate;
+      scored[num_scored].mutual_friends = mutual_friends(user, candidate);
+      num_scored++;
+   }
+   free(candidates);
+
+   qsort(scored, num_scored, sizeof(recommendation_t), compare_recommendations);
+   size_t num_results = num_scored < max_results ? num_scored : max_results;
+   memcpy(results, scored, num_results * sizeof(recommendation_t));
+   free(scored);
+   return num_results;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file recommend.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the friend recommendations: users who are friends
+ * of a user's friends, ranked by how many friends they have in common.
+ */
+
+#ifndef __A2_RECOMMEND_H__
+#define __A2_RECOMMEND_H__
+#include <stddef.h>
+#include "nodes.h"
+
+// Structure to represent a suggested friend
+typedef struct recommendation
+{
+    user_t *user;
+    unsigned int mutual_friends;
+} recommendation_t;
+
+/*
+   Function that counts the ids two sorted arrays of ids have in common.
+*/
+size_t intersect_count(const unsigned int *a, size_t a_count, const unsigned int *b, size_t b_count);
+
+/*
+   Function that counts the friends two users have in common.
+*/
+unsigned int mutual_friends(user_t *user, user_t *other);
+
+/*
+   Function that finds the friends of the user's friends who are not already friends
+   of the user, ranked by number of mutual friends (ties in ascending username order).
+   Up to max_results suggestions are stored in results. Return the number of suggestions.
+*/
+size_t recommend_friends(user_t *user, recommendation_t *results, size_t max_results);
+
+
+#endif
@@ -0,0 +1,605 @@
+/**
+ * @file search.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the full-text search, an
+ * inverted index from the terms of the posts to the ids of the posts.
+ *
+ * The terms are kept in an open addressing hash table. The posting list of
+ * a term is the sorted ids of its posts, stored as the differences between
+ * consecutive ids in a variable length encoding of 7 bits per byte, so most
+ * postings take a byte or two. New posts have the largest ids and are
+ * appended; a post indexed after a newer one, which can happen when posts
+ * are added from several threads, is inserted in its place.
+ *
+ * Deleted posts are left in the lists and skipped by the searches, which
+ * check the post table. A list is compacted once more than half of its
+ * postings are deleted posts.
+ *
+ * After search_defer, the posts are not indexed as they are added: the first
+ * search indexes every post of the post table, in the order of the ids, so
+ * a start from a snapshot does not pay for the index until it is used.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <pthread.h>
+#include "nodes.h"
+#include "functions.h"
+#include "search.h"
+
+#define MAX_TERM_LENGTH 64
+#define MAX_QUERY_TERMS 16
+#define INITIAL_TERMS 1024
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME 16777619u
+
+// A term and the posting list of its posts
+typedef struct term
+{
+    char *text;                 // NULL for an empty slot of the table
+    uint32_t hash;
+    unsigned char *data;        // the encoded differences between the post ids
+    size_t size;
+    size_t capacity;
+    unsigned long last_id;      // the largest post id in the list
+    unsigned long removed_id;   // the last deleted post counted in deleted
+    size_t count;               // postings in the list
+    size_t deleted;             // postings of deleted posts
+} term_t;
+
+// protects the index; searches hold it for reading while they visit the posts,
+// so that a deleted post is not freed before the searches using it are finished
+static pthread_rwlock_t search_lock = PTHREAD_RWLOCK_INITIALIZER;
+static term_t *terms = NULL;
+static size_t capacity = 0;
+static search_stats_t stats;
+static _Bool deferred = 0;     // the posts are indexed by the first search
+
+
+/*
+   Function that tells if a character is part of a word.
+   Bytes of UTF-8 sequences are, so that words in other alphabets are terms too.
+*/
+static _Bool is_word_char(unsigned char c)
+{
+   return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c >= 0x80;
+}
+
+
+/*
+   Function that reads the next term of a text and moves the cursor past it. A term is a run of
+   word characters, in lower case and cut to MAX_TERM_LENGTH, with its '#' or '@' if it has one.
+   The term is stored in term and the text it was read from in raw and raw_length.
+   Return the length of the term, or 0 at the end of the text.
+*/
+static size_t next_term(const char **cursor, char *term, const char **raw, size_t *raw_length)
+{
+   const char *p = *cursor;
+   while (*p != '\0' && !is_word_char(*p) && !((*p == '#' || *p == '@') && is_word_char(p[1]))) {
+      p++;
+   }
+   if (*p == '\0') {
+      *cursor = p;
+      return 0;
+   }
+
+   *raw = p;
+   size_t length = 0;
+   term[length++] = *p++;
+   while (is_word_char(*p)) {
+      if (length < MAX_TERM_LENGTH) {
+         term[length++] = *p;
+      }
+      p++;
+   }
+   for (size_t i = 0; i < length; i++) {
+      if (term[i] >= 'A' && term[i] <= 'Z') {
+         term[i] += 'a' - 'A';
+      }
+   }
+   term[length] = '\0';
+   *raw_length = p - *raw;
+   *cursor = p;
+   return length;
+}
+
+
+/*
+   Function that returns the FNV-1a hash of a term.
+*/
+static uint32_t hash_term(const char *term, size_t length)
+{
+   uint32_t hash = FNV_OFFSET;
+   for (size_t i = 0; i < length; i++) {
+      hash = (hash ^ (unsigned char)term[i]) * FNV_PRIME;
+   }
+   return hash;
+}
+
+
+/*
+   Function that returns the slot of a term in the table: its entry if it is in the table,
+   or the empty slot where it would be added.
+*/
+static term_t *find_slot(const char *term, uint32_t hash)
+{
+   size_t i = hash & (capacity - 1);
+   while (terms[i].text != NULL && (terms[i].hash != hash || strcmp(terms[i].text, term) != 0)) {
+      i = (i + 1) & (capacity - 1);
+   }
+   return &terms[i];
+}
+
+
+/*
+   Function that returns the entry of a term, or NULL if no post has it.
+*/
+static term_t *lookup_term(const char *term, size_t length)
+{
+   if (capacity == 0) {
+      return NULL;
+   }
+   term_t *slot = find_slot(term, hash_term(term, length));
+   return slot->text != NULL ? slot : NULL;
+}
+
+
+/*
+   Function that doubles the size of the table of terms.
+*/
+static void grow_terms()
+{
+   term_t *old = terms;
+   size_t old_capacity = capacity;
+   capacity = capacity == 0 ? INITIAL_TERMS : capacity * 2;
+   terms = calloc(capacity, sizeof(term_t));
+   assert(terms != NULL);
+   for (size_t i = 0; i < old_capacity; i++) {
+      if (old[i].text != NULL) {
+         *find_slot(old[i].text, old[i].hash) = old[i];
+      }
+   }
+   free(old);
+}
+
+
+/*
+   Function that returns the entry of a term, adding it to the table if no post has it yet.
+*/
+static term_t *add_term(const char *term, size_t length)
+{
+   // keep the table at most 3/4 full
+   if ((stats.terms + 1) * 4 > capacity * 3) {
+      grow_terms();
+   }
+   uint32_t hash = hash_term(term, length);
+   term_t *slot = find_slot(term, hash);
+   if (slot->text == NULL) {
+      slot->text = malloc(length + 1);
+      assert(slot->text != NULL);
+      memcpy(slot->text, term, length + 1);
+      slot->hash = hash;
+      stats.terms++;
+   }
+   return slot;
+}
+
+
+/*
+   Function that appends a number to a posting list, 7 bits per byte with the
+   high bit set on every byte but the last.
+*/
+static void append_number(term_t *term, unsigned long number)
+{
+   if (term->size + 10 > term->capacity) {
+      term->capacity = term->capacity == 0 ? 16 : term->capacity * 2;
+      term->data = realloc(term->data, term->capacity);
+      assert(term->data != NULL);
+   }
+   while (number >= 0x80) {
+      term->data[term->size++] = (unsigned char)(number | 0x80);
+      number >>= 7;
+   }
+   term->data[term->size++] = (unsigned char)number;
+}
+
+
+/*
+   Function that reads a number of a posting list at position and moves the position past it.
+*/
+static unsigned long read_number(const unsigned char *data, size_t *position)
+{
+   unsigned long number = 0;
+   int shift = 0;
+   unsigned char byte;
+   do {
+      byte = data[(*position)++];
+      number |= (unsigned long)(byte & 0x7f) << shift;
+      shift += 7;
+   } while (byte & 0x80);
+   return number;
+}
+
+
+/*
+   Function that decodes the post ids of a posting list, in increasing order.
+   Return an array of term->count ids, to be freed by the caller.
+*/
+static unsigned long *decode_list(const term_t *term)
+{
+   unsigned long *ids = malloc((term->count + 1) * sizeof(unsigned long));
+   assert(ids != NULL);
+   unsigned long id = 0;
+   size_t position = 0;
+   for (size_t i = 0; i < term->count; i++) {
+      id += read_number(term->data, &position);
+      ids[i] = id;
+   }
+   return ids;
+}
+
+
+/*
+   Function that replaces the posting list of a term with count sorted ids.
+*/
+static void encode_list(term_t *term, const unsigned long *ids, size_t count)
+{
+   stats.bytes -= term->size;
+   stats.postings -= term->count;
+   term->size = 0;
+   term->count = 0;
+   term->last_id = 0;
+   for (size_t i = 0; i < count; i++) {
+      append_number(term, ids[i] - term->last_id);
+      term->last_id = ids[i];
+   }
+   term->count = count;
+   stats.bytes += term->size;
+   stats.postings += count;
+}
+
+
+/*
+   Function that adds a post id to the posting list of a term, once.
+*/
+static void add_posting(term_t *term, unsigned long id)
+{
+   if (id == term->last_id) {
+      return; // the term is repeated in the post
+   }
+   if (id > term->last_id) {
+      size_t size = term->size;
+      append_number(term, id - term->last_id);
+      term->last_id = id;
+      term->count++;
+      stats.bytes += term->size - size;
+      stats.postings++;
+      return;
+   }
+
+   // a newer post was indexed first, insert the id in its place
+   unsigned long *ids = decode_list(term);
+   size_t i = term->count;
+   while (i > 0 && ids[i - 1] > id) {
+      i--;
+   }
+   if (i == 0 || ids[i - 1] != id) {
+      memmove(&ids[i + 1], &ids[i], (term->count - i) * sizeof(unsigned long));
+      ids[i] = id;
+      encode_list(term, ids, term->count + 1);
+   }
+   free(ids);
+}
+
+
+/*
+   Function that removes the postings of deleted posts from the posting list of a term.
+*/
+static void compact_list(term_t *term)
+{
+   unsigned long *ids = decode_list(term);
+   size_t kept = 0;
+   for (size_t i = 0; i < term->count; i++) {
+      if (find_post(ids[i]) != NULL) {
+         ids[kept++] = ids[i];
+      }
+   }
+   encode_list(term, ids, kept);
+   term->deleted = 0;
+   free(ids);
+}
+
+
+/*
+   Function that adds the terms of a post to the index, with the lock held for writing.
+*/
+static void index_terms(const post_t *post)
+{
+   char term[MAX_TERM_LENGTH + 1];
+   const char *raw;
+   size_t raw_length;
+   size_t length;
+   const char *cursor = post->content;
+
+   while ((length = next_term(&cursor, term, &raw, &raw_length)) > 0) {
+      add_posting(add_term(term, length), post->id);
+   }
+}
+
+
+/*
+   Function that adds a new post to the search index.
+*/
+void search_index_post(const post_t *post)
+{
+   pthread_rwlock_wrlock(&search_lock);
+   if (!deferred) {
+      index_terms(post);
+   }
+   pthread_rwlock_unlock(&search_lock);
+}
+
+
+/*
+   Function that stops indexing the posts as they are added, until the next search.
+*/
+void search_defer()
+{
+   pthread_rwlock_wrlock(&search_lock);
+   __atomic_store_n(&deferred, 1, __ATOMIC_RELEASE);
+   pthread_rwlock_unlock(&search_lock);
+}
+
+
+/*
+   Function that indexes every post of the post table if the index was deferred. A post that is
+   added meanwhile waits for the lock and is then indexed again, which adds nothing.
+*/
+static void build_deferred()
+{
+   pthread_rwlock_wrlock(&search_lock);
+   if (deferred) {
+      unsigned long last = last_post_id();
+      for (unsigned long id = 1; id <= last; id++) {
+         post_t *post = find_post(id);
+         if (post != NULL) {
+            index_terms(post);
+         }
+      }
+      __atomic_store_n(&deferred, 0, __ATOMIC_RELEASE);
+   }
+   pthread_rwlock_unlock(&search_lock);
+}
+
+
+/*
+   Function that removes a deleted post from the search index. The post must
+   already be removed from the post table, so that searches no longer find it.
+*/
+void search_remove_post(const post_t *post)
+{
+   char term[MAX_TERM_LENGTH + 1];
+   const char *raw;
+   size_t raw_length;
+   size_t length;
+   const char *cursor = post->content;
+
+   // a deferred index is built from the post table, which no longer holds the post
+   pthread_rwlock_wrlock(&search_lock);
+   while (!deferred && (length = next_term(&cursor, term, &raw, &raw_length)) > 0) {
+      term_t *entry = lookup_term(term, length);
+      if (entry == NULL || entry->removed_id == post->id) {
+         continue;
+      }
+      entry->removed_id = post->id;
+      entry->deleted++;
+      if (entry->deleted * 2 > entry->count) {
+         compact_list(entry);
+      }
+   }
+   pthread_rwlock_unlock(&search_lock);
+}
+
+
+/*
+   Function that intersects count sorted ids with the posting list of a term.
+   Return the number of ids that are kept, at the start of the array.
+*/
+static size_t intersect(unsigned long *ids, size_t count, const term_t *term)
+{
+   size_t kept = 0;
+   size_t position = 0;
+   size_t read = 0;
+   unsigned long id = 0;
+   for (size_t i = 0; i < count; i++) {
+      while (read < term->count && id < ids[i]) {
+         id += read_number(term->data, &position);
+         read++;
+      }
+      if (id == ids[i]) {
+         ids[kept++] = ids[i];
+      } else if (id < ids[i]) {
+         break; // the list has no larger id
+      }
+   }
+   return kept;
+}
+
+
+/*
+   Function that finds the posts that have all the terms of a group.
+   Return the sorted ids of the posts that are not deleted, to be freed by the caller,
+   and store their number in count.
+*/
+static unsigned long *match_group(term_t **group, size_t terms_in_group, size_t *count)
+{
+   // start from the shortest list, every other list can only remove ids
+   size_t shortest = 0;
+   for (size_t i = 1; i < terms_in_group; i++) {
+      if (group[i]->count < group[shortest]->count) {
+         shortest = i;
+      }
+   }
+   unsigned long *ids = decode_list(group[shortest]);
+   *count = group[shortest]->count;
+   for (size_t i = 0; i < terms_in_group && *count > 0; i++) {
+      if (i != shortest) {
+         *count = intersect(ids, *count, group[i]);
+      }
+   }
+
+   size_t kept = 0;
+   for (size_t i = 0; i < *count; i++) {
+      if (find_post(ids[i]) != NULL) {
+         ids[kept++] = ids[i];
+      }
+   }
+   *count = kept;
+   return ids;
+}
+
+
+/*
+   Function that compares two post ids to sort them in decreasing order.
+*/
+static int compare_ids_decreasing(const void *a, const void *b)
+{
+   unsigned long first = *(const unsigned long *)a;
+   unsigned long second = *(const unsigned long *)b;
+   return (first < second) - (first > second);
+}
+
+
+/*
+   Function that searches the posts matching a query, newest first, and calls visit
+   for each of them, up to limit posts. The posts can only be used during the call.
+   Return the number of posts found.
+*/
+size_t search_posts(const char *query, size_t limit, search_visit_t visit, void *context)
+{
+   char term[MAX_TERM_LENGTH + 1];
+   const char *raw;
+   size_t raw_length;
+   size_t length;
+   const char *cursor = query;
+
+   term_t *group[MAX_QUERY_TERMS];
+   size_t terms_in_group = 0;
+   _Bool missing = 0;          // a term of the group is in no post
+   unsigned long *found = NULL;
+   size_t found_count = 0;
+   _Bool several_groups = 0;
+
+   if (__atomic_load_n(&deferred, __ATOMIC_ACQUIRE)) {
+      build_deferred();
+   }
+   pthread_rwlock_rdlock(&search_lock);
+   while (1) {
+      length = next_term(&cursor, term, &raw, &raw_length);
+      _Bool is_or = length > 0 && raw_length == 2 && strncmp(raw, "OR", 2) == 0;
+      if (length > 0 && !is_or) {
+         // the terms of a group are all required, AND is only a separator
+         if ((raw_length == 3 && strncmp(raw, "AND", 3) == 0) || terms_in_group == MAX_QUERY_TERMS) {
+            continue;
+         }
+         group[terms_in_group] = lookup_term(term, length);
+         if (group[terms_in_group] == NULL) {
+            missing = 1;
+         } else {
+            terms_in_group++;
+         }
+         continue;
+      }
+
+      // the group ends, add its posts to the posts found
+      if (terms_in_group > 0 && !missing) {
+         size_t count;
+         unsigned long *ids = match_group(group, terms_in_group, &count);
+         if (found == NULL) {
+            found = ids;
+            found_count = count;
+         } else {
+            found = realloc(found, (found_count + count + 1) * sizeof(unsigned long));
+            assert(found != NULL);
+            memcpy(&found[found_count], ids, count * sizeof(unsigned long));
+            found_count += count;
+            several_groups = 1;
+            free(ids);
+         }
+      }
+      terms_in_group = 0;
+      missing = 0;
+      if (length == 0) {
+         break;
+      }
+   }
+
+   // a single group is already sorted, the union of several is sorted and deduplicated
+   if (several_groups) {
+      qsort(found, found_count, sizeof(unsigned long), compare_ids_decreasing);
+      size_t unique = 0;
+      for (size_t i = 0; i < found_count; i++) {
+         if (unique == 0 || found[unique - 1] != found[i]) {
+            found[unique++] = found[i];
+         }
+      }
+      found_count = unique;
+   } else {
+      for (size_t i = 0; i < found_count / 2; i++) {
+         unsigned long id = found[i];
+         found[i] = found[found_count - 1 - i];
+         found[found_count - 1 - i] = id;
+      }
+   }
+
+   // a post deleted since it was matched is no longer in the post table, but not freed yet
+   size_t visited = 0;
+   for (size_t i = 0; i < found_count && visited < limit; i++) {
+      post_t *post = find_post(found[i]);
+      if (post != NULL) {
+         visit(post, context);
+         visited++;
+      }
+   }
+   pthread_rwlock_unlock(&search_lock);
+   free(found);
+   return found_count;
+}
+
+
+/*
+   Function that copies the statistics of the search index. A deferred index counts nothing
+   until the first search builds it.
+*/
+void search_get_stats(search_stats_t *copy)
+{
+   pthread_rwlock_rdlock(&search_lock);
+   *copy = stats;
+   pthread_rwlock_unlock(&search_lock);
+}
+
+
+/*
+   Function that empties the search index and frees its memory.
+*/
+void search_clear()
+{
+   pthread_rwlock_wrlock(&search_lock);
+   for (size_t i = 0; i < capacity; i++) {
+      free(terms[i].text);
+      free(terms[i].data);
+   }
+   free(terms);
+   terms = NULL;
+   capacity = 0;
+   memset(&stats, 0, sizeof(stats));
+   __atomic_store_n(&deferred, 0, __ATOMIC_RELEASE);
+   pthread_rwlock_unlock(&search_lock);
+}
+
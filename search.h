@@ -0,0 +1,69 @@
+/**
+ * @file search.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the full-text search over the posts. Every post
+ * is indexed when it is added, or by the first search after search_defer:
+ * its words, #hashtags and @mentions, ignoring case, each map to the ids of
+ * the posts that contain them.
+ *
+ * A query is a list of words, hashtags and mentions. The posts must contain
+ * all of them, unless the list is split with OR, in which case the posts
+ * must match one of the parts. For example "#Quidditch snitch OR @harry".
+ */
+
+#ifndef __A2_SEARCH_H__
+#define __A2_SEARCH_H__
+#include <stddef.h>
+#include "nodes.h"
+
+// Statistics of the search index
+typedef struct search_stats
+{
+    size_t terms;           // different words, hashtags and mentions
+    size_t postings;        // post ids in all the posting lists, deleted posts included
+    size_t bytes;           // size of the compressed posting lists
+} search_stats_t;
+
+// Function called for every post found by a search
+typedef void (*search_visit_t)(const post_t *post, void *context);
+
+/*
+   Function that adds a new post to the search index.
+*/
+void search_index_post(const post_t *post);
+
+/*
+   Function that stops indexing the posts as they are added: the first search indexes every
+   post then, so the posts loaded at the start are only indexed if they are searched.
+*/
+void search_defer();
+
+/*
+   Function that removes a deleted post from the search index. The post must
+   already be removed from the post table, so that searches no longer find it.
+*/
+void search_remove_post(const post_t *post);
+
+/*
+   Function that searches the posts matching a query, newest first, and calls visit
+   for each of them, up to limit posts. The posts can only be used during the call.
+   Return the number of posts found.
+*/
+size_t search_posts(const char *query, size_t limit, search_visit_t visit, void *context);
+
+/*
+   Function that copies the statistics of the search index. A deferred index counts nothing
+   until the first search builds it.
+*/
+void search_get_stats(search_stats_t *stats);
+
+/*
+   Function that empties the search index and frees its memory.
+*/
+void search_clear();
+
+
+#endif
@@ -0,0 +1,441 @@
+/**
+ * @file server.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the server mode and of its load
+ * generator. Every client connection is served by a thread of its own that
+ * reads the batch mode's commands from the socket (see batch.h). The
+ * commands lock the shards of the user index they use, so the clients only
+ * wait for each other when they work on users of the same shards.
+ *
+ * The load generator creates its own users, then runs a mix of feed reads,
+ * posts and friendship changes from 1, 2, 4, ... clients and prints the
+ * throughput for every number of clients. Clients send their commands in
+ * windows of LOAD_WINDOW commands and then read all the answers.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include "nodes.h"
+#include "histogram.h"
+#include "batch.h"
+#include "server.h"
+
+#define LISTEN_BACKLOG 128
+#define LOAD_USERS 1000
+#define LOAD_FRIENDS 8
+#define LOAD_WINDOW 32
+
+// A client connection being served
+typedef struct connection
+{
+   int fd;
+   user_t **users;
+   pthread_t thread;
+   struct connection *next;
+} connection_t;
+
+// A client of the load generator
+typedef struct load_client
+{
+   const char *socket_path;
+   unsigned int seed;
+   unsigned long long deadline_ns;
+   size_t commands;
+   size_t failures;
+   int error;
+} load_client_t;
+
+static volatile sig_atomic_t stopping = 0;
+static int listen_fd = -1;
+
+static pthread_mutex_t connections_lock = PTHREAD_MUTEX_INITIALIZER; // protects the fields below
+static pthread_cond_t connections_done = PTHREAD_COND_INITIALIZER;
+static connection_t *connections = NULL;
+static size_t num_connections = 0;
+
+
+/*
+   Function that blocks SIGINT and SIGTERM in the calling thread and in every thread it creates
+   from then on. Called before any other thread is created, it leaves the signals to the
+   server's signal thread, so that they stop the server whichever thread they are sent to.
+*/
+void server_block_signals()
+{
+   sigset_t signals;
+   sigemptyset(&signals);
+   sigaddset(&signals, SIGINT);
+   sigaddset(&signals, SIGTERM);
+   pthread_sigmask(SIG_BLOCK, &signals, NULL);
+}
+
+
+/*
+   Function that waits for SIGINT or SIGTERM, then stops the server: closing the listening
+   socket for reading wakes the accept of the main thread.
+*/
+static void *wait_for_stop(void *argument)
+{
+   sigset_t *signals = argument;
+   int signal_number;
+   sigwait(signals, &signal_number);
+   stopping = 1;
+   shutdown(listen_fd, SHUT_RDWR);
+   return NULL;
+}
+
+
+/*
+   Function that serves a client connection until the client closes it.
+*/
+static void *serve_connection(void *argument)
+{
+   connection_t *connection = argument;
+   FILE *input = fdopen(connection->fd, "r");
+   FILE *output = fdopen(dup(connection->fd), "w");
+   if (input != NULL && output != NULL) {
+      // the client waits for every answer, each line is sent as soon as it is complete
+      setvbuf(output, NULL, _IOLBF, 0);
+      run_batch(input, output, NULL, connection->users);
+   }
+
+   pthread_mutex_lock(&connections_lock);
+   connection_t **link = &connections;
+   while (*link != connection) {
+      link = &(*link)->next;
+   }
+   *link = connection->next;
+   if (output != NULL) {
+      fclose(output);
+   }
+   if (input != NULL) {
+      fclose(input);
+   } else {
+      close(connection->fd);
+   }
+   num_connections--;
+   pthread_cond_signal(&connections_done);
+   pthread_mutex_unlock(&connections_lock);
+
+   free(connection);
+   return NULL;
+}
+
+
+/*
+   Function that fills the address of a Unix domain socket.
+   Return 0 on success and -1 if the path is too long.
+*/
+static int socket_address(const char *socket_path, struct sockaddr_un *address)
+{
+   memset(address, 0, sizeof(*address));
+   address->sun_family = AF_UNIX;
+   if (strlen(socket_path) >= sizeof(address->sun_path)) {
+      errno = ENAMETOOLONG;
+      return -1;
+   }
+   strcpy(address->sun_path, socket_path);
+   return 0;
+}
+
+
+/*
+   Function that listens on a Unix domain socket and runs the commands sent by every client
+   in a thread of its own, until the process receives SIGINT or SIGTERM.
+   Return 0 when the server stopped and 1 if the socket can not be created.
+*/
+int run_server(const char *socket_path, user_t **users)
+{
+   struct sockaddr_un address;
+   listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+   if (listen_fd < 0 || socket_address(socket_path, &address) != 0) {
+      perror("Error creating the server socket");
+      if (listen_fd >= 0) {
+         close(listen_fd);
+      }
+      return 1;
+   }
+   unlink(socket_path);
+   if (bind(listen_fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listen_fd, LISTEN_BACKLOG) != 0) {
+      perror("Error listening on the server socket");
+      close(listen_fd);
+      return 1;
+   }
+
+   signal(SIGPIPE, SIG_IGN); // a client that leaves early only ends its own connection
+
+   // the signals are blocked in every thread, the connection threads inherit the mask,
+   // and only the stop thread takes them
+   static sigset_t signals;
+   sigemptyset(&signals);
+   sigaddset(&signals, SIGINT);
+   sigaddset(&signals, SIGTERM);
+   server_block_signals();
+   pthread_t stop_thread;
+   if (pthread_create(&stop_thread, NULL, wait_for_stop, &signals) != 0) {
+      perror("Error starting the server");
+      close(listen_fd);
+      unlink(socket_path);
+      return 1;
+   }
+
+   fprintf(stderr, "Listening on %s\n", socket_path);
+   size_t served = 0;
+   while (!stopping) {
+      int fd = accept(listen_fd, NULL, NULL);
+      if (fd < 0) {
+         if (!stopping && errno != EINTR) {
+            perror("Error accepting a connection");
+         }
+         continue;
+      }
+
+      connection_t *connection = malloc(sizeof(connection_t));
+      if (connection == NULL) {
+         close(fd);
+         continue;
+      }
+      connection->fd = fd;
+      connection->users = users;
+
+      pthread_mutex_lock(&connections_lock);
+      if (pthread_create(&connection->thread, NULL, serve_connection, connection) != 0) {
+         close(fd);
+         free(connection);
+      } else {
+         pthread_detach(connection->thread);
+         connection->next = connections;
+         connections = connection;
+         num_connections++;
+         served++;
+      }
+      pthread_mutex_unlock(&connections_lock);
+   }
+
+   pthread_join(stop_thread, NULL);
+   close(listen_fd);
+   listen_fd = -1;
+   unlink(socket_path);
+
+   // end the connections that are still open, their threads see the end of their input
+   pthread_mutex_lock(&connections_lock);
+   for (connection_t *current = connections; current != NULL; current = current->next) {
+      shutdown(current->fd, SHUT_RD);
+   }
+   while (num_connections > 0) {
+      pthread_cond_wait(&connections_done, &connections_lock);
+   }
+   pthread_mutex_unlock(&connections_lock);
+
+   fprintf(stderr, "Served %zu connections\n", served);
+   return 0;
+}
+
+
+/*
+   Function that connects to the server.
+   Return the connected socket, or -1 on error.
+*/
+static int connect_to_server(const char *socket_path)
+{
+   struct sockaddr_un address;
+   int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+   if (fd < 0) {
+      return -1;
+   }
+   if (socket_address(socket_path, &address) != 0 || connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+      close(fd);
+      return -1;
+   }
+   return fd;
+}
+
+
+/*
+   Function that reads the answers of a number of commands, skipping the posts printed by FEED.
+   Return the number of commands that failed, or -1 if the server closed the connection.
+*/
+static long read_answers(FILE *input, int num_commands, char **line, size_t *line_size)
+{
+   long failures = 0;
+   while (num_commands > 0) {
+      if (getline(line, line_size, input) <= 0) {
+         return -1;
+      }
+      if (strncmp(*line, "OK", 2) == 0) {
+         num_commands--;
+      } else if (strncmp(*line, "ERR", 3) == 0) {
+         num_commands--;
+         failures++;
+      }
+   }
+   return failures;
+}
+
+
+/*
+   Function that writes the name of a user of the load generator.
+*/
+static void load_username(char *username, size_t size, unsigned int number)
+{
+   snprintf(username, size, "lg%d_%u", (int)getpid(), number);
+}
+
+
+/*
+   Function that runs a mix of commands on the load generator's users until the client's deadline.
+*/
+static void *run_load_client(void *argument)
+{
+   load_client_t *client = argument;
+   int fd = connect_to_server(client->socket_path);
+   FILE *input = fd >= 0 ? fdopen(fd, "r") : NULL;
+   FILE *output = fd >= 0 ? fdopen(dup(fd), "w") : NULL;
+   if (input == NULL || output == NULL) {
+      client->error = 1;
+      return NULL;
+   }
+
+   char *line = NULL;
+   size_t line_size = 0;
+   char username[30];
+   char friend_name[30];
+   while (histogram_now_ns() < client->deadline_ns) {
+      for (int i = 0; i < LOAD_WINDOW; i++) {
+         int kind = rand_r(&client->seed) % 100;
+         load_username(username, sizeof(username), rand_r(&client->seed) % LOAD_USERS);
+         load_username(friend_name, sizeof(friend_name), rand_r(&client->seed) % LOAD_USERS);
+
+         // mostly reads: 60% feeds, 25% posts, 5% deleted posts, 10% friendship changes
+         if (kind < 60) {
+            fprintf(output, "FEED %s 10\n", username);
+         } else if (kind < 85) {
+            fprintf(output, "POST %s load test post %d\n", username, kind);
+         } else if (kind < 90) {
+            fprintf(output, "DELPOST %s 1\n", username);
+         } else if (kind < 95) {
+            fprintf(output, "FRIEND %s %s\n", username, friend_name);
+         } else {
+            fprintf(output, "UNFRIEND %s %s\n", username, friend_name);
+         }
+      }
+      fflush(output);
+
+      long failures = read_answers(input, LOAD_WINDOW, &line, &line_size);
+      if (failures < 0) {
+         client->error = 1;
+         break;
+      }
+      client->commands += LOAD_WINDOW;
+      client->failures += failures;
+   }
+
+   free(line);
+   fclose(output);
+   fclose(input);
+   return NULL;
+}
+
+
+/*
+   Function that creates the load generator's users, each with LOAD_FRIENDS friends.
+   Return 0 on success and -1 if the server can not be reached.
+*/
+static int create_load_users(const char *socket_path)
+{
+   int fd = connect_to_server(socket_path);
+   FILE *input = fd >= 0 ? fdopen(fd, "r") : NULL;
+   FILE *output = fd >= 0 ? fdopen(dup(fd), "w") : NULL;
+   if (input == NULL || output == NULL) {
+      return -1;
+   }
+
+   char *line = NULL;
+   size_t line_size = 0;
+   char username[30];
+   char friend_name[30];
+   long result = 0;
+   for (unsigned int i = 0; i < LOAD_USERS && result >= 0; i++) {
+      load_username(username, sizeof(username), i);
+      fprintf(output, "ADDUSER %s password\n", username);
+      for (unsigned int j = 1; j <= LOAD_FRIENDS / 2; j++) {
+         // every user befriends LOAD_FRIENDS / 2 users and is befriended by as many
+         load_username(friend_name, sizeof(friend_name), (i + j * 37) % LOAD_USERS);
+         fprintf(output, "FRIEND %s %s\n", username, friend_name);
+      }
+      fflush(output);
+      result = read_answers(input, 1 + LOAD_FRIENDS / 2, &line, &line_size);
+   }
+
+   free(line);
+   fclose(output);
+   fclose(input);
+   return result < 0 ? -1 : 0;
+}
+
+
+/*
+   Function that measures the throughput of a server with 1, 2, 4, ... up to max_threads
+   clients, each running a mix of commands for the given number of seconds, and prints
+   the commands per second for every number of clients.
+   Return 0 on success and 1 if the server can not be reached.
+*/
+int run_load_generator(const char *socket_path, int max_threads, double seconds)
+{
+   if (create_load_users(socket_path) != 0) {
+      perror("Error connecting to the server");
+      return 1;
+   }
+
+   printf("%8s %12s %10s %12s\n", "clients", "commands", "failed", "ops/s");
+   load_client_t *clients = malloc(max_threads * sizeof(load_client_t));
+   pthread_t *threads = malloc(max_threads * sizeof(pthread_t));
+   if (clients == NULL || threads == NULL) {
+      free(clients);
+      free(threads);
+      return 1;
+   }
+
+   int result = 0;
+   for (int num_threads = 1; num_threads <= max_threads && result == 0; num_threads *= 2) {
+      unsigned long long start = histogram_now_ns();
+      for (int i = 0; i < num_threads; i++) {
+         clients[i].socket_path = socket_path;
+         clients[i].seed = (unsigned int)(start + i * 7919);
+         clients[i].deadline_ns = start + (unsigned long long)(seconds * 1e9);
+         clients[i].commands = 0;
+         clients[i].failures = 0;
+         clients[i].error = 0;
+         pthread_create(&threads[i], NULL, run_load_client, &clients[i]);
+      }
+
+      size_t commands = 0;
+      size_t failures = 0;
+      for (int i = 0; i < num_threads; i++) {
+         pthread_join(threads[i], NULL);
+         commands += clients[i].commands;
+         failures += clients[i].failures;
+         result |= clients[i].error;
+      }
+      double elapsed = (histogram_now_ns() - start) / 1e9;
+      printf("%8d %12zu %10zu %12.0f\n", num_threads, commands, failures, commands / elapsed);
+      fflush(stdout);
+   }
+
+   if (result != 0) {
+      fprintf(stderr, "Error: the server closed a connection\n");
+   }
+   free(clients);
+   free(threads);
+   return result;
+}
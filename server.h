@@ -0,0 +1,39 @@
+/**
+ * @file server.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the server mode, which runs the batch mode's
+ * commands for many clients at the same time over a Unix domain socket,
+ * and the load generator that measures the server's throughput.
+ */
+
+#ifndef __A2_SERVER_H__
+#define __A2_SERVER_H__
+#include "nodes.h"
+
+/*
+   Function that blocks SIGINT and SIGTERM in the calling thread and in every thread it creates
+   from then on. Called before any other thread is created, it leaves the signals to the
+   server's signal thread, so that they stop the server whichever thread they are sent to.
+*/
+void server_block_signals();
+
+/*
+   Function that listens on a Unix domain socket and runs the commands sent by every client
+   in a thread of its own, until the process receives SIGINT or SIGTERM.
+   Return 0 when the server stopped and 1 if the socket can not be created.
+*/
+int run_server(const char *socket_path, user_t **users);
+
+/*
+   Function that measures the throughput of a server with 1, 2, 4, ... up to max_threads
+   clients, each running a mix of commands for the given number of seconds, and prints
+   the commands per second for every number of clients.
+   Return 0 on success and 1 if the server can not be reached.
+*/
+int run_load_generator(const char *socket_path, int max_threads, double seconds);
+
+
+#endif
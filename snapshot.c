@@ -0,0 +1,452 @@
+/**
+ * @file snapshot.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the binary snapshot format: writing
+ * the users database to a snapshot file, opening a snapshot with mmap, and
+ * turning a snapshot back into the linked lists used by the program.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "nodes.h"
+#include "functions.h"
+#include "user_index.h"
+#include "post_list.h"
+#include "search.h"
+#include "snapshot.h"
+
+
+/*
+   Function that writes a block of bytes to the file.
+   Return 0 on success and -1 on error.
+*/
+static int write_bytes(FILE *file, const void *data, size_t size)
+{
+   return fwrite(data, 1, size, file) == size ? 0 : -1;
+}
+
+
+/*
+   Function that writes the records and the string table of the sorted users to an open file.
+   Return 0 on success and -1 on error.
+*/
+static int write_sections(FILE *file, user_t **sorted, size_t num_users, uint64_t log_records)
+{
+   snapshot_header_t header;
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+   header.version = SNAPSHOT_VERSION;
+   header.user_count = num_users;
+   header.log_records = log_records;
+
+   // first pass: count the friend and post records, and find every user's position in the file
+   uint32_t *positions = malloc((num_users + 1) * sizeof(uint32_t));
+   assert(positions != NULL);
+   for (size_t i = 0; i < num_users; i++) {
+      positions[sorted[i]->id] = i;
+      header.friend_count += sorted[i]->friends.count;
+      header.post_count += sorted[i]->posts.count;
+   }
+
+   // second pass: fill the records, laying out the strings in the order they are written
+   snapshot_user_t *user_records = malloc((num_users + 1) * sizeof(snapshot_user_t));
+   snapshot_friend_t *friend_records = malloc((header.friend_count + 1) * sizeof(snapshot_friend_t));
+   snapshot_post_t *post_records = malloc((header.post_count + 1) * sizeof(snapshot_post_t));
+   assert(user_records != NULL && friend_records != NULL && post_records != NULL);
+
+   uint64_t strings_size = 0;
+   uint32_t num_friends = 0;
+   uint32_t num_posts = 0;
+   for (size_t i = 0; i < num_users; i++) {
+      user_t *user = sorted[i];
+      snapshot_user_t *record = &user_records[i];
+      record->username = strings_size;
+      strings_size += strlen(user->username) + 1;
+      record->credential = user->credential;
+
+      record->first_friend = num_friends;
+      record->friend_count = user->friends.count;
+      for (unsigned int j = 0; j < user->friends.count; j++) {
+         friend_records[num_friends++].user = positions[user->friends.ids[j]];
+      }
+
+      record->first_post = num_posts;
+      post_cursor_t cursor;
+      for (post_t *current = post_list_seek(&user->posts, 0, &cursor); current != NULL; current = post_list_next(&cursor)) {
+         post_records[num_posts].content = strings_size;
+         post_records[num_posts].length = current->length;
+         post_records[num_posts].id = current->id;
+         post_records[num_posts].created = current->created;
+         strings_size += post_records[num_posts].length + 1;
+         num_posts++;
+      }
+      record->post_count = num_posts - record->first_post;
+   }
+
+   // the sections with the largest alignment come first
+   header.users_offset = sizeof(header);
+   header.posts_offset = header.users_offset + (uint64_t)num_users * sizeof(snapshot_user_t);
+   header.friends_offset = header.posts_offset + (uint64_t)num_posts * sizeof(snapshot_post_t);
+   header.strings_offset = header.friends_offset + (uint64_t)num_friends * sizeof(snapshot_friend_t);
+   header.strings_size = strings_size;
+
+   int result = strings_size <= UINT32_MAX ? 0 : -1;
+   if (result == 0) {
+      result = write_bytes(file, &header, sizeof(header));
+   }
+   if (result == 0) {
+      result = write_bytes(file, user_records, num_users * sizeof(snapshot_user_t));
+   }
+   if (result == 0) {
+      result = write_bytes(file, post_records, num_posts * sizeof(snapshot_post_t));
+   }
+   if (result == 0) {
+      result = write_bytes(file, friend_records, num_friends * sizeof(snapshot_friend_t));
+   }
+   free(positions);
+   free(user_records);
+   free(friend_records);
+   free(post_records);
+
+   // third pass: the string table
+   for (size_t i = 0; result == 0 && i < num_users; i++) {
+      user_t *user = sorted[i];
+      result = write_bytes(file, user->username, strlen(user->username) + 1);
+      post_cursor_t cursor;
+      for (post_t *current = post_list_seek(&user->posts, 0, &cursor); result == 0 && current != NULL; current = post_list_next(&cursor)) {
+         result = write_bytes(file, current->content, current->length + 1);
+      }
+   }
+   return result;
+}
+
+
+/*
+   Function that writes all the users, their friends and posts to a snapshot file.
+   The file is written next to its final name and renamed into place when complete.
+   Return 0 on success and -1 on error.
+*/
+int snapshot_write(const char *path, user_t *users)
+{
+   size_t num_users = 0;
+   user_t **sorted = users != NULL ? index_sorted_users(&num_users) : NULL;
+   int result = snapshot_write_users(path, sorted, num_users, 0);
+   free(sorted);
+   return result;
+}
+
+
+/*
+   Function that writes users sorted by username, their friends and posts to a snapshot file.
+   Every user's id must be lower than num_users, and so must be the ids of their friends.
+   log_records is the number of records of the write-ahead log that the users include.
+   The file is written next to its final name and renamed into place when complete.
+   Return 0 on success and -1 on error.
+*/
+int snapshot_write_users(const char *path, user_t **sorted, size_t num_users, uint64_t log_records)
+{
+   char temp_path[4096];
+   if (snprintf(temp_path, sizeof(temp_path), "%s.tmp", path) >= (int)sizeof(temp_path)) {
+      return -1;
+   }
+
+   FILE *file = fopen(temp_path, "wb");
+   if (file == NULL) {
+      return -1;
+   }
+
+   int result = write_sections(file, sorted, num_users, log_records);
+   if (result == 0 && fflush(file) != 0) {
+      result = -1;
+   }
+   if (result == 0 && fsync(fileno(file)) != 0) {
+      result = -1;
+   }
+   if (fclose(file) != 0) {
+      result = -1;
+   }
+
+   if (result == 0 && rename(temp_path, path) != 0) {
+      result = -1;
+   }
+   if (result != 0) {
+      remove(temp_path);
+   }
+   return result;
+}
+
+
+/*
+   Function that checks that a section of count records of the given size lies inside the file.
+*/
+static _Bool section_fits(uint64_t offset, uint64_t count, uint64_t size, size_t file_size)
+{
+   return offset <= file_size && count <= (file_size - offset) / size;
+}
+
+
+/*
+   Function that opens a snapshot file with mmap and checks its header and sections.
+   Return the opened snapshot, or NULL if the file can not be opened or is not valid.
+*/
+snapshot_t *snapshot_open(const char *path)
+{
+   int fd = open(path, O_RDONLY);
+   if (fd < 0) {
+      return NULL;
+   }
+
+   struct stat info;
+   if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(snapshot_header_t)) {
+      close(fd);
+      return NULL;
+   }
+
+   // map the whole file, pages are only read from disk when they are first used
+   size_t map_size = info.st_size;
+   void *map = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+   if (map == MAP_FAILED) {
+      return NULL;
+   }
+
+   const snapshot_header_t *header = map;
+   const char *base = map;
+   _Bool valid = memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) == 0
+      && header->version == SNAPSHOT_VERSION
+      && section_fits(header->users_offset, header->user_count, sizeof(snapshot_user_t), map_size)
+      && section_fits(header->friends_offset, header->friend_count, sizeof(snapshot_friend_t), map_size)
+      && section_fits(header->posts_offset, header->post_count, sizeof(snapshot_post_t), map_size)
+      && section_fits(header->strings_offset, header->strings_size, 1, map_size)
+      && header->users_offset % sizeof(uint32_t) == 0
+      && header->posts_offset % sizeof(uint64_t) == 0
+      && header->friends_offset % sizeof(uint32_t) == 0;
+
+   // every string must be terminated inside the string table
+   if (valid && header->strings_size > 0) {
+      valid = base[header->strings_offset + header->strings_size - 1] == '\0';
+   }
+
+   if (!valid) {
+      munmap(map, map_size);
+      return NULL;
+   }
+
+   snapshot_t *snapshot = malloc(sizeof(snapshot_t));
+   assert(snapshot != NULL);
+   snapshot->map = map;
+   snapshot->map_size = map_size;
+   snapshot->header = header;
+   snapshot->users = (const snapshot_user_t *)(base + header->users_offset);
+   snapshot->friends = (const snapshot_friend_t *)(base + header->friends_offset);
+   snapshot->posts = (const snapshot_post_t *)(base + header->posts_offset);
+   snapshot->strings = base + header->strings_offset;
+   return snapshot;
+}
+
+
+/*
+   Function that checks that a user's friend and post ranges are inside their sections.
+   The ranges are checked when a user is used rather than when the file is opened,
+   so opening a snapshot does not touch every page of it.
+*/
+static _Bool user_in_range(const snapshot_t *snapshot, const snapshot_user_t *record)
+{
+   const snapshot_header_t *header = snapshot->header;
+   return record->first_friend <= header->friend_count
+      && record->friend_count <= header->friend_count - record->first_friend
+      && record->first_post <= header->post_count
+      && record->post_count <= header->post_count - record->first_post;
+}
+
+
+/*
+   Function that returns a string of the snapshot's string table.
+*/
+const char *snapshot_string(const snapshot_t *snapshot, uint32_t offset)
+{
+   if (offset >= snapshot->header->strings_size) {
+      return "";
+   }
+   return snapshot->strings + offset;
+}
+
+
+/*
+   Function that searches a user by username with a binary search over the user records.
+   Return the user's record or NULL if not found.
+*/
+const snapshot_user_t *snapshot_find_user(const snapshot_t *snapshot, const char *username)
+{
+   size_t low = 0;
+   size_t high = snapshot->header->user_count;
+   while (low < high) {
+      size_t middle = low + (high - low) / 2;
+      int comparison = strcmp(snapshot_string(snapshot, snapshot->users[middle].username), username);
+      if (comparison == 0) {
+         return &snapshot->users[middle];
+      }
+      if (comparison < 0) {
+         low = middle + 1;
+      } else {
+         high = middle;
+      }
+   }
+   return NULL;
+}
+
+
+// A post record waiting to be added to its user
+typedef struct loaded_post
+{
+   user_t *user;
+   const snapshot_post_t *record;
+} loaded_post_t;
+
+
+/*
+   Function that compares two post records by id, used to add the posts in their original order.
+*/
+static int compare_loaded_posts(const void *a, const void *b)
+{
+   uint64_t first = ((const loaded_post_t *)a)->record->id;
+   uint64_t second = ((const loaded_post_t *)b)->record->id;
+   return (first > second) - (first < second);
+}
+
+
+/*
+   Function that creates the linked list of users, friends and posts stored in a snapshot,
+   registering every one of them as a load from a CSV file does. The posts point at their text
+   in the snapshot, which must not be closed while they live. Returns the head of the list.
+*/
+user_t *snapshot_load_users(const snapshot_t *snapshot)
+{
+   user_t *users = NULL;
+   uint32_t user_count = snapshot->header->user_count;
+
+   // users first, so that every friend exists when the friendships are added
+   user_t **loaded = calloc(user_count + 1, sizeof(user_t *));
+   assert(loaded != NULL);
+   size_t num_posts = 0;
+   for (uint32_t i = 0; i < user_count; i++) {
+      const snapshot_user_t *record = &snapshot->users[i];
+      if (!user_in_range(snapshot, record)) {
+         continue;
+      }
+
+      loaded[i] = insert_user_credential(&users, snapshot_string(snapshot, record->username), &record->credential);
+      if (loaded[i] != NULL) {
+         num_posts += record->post_count;
+      }
+   }
+
+   // every friendship has a record on both sides, it is added from the side of the first user
+   for (uint32_t i = 0; i < user_count; i++) {
+      const snapshot_user_t *record = &snapshot->users[i];
+      for (uint32_t j = 0; loaded[i] != NULL && j < record->friend_count; j++) {
+         uint32_t position = snapshot->friends[record->first_friend + j].user;
+         if (position > i && position < user_count && loaded[position] != NULL) {
+            add_friend_id(loaded[i], loaded[position]->id);
+         }
+      }
+   }
+
+   // add the posts of all the users in the order they were first added, so that they
+   // get their ids back and the news feeds stay sorted by time
+   loaded_post_t *posts = malloc((num_posts + 1) * sizeof(loaded_post_t));
+   assert(posts != NULL);
+   num_posts = 0;
+   for (uint32_t i = 0; i < user_count; i++) {
+      const snapshot_user_t *record = &snapshot->users[i];
+      for (uint32_t j = 0; loaded[i] != NULL && j < record->post_count; j++) {
+         posts[num_posts].user = loaded[i];
+         posts[num_posts].record = &snapshot->posts[record->first_post + j];
+         num_posts++;
+      }
+   }
+   qsort(posts, num_posts, sizeof(loaded_post_t), compare_loaded_posts);
+
+   // the posts point at their text in the string table instead of copying it, and are only
+   // indexed for the search by the first search; a post whose id was already given, which
+   // only a damaged file can hold, is dropped
+   search_defer();
+   for (size_t i = 0; i < num_posts; i++) {
+      add_mapped_post(posts[i].user, snapshot_string(snapshot, posts[i].record->content),
+                      posts[i].record->id, posts[i].record->created);
+   }
+   free(posts);
+   free(loaded);
+   return users;
+}
+
+
+/*
+   Function that compares a snapshot with the users in memory.
+   Return the number of users whose details, friends or posts differ.
+*/
+size_t snapshot_verify(const snapshot_t *snapshot, user_t *users)
+{
+   size_t num_users = 0;
+   user_t **sorted = users != NULL ? index_sorted_users(&num_users) : NULL;
+   size_t differences = 0;
+
+   if (num_users != snapshot->header->user_count) {
+      differences += num_users > snapshot->header->user_count
+         ? num_users - snapshot->header->user_count
+         : snapshot->header->user_count - num_users;
+   }
+
+   for (size_t i = 0; i < num_users; i++) {
+      const snapshot_user_t *record = snapshot_find_user(snapshot, sorted[i]->username);
+      if (record == NULL || !user_in_range(snapshot, record)
+          || memcmp(&record->credential, &sorted[i]->credential, sizeof(credential_t)) != 0) {
+         differences++;
+         continue;
+      }
+
+      _Bool same = record->friend_count == sorted[i]->friends.count;
+      for (uint32_t j = 0; same && j < record->friend_count; j++) {
+         uint32_t position = snapshot->friends[record->first_friend + j].user;
+         user_t *friend_user = position < snapshot->header->user_count
+            ? index_find_user(snapshot_string(snapshot, snapshot->users[position].username))
+            : NULL;
+         same = friend_user != NULL && are_friends(sorted[i], friend_user);
+      }
+
+      uint32_t j = 0;
+      post_cursor_t cursor;
+      for (post_t *current = post_list_seek(&sorted[i]->posts, 0, &cursor); same && current != NULL; current = post_list_next(&cursor), j++) {
+         same = j < record->post_count
+            && strcmp(snapshot_string(snapshot, snapshot->posts[record->first_post + j].content), current->content) == 0;
+      }
+      same = same && j == record->post_count;
+
+      if (!same) {
+         differences++;
+      }
+   }
+   free(sorted);
+   return differences;
+}
+
+
+/*
+   Function that unmaps a snapshot and frees it.
+*/
+void snapshot_close(snapshot_t *snapshot)
+{
+   if (snapshot != NULL) {
+      munmap(snapshot->map, snapshot->map_size);
+      free(snapshot);
+   }
+}
@@ -0,0 +1,141 @@
+/**
+ * @file snapshot.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file defines the binary snapshot format of the users database
+ * and declares the functions to write a snapshot and to open one with mmap.
+ *
+ * A snapshot is a header followed by fixed-size user, friend and post records
+ * and a string table. Records refer to each other and to the strings with
+ * offsets instead of pointers, so a mapped file can be used without parsing.
+ * Users are stored sorted by username.
+ *
+ * Opening a snapshot maps it and reads nothing else, and snapshot_find_user
+ * looks users up in the mapped records. The program starts with
+ * snapshot_load_users, which registers every user, friendship and post again,
+ * because the search index, the trending counts, the feeds, the friend ids
+ * and the full listings all need every record in memory. The texts of the
+ * posts are not copied: the posts point into the mapped string table, so the
+ * snapshot stays open while they live. Starting from a snapshot skips the
+ * parsing and the password hashing of a CSV file, but it still takes a pass
+ * over the records.
+ */
+
+#ifndef __A2_SNAPSHOT_H__
+#define __A2_SNAPSHOT_H__
+#include <stddef.h>
+#include <stdint.h>
+#include "nodes.h"
+
+#define SNAPSHOT_MAGIC "FBSNAP01"
+#define SNAPSHOT_VERSION 5
+
+// Header at the beginning of every snapshot file
+typedef struct snapshot_header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t user_count;
+    uint32_t friend_count;
+    uint32_t post_count;
+    uint64_t users_offset;    // file offsets of every section
+    uint64_t posts_offset;
+    uint64_t friends_offset;
+    uint64_t strings_offset;
+    uint64_t strings_size;
+    uint64_t log_records;     // records of the write-ahead log already included in the snapshot
+} snapshot_header_t;
+
+// A user's record, its friends and posts are ranges of the friend and post records
+typedef struct snapshot_user
+{
+    uint32_t username;        // offset in the string table
+    credential_t credential;  // the hash of the password, never the password itself
+    uint32_t first_friend;
+    uint32_t friend_count;
+    uint32_t first_post;      // posts are stored newest first
+    uint32_t post_count;
+} snapshot_user_t;
+
+// A friend's record, friendships go both ways so every friendship has two records
+typedef struct snapshot_friend
+{
+    uint32_t user;            // position of the friend in the user records
+} snapshot_friend_t;
+
+// A post's record
+typedef struct snapshot_post
+{
+    uint32_t content;
+    uint32_t length;
+    uint64_t id;              // posts keep their id when they are loaded
+    int64_t created;
+} snapshot_post_t;
+
+// An opened snapshot, the sections point into the mapped file
+typedef struct snapshot
+{
+    void *map;
+    size_t map_size;
+    const snapshot_header_t *header;
+    const snapshot_user_t *users;
+    const snapshot_friend_t *friends;
+    const snapshot_post_t *posts;
+    const char *strings;
+} snapshot_t;
+
+/*
+   Function that writes all the users, their friends and posts to a snapshot file.
+   The file is written next to its final name and renamed into place when complete.
+   Return 0 on success and -1 on error.
+*/
+int snapshot_write(const char *path, user_t *users);
+
+/*
+   Function that writes users sorted by username, their friends and posts to a snapshot file.
+   Every user's id must be lower than num_users, and so must be the ids of their friends.
+   log_records is the number of records of the write-ahead log that the users include.
+   The file is written next to its final name and renamed into place when complete.
+   Return 0 on success and -1 on error.
+*/
+int snapshot_write_users(const char *path, user_t **sorted, size_t num_users, uint64_t log_records);
+
+/*
+   Function that opens a snapshot file with mmap and checks its header and sections.
+   Return the opened snapshot, or NULL if the file can not be opened or is not valid.
+*/
+snapshot_t *snapshot_open(const char *path);
+
+/*
+   Function that returns a string of the snapshot's string table.
+*/
+const char *snapshot_string(const snapshot_t *snapshot, uint32_t offset);
+
+/*
+   Function that searches a user by username with a binary search over the user records.
+   Return the user's record or NULL if not found.
+*/
+const snapshot_user_t *snapshot_find_user(const snapshot_t *snapshot, const char *username);
+
+/*
+   Function that creates the linked list of users, friends and posts stored in a snapshot,
+   registering every one of them as a load from a CSV file does. The posts point at their text
+   in the snapshot, which must not be closed while they live. Returns the head of the list.
+*/
+user_t *snapshot_load_users(const snapshot_t *snapshot);
+
+/*
+   Function that compares a snapshot with the users in memory.
+   Return the number of users whose details, friends or posts differ.
+*/
+size_t snapshot_verify(const snapshot_t *snapshot, user_t *users);
+
+/*
+   Function that unmaps a snapshot and frees it.
+*/
+void snapshot_close(snapshot_t *snapshot);
+
+
+#endif
@@ -0,0 +1,97 @@
+/**
+ * @file text_arena.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the text arena. Texts are packed
+ * one after the other in 1 MB blocks, so a post only uses as many bytes as
+ * its content. Blocks are never moved or reallocated, which keeps every
+ * returned text valid until the arena is released.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "text_arena.h"
+#include "metrics.h"
+
+#define BLOCK_BYTES (1024 * 1024)
+
+// A block of texts, the texts follow the header in the same allocation
+typedef struct text_block
+{
+   struct text_block *next;
+   size_t size;
+   size_t used;
+} text_block_t;
+
+static text_block_t *blocks = NULL;  // the block being filled is first
+static size_t used_bytes = 0;
+static size_t reserved_bytes = 0;
+
+
+/*
+   Function that copies a text of the given length to the arena.
+   Return the copy, which is terminated by '\0' and never moves.
+*/
+const char *text_append(const char *text, size_t length)
+{
+   size_t needed = length + 1;
+
+   if (blocks == NULL || blocks->size - blocks->used < needed) {
+      // start a new block, texts longer than a block get a block of their own
+      size_t size = needed > BLOCK_BYTES ? needed : BLOCK_BYTES;
+      text_block_t *block = malloc(sizeof(text_block_t) + size);
+      assert(block != NULL);
+      block->size = size;
+      block->used = 0;
+      block->next = blocks;
+      blocks = block;
+      reserved_bytes += size;
+      METRICS_GAUGE_ADD(GAUGE_TEXT_BYTES, size);
+   }
+
+   char *copy = (char *)(blocks + 1) + blocks->used;
+   memcpy(copy, text, length);
+   copy[length] = '\0';
+   blocks->used += needed;
+   used_bytes += needed;
+   return copy;
+}
+
+
+/*
+   Function that returns the number of bytes of text stored in the arena.
+*/
+size_t text_arena_used()
+{
+   return used_bytes;
+}
+
+
+/*
+   Function that returns the number of bytes reserved by the arena's blocks.
+*/
+size_t text_arena_reserved()
+{
+   return reserved_bytes;
+}
+
+
+/*
+   Function that frees all the texts of the arena at once.
+*/
+void text_arena_release()
+{
+   text_block_t *current = blocks;
+   while (current != NULL) {
+      text_block_t *next_block = current->next;
+      free(current);
+      current = next_block;
+   }
+   blocks = NULL;
+   METRICS_GAUGE_ADD(GAUGE_TEXT_BYTES, -(long)reserved_bytes);
+   used_bytes = 0;
+   reserved_bytes = 0;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file text_arena.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the text arena, an append-only store for the
+ * content of the posts. Every text is copied once into a large block and
+ * keeps its address until the arena is released.
+ */
+
+#ifndef __A2_TEXT_ARENA_H__
+#define __A2_TEXT_ARENA_H__
+#include <stddef.h>
+
+/*
+   Function that copies a text of the given length to the arena.
+   Return the copy, which is terminated by '\0' and never moves.
+*/
+const char *text_append(const char *text, size_t length);
+
+/*
+   Function that returns the number of bytes of text stored in the arena.
+*/
+size_t text_arena_used();
+
+/*
+   Function that returns the number of bytes reserved by the arena's blocks.
+*/
+size_t text_arena_reserved();
+
+/*
+   Function that frees all the texts of the arena at once.
+*/
+void text_arena_release();
+
+
+#endif
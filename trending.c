@@ -0,0 +1,489 @@
+/**
+ * @file trending.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the trending hashtags.
+ *
+ * A window is a ring of time buckets, each with a Count-Min sketch: a few
+ * rows of counters, where a hashtag adds one to a counter chosen by a
+ * different hash in every row. The count of a hashtag is the smallest of
+ * its counters, which only other hashtags sharing them can make too high.
+ * The window also keeps the sum of the sketches of its buckets, so a count
+ * over the whole window takes one counter per row; when a bucket gets too
+ * old, it is subtracted from the sum and cleared.
+ *
+ * The most used hashtags are candidates kept in a min-heap by count. A
+ * hashtag that is used replaces the least used candidate if its count is
+ * higher. The candidates are counted again whenever a bucket expires and
+ * before they are listed.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <pthread.h>
+#include "nodes.h"
+#include "trending.h"
+
+#define SKETCH_DEPTH 4
+#define SKETCH_WIDTH_BITS 12
+#define SKETCH_WIDTH (1u << SKETCH_WIDTH_BITS)
+#define CANDIDATE_SLOTS 128         // hash table of the candidates, more than twice TRENDING_MAX_TOP
+#define MAX_TAGS_PER_POST 32
+#define FNV64_OFFSET 14695981039346656037ull
+#define FNV64_PRIME 1099511628211ull
+#define E 2.718281828
+
+// Counters of a Count-Min sketch
+typedef struct sketch
+{
+    uint32_t counters[SKETCH_DEPTH][SKETCH_WIDTH];
+} sketch_t;
+
+// A hashtag that may be one of the most used of a window
+typedef struct candidate
+{
+    trending_tag_t tag;
+    uint64_t hash;
+    int heap_position;
+    int slot;               // the candidate's slot in the hash table of the candidates
+} candidate_t;
+
+// A sliding time window
+typedef struct window
+{
+    time_t bucket_seconds;
+    int num_buckets;
+    long newest;                            // the newest bucket number, time / bucket_seconds
+    sketch_t total;                         // the sum of the buckets
+    sketch_t *buckets;
+    candidate_t candidates[TRENDING_MAX_TOP];
+    int heap[TRENDING_MAX_TOP];             // the candidates, the least used first
+    int num_candidates;
+    int slots[CANDIDATE_SLOTS];             // candidates by hash, -1 for an empty slot
+} window_t;
+
+static pthread_mutex_t trending_lock = PTHREAD_MUTEX_INITIALIZER;   // protects the windows
+static window_t windows[NUM_TRENDING_WINDOWS];
+static const time_t bucket_seconds[NUM_TRENDING_WINDOWS] = { 5, 60 };
+static const int num_buckets[NUM_TRENDING_WINDOWS] = { 12, 60 };
+static _Bool initialized = 0;
+
+
+/*
+   Function that empties every window, allocating their buckets the first time. The lock must be held.
+*/
+static void reset_windows()
+{
+   for (int i = 0; i < NUM_TRENDING_WINDOWS; i++) {
+      sketch_t *buckets = windows[i].buckets;
+      if (buckets == NULL) {
+         buckets = malloc(num_buckets[i] * sizeof(sketch_t));
+         assert(buckets != NULL);
+      }
+      memset(buckets, 0, num_buckets[i] * sizeof(sketch_t));
+      memset(&windows[i], 0, sizeof(window_t));
+      windows[i].buckets = buckets;
+      windows[i].bucket_seconds = bucket_seconds[i];
+      windows[i].num_buckets = num_buckets[i];
+      windows[i].newest = -1;
+      memset(windows[i].slots, -1, sizeof(windows[i].slots));
+   }
+   initialized = 1;
+}
+
+
+/*
+   Function that tells if a character can be part of a hashtag.
+*/
+static _Bool is_tag_char(unsigned char c)
+{
+   return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c >= 0x80;
+}
+
+
+/*
+   Function that finds the next hashtag of a text and moves the cursor past it. The hashtag,
+   with its '#' and cut to TRENDING_TAG_LENGTH characters, is stored in tag and its hash,
+   which ignores case, in hash. Return the length of the hashtag or 0 at the end of the text.
+*/
+static size_t next_tag(const char **cursor, char *tag, uint64_t *hash)
+{
+   const char *p = *cursor;
+   while (*p != '\0' && !(*p == '#' && is_tag_char(p[1]))) {
+      p++;
+   }
+   if (*p == '\0') {
+      *cursor = p;
+      return 0;
+   }
+
+   size_t length = 0;
+   *hash = FNV64_OFFSET;
+   tag[length++] = *p++;
+   while (is_tag_char(*p)) {
+      if (length <= TRENDING_TAG_LENGTH) {
+         char lower = *p >= 'A' && *p <= 'Z' ? *p + 'a' - 'A' : *p;
+         *hash = (*hash ^ (unsigned char)lower) * FNV64_PRIME;
+         tag[length++] = *p;
+      }
+      p++;
+   }
+   tag[length] = '\0';
+   *cursor = p;
+   return length;
+}
+
+
+/*
+   Function that returns the counter of a hash in a row of a sketch. Every row uses a
+   different combination of the two halves of the hash.
+*/
+static uint32_t *counter(sketch_t *sketch, int row, uint64_t hash)
+{
+   uint32_t low = (uint32_t)hash;
+   uint32_t high = (uint32_t)(hash >> 32) | 1;
+   return &sketch->counters[row][(low + row * high) & (SKETCH_WIDTH - 1)];
+}
+
+
+/*
+   Function that returns the count of a hash over a whole window.
+*/
+static unsigned long estimate(window_t *window, uint64_t hash)
+{
+   uint32_t count = *counter(&window->total, 0, hash);
+   for (int row = 1; row < SKETCH_DEPTH; row++) {
+      uint32_t value = *counter(&window->total, row, hash);
+      if (value < count) {
+         count = value;
+      }
+   }
+   return count;
+}
+
+
+/*
+   Function that swaps two entries of the heap of candidates.
+*/
+static void swap_heap(window_t *window, int a, int b)
+{
+   int candidate = window->heap[a];
+   window->heap[a] = window->heap[b];
+   window->heap[b] = candidate;
+   window->candidates[window->heap[a]].heap_position = a;
+   window->candidates[window->heap[b]].heap_position = b;
+}
+
+
+/*
+   Function that returns the count of the candidate at a position of the heap.
+*/
+static unsigned long heap_count(window_t *window, int position)
+{
+   return window->candidates[window->heap[position]].tag.count;
+}
+
+
+/*
+   Function that moves a candidate down the heap until its children are used more.
+*/
+static void sift_down(window_t *window, int position)
+{
+   while (1) {
+      int smallest = position;
+      int left = 2 * position + 1;
+      int right = left + 1;
+      if (left < window->num_candidates && heap_count(window, left) < heap_count(window, smallest)) {
+         smallest = left;
+      }
+      if (right < window->num_candidates && heap_count(window, right) < heap_count(window, smallest)) {
+         smallest = right;
+      }
+      if (smallest == position) {
+         return;
+      }
+      swap_heap(window, position, smallest);
+      position = smallest;
+   }
+}
+
+
+/*
+   Function that moves a candidate up the heap until its parent is used less.
+*/
+static void sift_up(window_t *window, int position)
+{
+   while (position > 0 && heap_count(window, (position - 1) / 2) > heap_count(window, position)) {
+      swap_heap(window, position, (position - 1) / 2);
+      position = (position - 1) / 2;
+   }
+}
+
+
+/*
+   Function that returns the candidate with a hash, or NULL if the hashtag is not a candidate.
+*/
+static candidate_t *find_candidate(window_t *window, uint64_t hash)
+{
+   for (int slot = hash & (CANDIDATE_SLOTS - 1); window->slots[slot] >= 0; slot = (slot + 1) & (CANDIDATE_SLOTS - 1)) {
+      if (window->candidates[window->slots[slot]].hash == hash) {
+         return &window->candidates[window->slots[slot]];
+      }
+   }
+   return NULL;
+}
+
+
+/*
+   Function that adds a candidate to the hash table of the candidates.
+*/
+static void insert_slot(window_t *window, int index)
+{
+   int slot = window->candidates[index].hash & (CANDIDATE_SLOTS - 1);
+   while (window->slots[slot] >= 0) {
+      slot = (slot + 1) & (CANDIDATE_SLOTS - 1);
+   }
+   window->slots[slot] = index;
+   window->candidates[index].slot = slot;
+}
+
+
+/*
+   Function that removes a candidate from the hash table of the candidates, moving back
+   the candidates after it that would no longer be found.
+*/
+static void remove_slot(window_t *window, int index)
+{
+   int empty = window->candidates[index].slot;
+   window->slots[empty] = -1;
+   for (int slot = (empty + 1) & (CANDIDATE_SLOTS - 1); window->slots[slot] >= 0; slot = (slot + 1) & (CANDIDATE_SLOTS - 1)) {
+      int home = window->candidates[window->slots[slot]].hash & (CANDIDATE_SLOTS - 1);
+      // the entry can move to the empty slot if its home is not between the two
+      if (((slot - home) & (CANDIDATE_SLOTS - 1)) >= ((slot - empty) & (CANDIDATE_SLOTS - 1))) {
+         window->slots[empty] = window->slots[slot];
+         window->candidates[window->slots[empty]].slot = empty;
+         window->slots[slot] = -1;
+         empty = slot;
+      }
+   }
+}
+
+
+/*
+   Function that counts every candidate again and rebuilds the heap.
+*/
+static void recount_candidates(window_t *window)
+{
+   for (int i = 0; i < window->num_candidates; i++) {
+      candidate_t *candidate = &window->candidates[window->heap[i]];
+      candidate->tag.count = estimate(window, candidate->hash);
+   }
+   for (int i = window->num_candidates / 2 - 1; i >= 0; i--) {
+      sift_down(window, i);
+   }
+}
+
+
+/*
+   Function that moves a window forward so that its newest bucket is the one of a time.
+   The buckets that fall out of the window are removed from its total and cleared.
+*/
+static void advance(window_t *window, time_t time)
+{
+   long bucket = time / window->bucket_seconds;
+   if (bucket <= window->newest) {
+      return;
+   }
+
+   if (window->newest < 0 || bucket - window->newest >= window->num_buckets) {
+      // every bucket is too old
+      memset(&window->total, 0, sizeof(sketch_t));
+      memset(window->buckets, 0, window->num_buckets * sizeof(sketch_t));
+   } else {
+      for (long expired = window->newest + 1; expired <= bucket; expired++) {
+         sketch_t *old = &window->buckets[expired % window->num_buckets];
+         for (int row = 0; row < SKETCH_DEPTH; row++) {
+            for (unsigned int i = 0; i < SKETCH_WIDTH; i++) {
+               window->total.counters[row][i] -= old->counters[row][i];
+            }
+         }
+         memset(old, 0, sizeof(sketch_t));
+      }
+   }
+   window->newest = bucket;
+   recount_candidates(window);
+}
+
+
+/*
+   Function that counts a hashtag used at a time in a window.
+*/
+static void count_tag(window_t *window, const char *tag, uint64_t hash, time_t time)
+{
+   advance(window, time);
+   long bucket = time / window->bucket_seconds;
+   if (bucket <= window->newest - window->num_buckets) {
+      return; // older than the window
+   }
+
+   sketch_t *sketch = &window->buckets[bucket % window->num_buckets];
+   for (int row = 0; row < SKETCH_DEPTH; row++) {
+      (*counter(sketch, row, hash))++;
+      (*counter(&window->total, row, hash))++;
+   }
+   unsigned long count = estimate(window, hash);
+
+   candidate_t *candidate = find_candidate(window, hash);
+   if (candidate != NULL) {
+      candidate->tag.count = count;
+      sift_down(window, candidate->heap_position);
+      return;
+   }
+
+   int index;
+   if (window->num_candidates < TRENDING_MAX_TOP) {
+      index = window->num_candidates;
+      window->heap[index] = index;
+      window->candidates[index].heap_position = index;
+      window->num_candidates++;
+   } else if (count > heap_count(window, 0)) {
+      // replace the least used candidate
+      index = window->heap[0];
+      remove_slot(window, index);
+   } else {
+      return;
+   }
+   candidate = &window->candidates[index];
+   strcpy(candidate->tag.tag, tag);
+   candidate->tag.count = count;
+   candidate->hash = hash;
+   insert_slot(window, index);
+   sift_up(window, candidate->heap_position);
+   sift_down(window, candidate->heap_position);
+}
+
+
+/*
+   Function that counts the hashtags of a new post at the time it was created.
+   Posts older than a window are not counted in it.
+*/
+void trending_add_post(const post_t *post)
+{
+   char tag[TRENDING_TAG_LENGTH + 2];
+   uint64_t seen[MAX_TAGS_PER_POST];
+   int num_seen = 0;
+   uint64_t hash;
+   const char *cursor = post->content;
+
+   pthread_mutex_lock(&trending_lock);
+   if (!initialized) {
+      reset_windows();
+   }
+   while (next_tag(&cursor, tag, &hash) > 0) {
+      // a hashtag repeated in a post is counted once
+      int i = 0;
+      while (i < num_seen && seen[i] != hash) {
+         i++;
+      }
+      if (i < num_seen) {
+         continue;
+      }
+      if (num_seen < MAX_TAGS_PER_POST) {
+         seen[num_seen++] = hash;
+      }
+      for (int window = 0; window < NUM_TRENDING_WINDOWS; window++) {
+         count_tag(&windows[window], tag, hash, post->created);
+      }
+   }
+   pthread_mutex_unlock(&trending_lock);
+}
+
+
+/*
+   Function that compares two hashtags to sort them from the most used to the least used.
+*/
+static int compare_counts(const void *a, const void *b)
+{
+   unsigned long first = ((const trending_tag_t *)a)->count;
+   unsigned long second = ((const trending_tag_t *)b)->count;
+   return (first < second) - (first > second);
+}
+
+
+/*
+   Function that finds the most used hashtags of a window ending at now, most used first.
+   At most n hashtags, and no more than TRENDING_MAX_TOP, are stored in top.
+   Return the number of hashtags stored.
+*/
+size_t trending_top(trending_window_t which, time_t now, trending_tag_t *top, size_t n)
+{
+   trending_tag_t found[TRENDING_MAX_TOP];
+   size_t count = 0;
+
+   pthread_mutex_lock(&trending_lock);
+   if (!initialized) {
+      reset_windows();
+   }
+   window_t *window = &windows[which];
+   advance(window, now);
+   recount_candidates(window);
+   for (int i = 0; i < window->num_candidates; i++) {
+      if (window->candidates[i].tag.count > 0) {
+         found[count++] = window->candidates[i].tag;
+      }
+   }
+   pthread_mutex_unlock(&trending_lock);
+
+   qsort(found, count, sizeof(trending_tag_t), compare_counts);
+   if (count > n) {
+      count = n;
+   }
+   memcpy(top, found, count * sizeof(trending_tag_t));
+   return count;
+}
+
+
+/*
+   Function that returns the memory used by the counters of all the windows, in bytes.
+*/
+size_t trending_memory()
+{
+   size_t bytes = sizeof(windows);
+   for (int i = 0; i < NUM_TRENDING_WINDOWS; i++) {
+      bytes += num_buckets[i] * sizeof(sketch_t);
+   }
+   return bytes;
+}
+
+
+/*
+   Function that resets all the counters.
+*/
+void trending_clear()
+{
+   pthread_mutex_lock(&trending_lock);
+   reset_windows();
+   pthread_mutex_unlock(&trending_lock);
+}
+
+
+
+/*
+   Function that returns how much too high a count can be, as a fraction of the hashtags of its
+   window, and stores the probability that a count is not too high by more than that in confidence.
+*/
+double trending_error_bound(double *confidence)
+{
+   // a count is too high by more than e / width of the total with a probability of e^-depth at most
+   double failure = 1;
+   for (int row = 0; row < SKETCH_DEPTH; row++) {
+      failure /= E;
+   }
+   *confidence = 1 - failure;
+   return E / SKETCH_WIDTH;
+}
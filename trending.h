@@ -0,0 +1,71 @@
+/**
+ * @file trending.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the trending hashtags. The hashtags of every
+ * new post are counted, ignoring case, over the last minute and the last
+ * hour, and the most used ones of each window can be listed.
+ *
+ * The counts are approximate and take the same memory however many
+ * different hashtags are used: they can be too high, rarely by more than
+ * a small fraction of all the hashtags in the window, but never too low.
+ * Deleting a post does not change the counts.
+ */
+
+#ifndef __A2_TRENDING_H__
+#define __A2_TRENDING_H__
+#include <stddef.h>
+#include <time.h>
+#include "nodes.h"
+
+#define TRENDING_TAG_LENGTH 64
+#define TRENDING_MAX_TOP 50
+
+// The time windows that hashtags are counted over
+typedef enum trending_window
+{
+    TRENDING_MINUTE,
+    TRENDING_HOUR,
+    NUM_TRENDING_WINDOWS
+} trending_window_t;
+
+// A hashtag and how many posts used it in a window
+typedef struct trending_tag
+{
+    char tag[TRENDING_TAG_LENGTH + 2];  // the '#', the name and the terminating NUL
+    unsigned long count;
+} trending_tag_t;
+
+/*
+   Function that counts the hashtags of a new post at the time it was created.
+   Posts older than a window are not counted in it.
+*/
+void trending_add_post(const post_t *post);
+
+/*
+   Function that finds the most used hashtags of a window ending at now, most used first.
+   At most n hashtags, and no more than TRENDING_MAX_TOP, are stored in top.
+   Return the number of hashtags stored.
+*/
+size_t trending_top(trending_window_t window, time_t now, trending_tag_t *top, size_t n);
+
+/*
+   Function that returns the memory used by the counters of all the windows, in bytes.
+*/
+size_t trending_memory();
+
+/*
+   Function that resets all the counters.
+*/
+void trending_clear();
+
+/*
+   Function that returns how much too high a count can be, as a fraction of the hashtags of its
+   window, and stores the probability that a count is not too high by more than that in confidence.
+*/
+double trending_error_bound(double *confidence);
+
+
+#endif
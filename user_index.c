@@ -0,0 +1,432 @@
+/**
+ * @file user_index.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the user index. Users are stored
+ * in open-addressing hash tables (linear probing) keyed by username, so
+ * finding or registering a user no longer walks the whole users list.
+ *
+ * The users sorted by username are kept in one array in two sorted runs: the
+ * users merged so far, then the users added since (the pending users). A new
+ * user is inserted in the pending run while it is shorter than PENDING_LIMIT;
+ * after that it is only appended, and the pending users are sorted and merged
+ * into the first run before the array is next read. The merge looks up where
+ * every pending user goes and moves the users between those places in
+ * blocks, so it costs a binary search per pending user and a memmove of the
+ * array. Prefix searches read both runs, which keeps the usernames that were
+ * just registered available for completion without a merge per user.
+ *
+ * The index is split in INDEX_SHARDS shards, chosen by the top bits of the
+ * username's hash. Each shard has its own hash table and reader-writer lock.
+ * The index does not take the shard locks itself: callers that share the
+ * index between threads lock the shards of the users they work on (see
+ * index_lock_shards), which also protects those users' friends, posts and
+ * timelines. The ids, the users by id and the sorted view are shared by all
+ * shards and protected by a mutex of their own.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include "nodes.h"
+#include "user_index.h"
+
+#define INITIAL_CAPACITY 64
+#define PENDING_LIMIT 4096
+
+// users by id are kept in segments that never move, so they can be read while users are added
+#define SEGMENT_BITS 16
+#define SEGMENT_SIZE (1u << SEGMENT_BITS)
+#define MAX_SEGMENTS (1u << (32 - SEGMENT_BITS))
+
+// A shard of the hash table
+typedef struct shard
+{
+   user_t **slots;         // NULL marks an empty slot
+   uint32_t *slot_hashes;  // cached hash of every slot, avoids touching the user on a miss
+   size_t capacity;        // always a power of two
+   size_t count;
+   pthread_rwlock_t lock;
+} shard_t;
+
+static shard_t shards[INDEX_SHARDS];
+static pthread_once_t shards_once = PTHREAD_ONCE_INIT;
+
+static pthread_mutex_t users_lock = PTHREAD_MUTEX_INITIALIZER; // protects the fields below
+static user_t **by_id[MAX_SEGMENTS]; // users in the order they were added, indexed by id
+static size_t count = 0;             // also read without the lock, see index_user_count
+static user_t **ordered = NULL;      // users sorted by username, then the pending users
+static size_t ordered_capacity = 0;
+static size_t merged_count = 0;      // the users of ordered before the pending ones
+static _Bool pending_sorted = 1;     // false once a pending user was appended without being sorted
+
+
+/*
+   Function that hashes a username (32-bit FNV-1a).
+*/
+static uint32_t hash_username(const char *username)
+{
+   uint32_t hash = 2166136261u;
+   for (const unsigned char *c = (const unsigned char *)username; *c != '\0'; c++) {
+      hash ^= *c;
+      hash *= 16777619u;
+   }
+   return hash;
+}
+
+
+/*
+   Function that returns the shard of a hash; the low bits of the hash pick the slot in the shard.
+*/
+static unsigned int shard_of_hash(uint32_t hash)
+{
+   return hash >> (32 - INDEX_SHARD_BITS);
+}
+
+
+/*
+   Function that initializes the locks of the shards.
+*/
+static void init_shards()
+{
+   for (int i = 0; i < INDEX_SHARDS; i++) {
+      pthread_rwlock_init(&shards[i].lock, NULL);
+   }
+}
+
+
+/*
+   Function that places a user in the first empty slot of its probe sequence.
+*/
+static void place_user(shard_t *shard, user_t *user, uint32_t hash)
+{
+   size_t mask = shard->capacity - 1;
+   size_t i = hash & mask;
+   while (shard->slots[i] != NULL) {
+      i = (i + 1) & mask;
+   }
+   shard->slots[i] = user;
+   shard->slot_hashes[i] = hash;
+}
+
+
+/*
+   Function that doubles a shard's hash table and re-inserts every user.
+*/
+static void grow_table(shard_t *shard)
+{
+   user_t **old_slots = shard->slots;
+   uint32_t *old_hashes = shard->slot_hashes;
+   size_t old_capacity = shard->capacity;
+
+   shard->capacity = shard->capacity == 0 ? INITIAL_CAPACITY : shard->capacity * 2;
+   shard->slots = calloc(shard->capacity, sizeof(user_t *));
+   shard->slot_hashes = malloc(shard->capacity * sizeof(uint32_t));
+   assert(shard->slots != NULL && shard->slot_hashes != NULL);
+
+   for (size_t i = 0; i < old_capacity; i++) {
+      if (old_slots[i] != NULL) {
+         place_user(shard, old_slots[i], old_hashes[i]);
+      }
+   }
+   free(old_slots);
+   free(old_hashes);
+}
+
+
+/*
+   Function that searches a shard for a username.
+*/
+static user_t *shard_find_user(const shard_t *shard, const char *username, uint32_t hash)
+{
+   if (shard->count == 0) {
+      return NULL;
+   }
+
+   size_t mask = shard->capacity - 1;
+   for (size_t i = hash & mask; shard->slots[i] != NULL; i = (i + 1) & mask) {
+      if (shard->slot_hashes[i] == hash && strcmp(shard->slots[i]->username, username) == 0) {
+         return shard->slots[i];
+      }
+   }
+   return NULL;
+}
+
+
+/*
+   Function that returns the first position from low to high whose user's name is not
+   smaller than username, in a run of users sorted by username.
+*/
+static size_t lower_bound(size_t low, size_t high, const char *username)
+{
+   while (low < high) {
+      size_t middle = low + (high - low) / 2;
+      if (strcmp(ordered[middle]->username, username) < 0) {
+         low = middle + 1;
+      } else {
+         high = middle;
+      }
+   }
+   return low;
+}
+
+
+/*
+   Function that places the user appended at position last among the pending users,
+   as long as there are few enough of them to keep sorted one by one.
+*/
+static void insert_pending(size_t last)
+{
+   if (!pending_sorted || last - merged_count >= PENDING_LIMIT) {
+      pending_sorted = 0;
+      return;
+   }
+   user_t *user = ordered[last];
+   size_t position = lower_bound(merged_count, last, user->username);
+   memmove(&ordered[position + 1], &ordered[position], (last - position) * sizeof(user_t *));
+   ordered[position] = user;
+}
+
+
+/*
+   Function that adds a user to the index and gives it the next user id.
+   Return true if the user was added and false if the username is already taken.
+*/
+_Bool index_insert_user(user_t *user)
+{
+   uint32_t hash = hash_username(user->username);
+   shard_t *shard = &shards[shard_of_hash(hash)];
+   if (shard_find_user(shard, user->username, hash) != NULL) {
+      return 0;
+   }
+
+   // keep the load factor under 70% so probe sequences stay short
+   if ((shard->count + 1) * 10 > shard->capacity * 7) {
+      grow_table(shard);
+   }
+   place_user(shard, user, hash);
+   shard->count++;
+   user->shard = shard_of_hash(hash);
+
+   pthread_mutex_lock(&users_lock);
+   if (count == ordered_capacity) {
+      ordered_capacity = ordered_capacity == 0 ? INITIAL_CAPACITY : ordered_capacity * 2;
+      ordered = realloc(ordered, ordered_capacity * sizeof(user_t *));
+      assert(ordered != NULL);
+   }
+   if (by_id[count >> SEGMENT_BITS] == NULL) {
+      by_id[count >> SEGMENT_BITS] = malloc(SEGMENT_SIZE * sizeof(user_t *));
+      assert(by_id[count >> SEGMENT_BITS] != NULL);
+   }
+   user->id = count;
+   by_id[count >> SEGMENT_BITS][count & (SEGMENT_SIZE - 1)] = user;
+   ordered[count] = user;
+   insert_pending(count);
+
+   // the user can be found by id once the count includes it
+   __atomic_store_n(&count, count + 1, __ATOMIC_RELEASE);
+   pthread_mutex_unlock(&users_lock);
+   return 1;
+}
+
+
+/*
+   Function that searches the index for a username.
+   Return a pointer to the user if found and NULL if not found.
+*/
+user_t *index_find_user(const char *username)
+{
+   uint32_t hash = hash_username(username);
+   return shard_find_user(&shards[shard_of_hash(hash)], username, hash);
+}
+
+
+/*
+   Function that returns the user with the given id, or NULL if there is no such user.
+*/
+user_t *index_user_by_id(unsigned int id)
+{
+   if (id >= index_user_count()) {
+      return NULL;
+   }
+   return by_id[id >> SEGMENT_BITS][id & (SEGMENT_SIZE - 1)];
+}
+
+
+/*
+   Function that compares two users by username, used to sort the ordered view.
+*/
+static int compare_users(const void *a, const void *b)
+{
+   const user_t *first = *(user_t *const *)a;
+   const user_t *second = *(user_t *const *)b;
+   return strcmp(first->username, second->username);
+}
+
+
+/*
+   Function that merges the pending users into the sorted users.
+*/
+static void merge_pending()
+{
+   size_t pending = count - merged_count;
+   if (pending == 0) {
+      return;
+   }
+   if (!pending_sorted) {
+      qsort(&ordered[merged_count], pending, sizeof(user_t *), compare_users);
+      pending_sorted = 1;
+   }
+
+   if (merged_count > 0) {
+      user_t **added = malloc(pending * sizeof(user_t *));
+      assert(added != NULL);
+      memcpy(added, &ordered[merged_count], pending * sizeof(user_t *));
+
+      // from the last pending user down, the users after its place move up by the
+      // number of pending users not placed yet
+      size_t end = merged_count;
+      for (size_t i = pending; i > 0; i--) {
+         size_t position = lower_bound(0, end, added[i - 1]->username);
+         memmove(&ordered[position + i], &ordered[position], (end - position) * sizeof(user_t *));
+         ordered[position + i - 1] = added[i - 1];
+         end = position;
+      }
+      free(added);
+   }
+   merged_count = count;
+}
+
+
+/*
+   Function that returns all the indexed users sorted in ascending order by username.
+   The number of users is stored in num_users. The array is a copy, which the caller frees,
+   so users registered by other threads while it is read do not move it.
+*/
+user_t **index_sorted_users(size_t *num_users)
+{
+   pthread_mutex_lock(&users_lock);
+   merge_pending();
+   *num_users = count;
+   user_t **sorted = malloc((count + 1) * sizeof(user_t *));
+   assert(sorted != NULL);
+   memcpy(sorted, ordered, count * sizeof(user_t *));
+   pthread_mutex_unlock(&users_lock);
+   return sorted;
+}
+
+
+/*
+   Function that finds the users whose username starts with a prefix, in ascending order
+   by username. Up to limit users are stored in matches. Return the number of users stored.
+*/
+size_t index_complete(const char *prefix, user_t **matches, size_t limit)
+{
+   size_t length = strlen(prefix);
+   size_t found = 0;
+   pthread_mutex_lock(&users_lock);
+   if (!pending_sorted) {
+      merge_pending();
+   }
+
+   // the matches of each run are together from the first username not smaller than the prefix
+   size_t merged = lower_bound(0, merged_count, prefix);
+   size_t pending = lower_bound(merged_count, count, prefix);
+   _Bool merged_matches = merged < merged_count && strncmp(ordered[merged]->username, prefix, length) == 0;
+   _Bool pending_matches = pending < count && strncmp(ordered[pending]->username, prefix, length) == 0;
+   while (found < limit && (merged_matches || pending_matches)) {
+      if (merged_matches
+          && (!pending_matches || strcmp(ordered[merged]->username, ordered[pending]->username) < 0)) {
+         matches[found++] = ordered[merged++];
+         merged_matches = merged < merged_count && strncmp(ordered[merged]->username, prefix, length) == 0;
+      } else {
+         matches[found++] = ordered[pending++];
+         pending_matches = pending < count && strncmp(ordered[pending]->username, prefix, length) == 0;
+      }
+   }
+   pthread_mutex_unlock(&users_lock);
+   return found;
+}
+
+
+/*
+   Function that returns the number of users in the index.
+*/
+size_t index_user_count()
+{
+   return __atomic_load_n(&count, __ATOMIC_ACQUIRE);
+}
+
+
+/*
+   Function that returns the shard of a username.
+*/
+unsigned int index_shard_of(const char *username)
+{
+   return shard_of_hash(hash_username(username));
+}
+
+
+/*
+   Function that locks the shards of a set of users: the shards of write_mask for writing
+   and the other shards of read_mask for reading. Bit i of a mask stands for shard i.
+   The shards are always locked in ascending order, so that threads can not deadlock.
+*/
+void index_lock_shards(shard_mask_t read_mask, shard_mask_t write_mask)
+{
+   pthread_once(&shards_once, init_shards);
+   for (int i = 0; i < INDEX_SHARDS; i++) {
+      shard_mask_t bit = (shard_mask_t)1 << i;
+      if (write_mask & bit) {
+         pthread_rwlock_wrlock(&shards[i].lock);
+      } else if (read_mask & bit) {
+         pthread_rwlock_rdlock(&shards[i].lock);
+      }
+   }
+}
+
+
+/*
+   Function that unlocks the shards locked by index_lock_shards with the same masks.
+*/
+void index_unlock_shards(shard_mask_t read_mask, shard_mask_t write_mask)
+{
+   shard_mask_t locked = read_mask | write_mask;
+   for (int i = INDEX_SHARDS - 1; i >= 0; i--) {
+      if (locked & ((shard_mask_t)1 << i)) {
+         pthread_rwlock_unlock(&shards[i].lock);
+      }
+   }
+}
+
+
+/*
+   Function that empties the index and frees its memory.
+*/
+void index_clear()
+{
+   for (int i = 0; i < INDEX_SHARDS; i++) {
+      free(shards[i].slots);
+      free(shards[i].slot_hashes);
+      shards[i].slots = NULL;
+      shards[i].slot_hashes = NULL;
+      shards[i].capacity = 0;
+      shards[i].count = 0;
+   }
+   for (unsigned int i = 0; i < MAX_SEGMENTS && by_id[i] != NULL; i++) {
+      free(by_id[i]);
+      by_id[i] = NULL;
+   }
+   free(ordered);
+   ordered = NULL;
+   count = 0;
+   ordered_capacity = 0;
+   merged_count = 0;
+   pending_sorted = 1;
+}
+
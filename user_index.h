@@ -0,0 +1,86 @@
+/**
+ * @file user_index.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the user index: an open-addressing hash table
+ * keyed by username that gives constant time lookups, together with an
+ * ordered view of the users sorted by username for the listings and the
+ * completion of usernames from a prefix.
+ *
+ * The hash table is split in shards with a reader-writer lock each, which
+ * threads sharing the index use to lock the users they work on.
+ */
+
+#ifndef __A2_USER_INDEX_H__
+#define __A2_USER_INDEX_H__
+#include <stddef.h>
+#include <stdint.h>
+#include "nodes.h"
+
+#define INDEX_SHARD_BITS 6
+#define INDEX_SHARDS (1 << INDEX_SHARD_BITS)
+
+// A set of shards, bit i stands for shard i
+typedef uint64_t shard_mask_t;
+
+/*
+   Function that adds a user to the index and gives it the next user id.
+   Return true if the user was added and false if the username is already taken.
+*/
+_Bool index_insert_user(user_t *user);
+
+/*
+   Function that searches the index for a username.
+   Return a pointer to the user if found and NULL if not found.
+*/
+user_t *index_find_user(const char *username);
+
+/*
+   Function that returns the user with the given id, or NULL if there is no such user.
+*/
+user_t *index_user_by_id(unsigned int id);
+
+/*
+   Function that returns all the indexed users sorted in ascending order by username.
+   The number of users is stored in num_users. The array is a copy, which the caller frees,
+   so users registered by other threads while it is read do not move it.
+*/
+user_t **index_sorted_users(size_t *num_users);
+
+/*
+   Function that finds the users whose username starts with a prefix, in ascending order
+   by username. Up to limit users are stored in matches. Return the number of users stored.
+*/
+size_t index_complete(const char *prefix, user_t **matches, size_t limit);
+
+/*
+   Function that returns the number of users in the index.
+*/
+size_t index_user_count();
+
+/*
+   Function that returns the shard of a username.
+*/
+unsigned int index_shard_of(const char *username);
+
+/*
+   Function that locks the shards of a set of users: the shards of write_mask for writing
+   and the other shards of read_mask for reading. Bit i of a mask stands for shard i.
+   The shards are always locked in ascending order, so that threads can not deadlock.
+*/
+void index_lock_shards(shard_mask_t read_mask, shard_mask_t write_mask);
+
+/*
+   Function that unlocks the shards locked by index_lock_shards with the same masks.
+*/
+void index_unlock_shards(shard_mask_t read_mask, shard_mask_t write_mask);
+
+/*
+   Function that empties the index and frees its memory.
+*/
+void index_clear();
+
+
+#endif
@@ -0,0 +1,150 @@
+/**
+ * @file user_table.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the user table. The table is
+ * built with every shard of the user index locked for reading, in two
+ * passes over the sorted users: the first one sizes the columns and the
+ * second one fills them.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "nodes.h"
+#include "user_index.h"
+#include "password.h"
+#include "post_list.h"
+#include "user_table.h"
+
+
+/*
+   Function that allocates an array of a table, failing if there is not enough memory.
+*/
+static void *allocate_column(size_t count, size_t size)
+{
+   void *column = malloc((count + 1) * size);
+   assert(column != NULL);
+   return column;
+}
+
+
+/*
+   Function that builds a table of all the users, sorted by username.
+   Return the table, to be freed with user_table_free.
+*/
+user_table_t *user_table_build()
+{
+   // no user can change while the columns are filled
+   shard_mask_t all_shards = ~(shard_mask_t)0;
+   index_lock_shards(all_shards, 0);
+
+   size_t count;
+   user_t **sorted = index_sorted_users(&count);
+   size_t name_bytes = 0;
+   size_t num_friends = 0;
+   size_t num_posts = 0;
+   for (size_t i = 0; i < count; i++) {
+      name_bytes += strlen(sorted[i]->username) + 1;
+      num_friends += sorted[i]->friends.count;
+      num_posts += sorted[i]->posts.count;
+   }
+
+   user_table_t *table = malloc(sizeof(user_table_t));
+   assert(table != NULL);
+   table->count = count;
+   table->ids = allocate_column(count, sizeof(unsigned int));
+   table->name_offsets = allocate_column(count, sizeof(uint32_t));
+   table->names = allocate_column(name_bytes, sizeof(char));
+   table->credentials = allocate_column(count, sizeof(credential_t));
+   table->friend_offsets = allocate_column(count, sizeof(size_t));
+   table->friend_ids = allocate_column(num_friends, sizeof(unsigned int));
+   table->post_offsets = allocate_column(count, sizeof(size_t));
+   table->post_ids = allocate_column(num_posts, sizeof(unsigned long));
+
+   size_t name_offset = 0;
+   size_t friend_offset = 0;
+   size_t post_offset = 0;
+   for (size_t i = 0; i < count; i++) {
+      const user_t *user = sorted[i];
+      table->ids[i] = user->id;
+
+      size_t length = strlen(user->username) + 1;
+      table->name_offsets[i] = name_offset;
+      memcpy(&table->names[name_offset], user->username, length);
+      name_offset += length;
+
+      table->credentials[i] = user->credential;
+
+      table->friend_offsets[i] = friend_offset;
+      memcpy(&table->friend_ids[friend_offset], user->friends.ids, user->friends.count * sizeof(unsigned int));
+      friend_offset += user->friends.count;
+
+      table->post_offsets[i] = post_offset;
+      post_cursor_t cursor;
+      for (const post_t *current = post_list_seek(&user->posts, 0, &cursor); current != NULL; current = post_list_next(&cursor)) {
+         table->post_ids[post_offset++] = current->id;
+      }
+   }
+   table->name_offsets[count] = name_offset;
+   table->friend_offsets[count] = friend_offset;
+   table->post_offsets[count] = post_offset;
+
+   index_unlock_shards(all_shards, 0);
+   free(sorted);
+   return table;
+}
+
+
+/*
+   Function that frees a table.
+*/
+void user_table_free(user_table_t *table)
+{
+   if (table == NULL) {
+      return;
+   }
+   free(table->ids);
+   free(table->name_offsets);
+   free(table->names);
+   free(table->credentials);
+   free(table->friend_offsets);
+   free(table->friend_ids);
+   free(table->post_offsets);
+   free(table->post_ids);
+   free(table);
+}
+
+
+/*
+   Function that reads the row at a position of the table.
+*/
+void user_table_row(const user_table_t *table, size_t position, user_row_t *row)
+{
+   row->id = table->ids[position];
+   row->username = &table->names[table->name_offsets[position]];
+   row->credential = &table->credentials[position];
+   row->friends = &table->friend_ids[table->friend_offsets[position]];
+   row->friend_count = table->friend_offsets[position + 1] - table->friend_offsets[position];
+   row->posts = &table->post_ids[table->post_offsets[position]];
+   row->post_count = table->post_offsets[position + 1] - table->post_offsets[position];
+}
+
+
+/*
+   Function that reads the row at cursor and moves the cursor to the next row.
+   Start with cursor at 0. Return false when there are no more rows.
+*/
+_Bool user_table_next(const user_table_t *table, size_t *cursor, user_row_t *row)
+{
+   if (*cursor >= table->count) {
+      return 0;
+   }
+   user_table_row(table, *cursor, row);
+   (*cursor)++;
+   return 1;
+}
+
@@ -0,0 +1,72 @@
+/**
+ * @file user_table.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the user table, a view of all the users sorted
+ * by username where every field is a column of its own: the usernames, the
+ * credentials, and the ranges of every user's friends and posts in two shared
+ * arrays. Passes over all the users read the columns they need from start
+ * to end instead of following the pointers between the users' nodes.
+ *
+ * A table shows the users as they were when it was built; it does not see
+ * the changes made after.
+ */
+
+#ifndef __A2_USER_TABLE_H__
+#define __A2_USER_TABLE_H__
+#include <stddef.h>
+#include <stdint.h>
+#include "nodes.h"
+
+// The columns of the table; the ranges of row i are from offsets[i] to offsets[i + 1]
+typedef struct user_table
+{
+    size_t count;                       // rows, one per user
+    unsigned int *ids;                  // user id of every row
+    uint32_t *name_offsets;             // where every username starts in names
+    char *names;                        // the usernames, each terminated by '\0'
+    credential_t *credentials;          // salts and hashes of the passwords
+    size_t *friend_offsets;
+    unsigned int *friend_ids;           // user ids of the friends of every row, sorted
+    size_t *post_offsets;
+    unsigned long *post_ids;            // ids of the posts of every row, newest first
+} user_table_t;
+
+// A row of the table
+typedef struct user_row
+{
+    unsigned int id;
+    const char *username;
+    const credential_t *credential;
+    const unsigned int *friends;
+    size_t friend_count;
+    const unsigned long *posts;
+    size_t post_count;
+} user_row_t;
+
+/*
+   Function that builds a table of all the users, sorted by username.
+   Return the table, to be freed with user_table_free.
+*/
+user_table_t *user_table_build();
+
+/*
+   Function that frees a table.
+*/
+void user_table_free(user_table_t *table);
+
+/*
+   Function that reads the row at a position of the table.
+*/
+void user_table_row(const user_table_t *table, size_t position, user_row_t *row);
+
+/*
+   Function that reads the row at cursor and moves the cursor to the next row.
+   Start with cursor at 0. Return false when there are no more rows.
+*/
+_Bool user_table_next(const user_table_t *table, size_t *cursor, user_row_t *row);
+
+
+#endif
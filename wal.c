@@ -0,0 +1,487 @@
+/**
+ * @file wal.c
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This file contains the implementation of the write-ahead log. Records are
+ * encoded in a memory buffer when a change is made, and written to the file
+ * when a thread commits them.
+ *
+ * With group commit, the first thread that commits becomes the leader: it
+ * takes the whole buffer, writes it and syncs the file once, while the other
+ * threads append to a second buffer and wait. When the sync is done, every
+ * thread whose records were written returns, and one of the others becomes
+ * the next leader. The more threads commit at the same time, the more
+ * records share a sync.
+ *
+ * When a write fails, the file is cut back to its last complete record and
+ * the records that were not written go back in front of the buffer, so the
+ * next commit writes them again. The threads that were waiting for them are
+ * told that the commit failed, and the log works again once a write succeeds.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "nodes.h"
+#include "functions.h"
+#include "user_index.h"
+#include "password.h"
+#include "wal.h"
+
+#define MAGIC_LENGTH 8
+#define RECORD_HEADER_SIZE 8                // payload length and checksum
+#define FIXED_PAYLOAD_SIZE 17               // type, number and time
+#define INITIAL_BUFFER_SIZE (64 * 1024)
+
+static uint32_t crc_table[256];
+static pthread_once_t crc_once = PTHREAD_ONCE_INIT;
+
+static pthread_mutex_t wal_lock = PTHREAD_MUTEX_INITIALIZER; // protects the fields below
+static pthread_cond_t wal_written = PTHREAD_COND_INITIALIZER;
+static int wal_fd = -1;
+static wal_sync_t wal_mode = WAL_SYNC_GROUP;
+static char *buffer = NULL;                 // records not written yet
+static size_t buffer_used = 0;
+static size_t buffer_capacity = 0;
+static char *spare = NULL;                  // the buffer being written by the leader
+static size_t spare_capacity = 0;
+static uint64_t appended_lsn = 0;           // number of records appended, never reset
+static uint64_t durable_lsn = 0;            // number of records on the disk
+static _Bool writing = 0;                   // a leader is writing the spare buffer
+static _Bool write_failed = 0;              // the last write failed, reported once until one succeeds
+static uint64_t failed_writes = 0;          // number of writes that failed, never reset
+static uint64_t failed_lsn = 0;             // the last record of the last write that failed
+static off_t durable_size = 0;              // the size of the file up to its last complete record
+static wal_stats_t wal_stats;
+static uint64_t base_records = 0;           // records of the file written before it was opened, minus appended_lsn
+
+static __thread uint64_t thread_lsn = 0;    // the last record appended by the thread
+
+
+/*
+   Function that fills the table of the CRC-32 (IEEE) checksum.
+*/
+static void crc_init()
+{
+   for (uint32_t i = 0; i < 256; i++) {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; bit++) {
+         crc = (crc >> 1) ^ (crc & 1 ? 0xEDB88320u : 0);
+      }
+      crc_table[i] = crc;
+   }
+}
+
+
+/*
+   Function that computes the CRC-32 checksum of a payload.
+*/
+static uint32_t crc32(const char *data, size_t length)
+{
+   uint32_t crc = 0xFFFFFFFFu;
+   for (size_t i = 0; i < length; i++) {
+      crc = crc_table[(crc ^ (unsigned char)data[i]) & 0xFF] ^ (crc >> 8);
+   }
+   return crc ^ 0xFFFFFFFFu;
+}
+
+
+/*
+   Function that writes a whole buffer to a file, even if the system writes it in parts.
+   Return 0 on success and -1 on error.
+*/
+static int write_all(int fd, const char *data, size_t length)
+{
+   while (length > 0) {
+      ssize_t written = write(fd, data, length);
+      if (written < 0) {
+         if (errno == EINTR) {
+            continue;
+         }
+         return -1;
+      }
+      data += written;
+      length -= written;
+   }
+   return 0;
+}
+
+
+/*
+   Function that writes records to the log and syncs it. A write that failed may have left part
+   of its records in the file, they are cut before the records are written again.
+   Return 0 on success and -1 on error; the error is only reported once until a write succeeds.
+*/
+static int write_records(const char *data, size_t length)
+{
+   if ((!write_failed || ftruncate(wal_fd, durable_size) == 0)
+       && write_all(wal_fd, data, length) == 0 && fdatasync(wal_fd) == 0) {
+      if (write_failed) {
+         fprintf(stderr, "The log is written again\n");
+      }
+      durable_size += length;
+      write_failed = 0;
+      return 0;
+   }
+   if (!write_failed) {
+      perror("Error writing the log");
+   }
+   write_failed = 1;
+   ftruncate(wal_fd, durable_size);
+   return -1;
+}
+
+
+/*
+   Function that replays one record on the users.
+   Return true if the change was applied and false otherwise.
+*/
+static _Bool apply_record(user_t **users, wal_type_t type, uint64_t number, int64_t time, char *name, char *text)
+{
+   credential_t credential;
+   if ((type == WAL_ADD_USER || type == WAL_PASSWORD) && !credential_decode(text, &credential)) {
+      return 0;
+   }
+   if (type == WAL_ADD_USER) {
+      return insert_user_credential(users, name, &credential) != NULL;
+   }
+
+   user_t *user = index_find_user(name);
+   if (user == NULL) {
+      return 0;
+   }
+   switch (type) {
+      case WAL_PASSWORD:
+         set_credential(user, &credential);
+         return 1;
+
+      case WAL_POST:
+         // the post keeps its id, so that the deletions that follow find it
+         return add_post_at(user, text, number, time) != NULL;
+
+      case WAL_DELETE_POST:
+         return delete_post_by_id(user, number);
+
+      case WAL_FRIEND:
+         return add_friend(user, text);
+
+      case WAL_UNFRIEND:
+         return delete_friend(user, text);
+
+      default:
+         return 0;
+   }
+}
+
+
+/*
+   Function that reads every record of a log and applies the changes to the users,
+   except the first skip records, which the users already include.
+   An incomplete or corrupted last record, left by a crash, is cut from the file. A damaged
+   record followed by others is an error: the file is left as it is and the offset of the
+   record is stored in stats->damaged. A log that does not exist yet is empty.
+   Return 0 on success and -1 on error.
+*/
+int wal_replay(const char *path, user_t **users, uint64_t skip, wal_replay_stats_t *stats)
+{
+   pthread_once(&crc_once, crc_init);
+   memset(stats, 0, sizeof(*stats));
+
+   int fd = open(path, O_RDONLY);
+   if (fd < 0) {
+      return errno == ENOENT ? 0 : -1;
+   }
+   struct stat file_stat;
+   if (fstat(fd, &file_stat) != 0) {
+      close(fd);
+      return -1;
+   }
+   size_t size = file_stat.st_size;
+   char *data = malloc(size + 1);
+   size_t read_size = 0;
+   while (data != NULL && read_size < size) {
+      ssize_t result = read(fd, data + read_size, size - read_size);
+      if (result <= 0) {
+         break;
+      }
+      read_size += result;
+   }
+   close(fd);
+   if (data == NULL || read_size != size) {
+      free(data);
+      return -1;
+   }
+   if (size == 0) {
+      free(data);
+      return 0; // created but never written
+   }
+   if (size < MAGIC_LENGTH || memcmp(data, WAL_MAGIC, MAGIC_LENGTH) != 0) {
+      free(data);
+      errno = EINVAL;
+      return -1;
+   }
+
+   size_t offset = MAGIC_LENGTH;
+   while (offset + RECORD_HEADER_SIZE <= size) {
+      uint32_t length;
+      uint32_t checksum;
+      memcpy(&length, data + offset, sizeof(length));
+      memcpy(&checksum, data + offset + sizeof(length), sizeof(checksum));
+      char *payload = data + offset + RECORD_HEADER_SIZE;
+      if (length > size - offset - RECORD_HEADER_SIZE) {
+         break; // incomplete, the end of the valid records
+      }
+      _Bool valid = length >= FIXED_PAYLOAD_SIZE + 2 && crc32(payload, length) == checksum && payload[length - 1] == '\0';
+      char *name = payload + FIXED_PAYLOAD_SIZE;
+      char *text = valid ? name + strlen(name) + 1 : NULL;
+      if (!valid || text >= payload + length) {
+         if (offset + RECORD_HEADER_SIZE + length == size) {
+            break; // the last record was not completely written
+         }
+         // the records after it can not be applied without it
+         stats->damaged = offset;
+         free(data);
+         errno = EINVAL;
+         return -1;
+      }
+
+      uint64_t number;
+      int64_t time;
+      memcpy(&number, payload + 1, sizeof(number));
+      memcpy(&time, payload + 9, sizeof(time));
+
+      if (stats->records < skip) {
+         stats->skipped++;
+      } else if (!apply_record(users, (wal_type_t)payload[0], number, time, name, text)) {
+         stats->failed++;
+      }
+      stats->records++;
+      offset += RECORD_HEADER_SIZE + length;
+   }
+   free(data);
+
+   // later records are appended after the last valid one
+   stats->bytes = offset - MAGIC_LENGTH;
+   stats->truncated = size - offset;
+   if (stats->truncated > 0 && truncate(path, offset) != 0) {
+      return -1;
+   }
+   return 0;
+}
+
+
+/*
+   Function that opens a log to append the changes to it, creating it if needed.
+   records is the number of records already in the log, as counted by wal_replay.
+   Return 0 on success and -1 on error.
+*/
+int wal_open(const char *path, wal_sync_t mode, uint64_t records)
+{
+   pthread_once(&crc_once, crc_init);
+   int fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+   if (fd < 0) {
+      return -1;
+   }
+   struct stat file_stat;
+   if (fstat(fd, &file_stat) != 0 || (file_stat.st_size == 0 && write_all(fd, WAL_MAGIC, MAGIC_LENGTH) != 0)) {
+      close(fd);
+      return -1;
+   }
+
+   pthread_mutex_lock(&wal_lock);
+   wal_fd = fd;
+   durable_size = file_stat.st_size > 0 ? file_stat.st_size : MAGIC_LENGTH;
+   wal_mode = mode;
+   base_records = records - appended_lsn;
+   write_failed = 0;
+   memset(&wal_stats, 0, sizeof(wal_stats));
+   pthread_mutex_unlock(&wal_lock);
+   return 0;
+}
+
+
+/*
+   Function that makes sure a buffer can hold more bytes.
+*/
+static void reserve(char **data, size_t *capacity, size_t needed)
+{
+   if (needed <= *capacity) {
+      return;
+   }
+   size_t new_capacity = *capacity == 0 ? INITIAL_BUFFER_SIZE : *capacity;
+   while (new_capacity < needed) {
+      new_capacity *= 2;
+   }
+   char *new_data = realloc(*data, new_capacity);
+   if (new_data == NULL) {
+      perror("Error growing the log buffer");
+      exit(1);
+   }
+   *data = new_data;
+   *capacity = new_capacity;
+}
+
+
+/*
+   Function that appends a change to the log, if it is open. With WAL_SYNC_EACH the
+   record is on the disk when the function returns, otherwise it is only when
+   wal_commit is called.
+*/
+void wal_log(wal_type_t type, const char *name, const char *text, uint64_t number, int64_t time)
+{
+   if (wal_fd < 0) {
+      return; // not logging, e.g. while loading or replaying
+   }
+   if (text == NULL) {
+      text = "";
+   }
+
+   size_t name_length = strlen(name) + 1;
+   size_t text_length = strlen(text) + 1;
+   uint32_t length = FIXED_PAYLOAD_SIZE + name_length + text_length;
+
+   pthread_mutex_lock(&wal_lock);
+   reserve(&buffer, &buffer_capacity, buffer_used + RECORD_HEADER_SIZE + length);
+   char *record = buffer + buffer_used;
+   char *payload = record + RECORD_HEADER_SIZE;
+   payload[0] = (char)type;
+   memcpy(payload + 1, &number, sizeof(number));
+   memcpy(payload + 9, &time, sizeof(time));
+   memcpy(payload + FIXED_PAYLOAD_SIZE, name, name_length);
+   memcpy(payload + FIXED_PAYLOAD_SIZE + name_length, text, text_length);
+   uint32_t checksum = crc32(payload, length);
+   memcpy(record, &length, sizeof(length));
+   memcpy(record + sizeof(length), &checksum, sizeof(checksum));
+   buffer_used += RECORD_HEADER_SIZE + length;
+
+   thread_lsn = ++appended_lsn;
+   wal_stats.records++;
+   wal_stats.bytes += RECORD_HEADER_SIZE + length;
+
+   // a record that can not be written stays in the buffer for the next commit, which also
+   // writes it if a leader is writing now
+   if (wal_mode == WAL_SYNC_EACH && !writing && write_records(buffer, buffer_used) == 0) {
+      buffer_used = 0;
+      durable_lsn = appended_lsn;
+      wal_stats.syncs++;
+   }
+   pthread_mutex_unlock(&wal_lock);
+}
+
+
+/*
+   Function that waits until every record appended by the calling thread is on the disk.
+   Return 0 on success and -1 if the log could not be written; the records that were not
+   written are written again by the next commit.
+*/
+int wal_commit()
+{
+   int result = 0;
+   pthread_mutex_lock(&wal_lock);
+   while (durable_lsn < thread_lsn) {
+      if (writing) {
+         // the leader is writing older records, the next write includes this thread's records
+         uint64_t failures = failed_writes;
+         pthread_cond_wait(&wal_written, &wal_lock);
+         if (failed_writes != failures && failed_lsn >= thread_lsn) {
+            result = -1;  // the write that held this thread's records failed
+            break;
+         }
+         continue;
+      }
+
+      // become the leader: new records go to the other buffer while this one is written
+      writing = 1;
+      char *data = buffer;
+      size_t length = buffer_used;
+      uint64_t lsn = appended_lsn;
+      buffer = spare;
+      spare = data;
+      size_t capacity = buffer_capacity;
+      buffer_capacity = spare_capacity;
+      spare_capacity = capacity;
+      buffer_used = 0;
+      pthread_mutex_unlock(&wal_lock);
+
+      int written = write_records(data, length);
+
+      pthread_mutex_lock(&wal_lock);
+      writing = 0;
+      if (written != 0) {
+         // the records go back in front of the ones appended during the write
+         reserve(&spare, &spare_capacity, length + buffer_used);
+         memcpy(spare + length, buffer, buffer_used);
+         char *swapped = buffer;
+         buffer = spare;
+         spare = swapped;
+         capacity = buffer_capacity;
+         buffer_capacity = spare_capacity;
+         spare_capacity = capacity;
+         buffer_used += length;
+         failed_writes++;
+         failed_lsn = lsn;
+         pthread_cond_broadcast(&wal_written);
+         result = -1;
+         break;
+      }
+      durable_lsn = lsn;
+      wal_stats.syncs++;
+      pthread_cond_broadcast(&wal_written);
+   }
+   pthread_mutex_unlock(&wal_lock);
+   return result;
+}
+
+
+/*
+   Function that returns the number of records in the log once every appended record is
+   written, or 0 if the log is not open.
+*/
+uint64_t wal_position()
+{
+   pthread_mutex_lock(&wal_lock);
+   uint64_t position = wal_fd >= 0 ? base_records + appended_lsn : 0;
+   pthread_mutex_unlock(&wal_lock);
+   return position;
+}
+
+
+/*
+   Function that copies the statistics of the log.
+*/
+void wal_get_stats(wal_stats_t *stats)
+{
+   pthread_mutex_lock(&wal_lock);
+   *stats = wal_stats;
+   pthread_mutex_unlock(&wal_lock);
+}
+
+
+/*
+   Function that writes the remaining records and closes the log.
+*/
+void wal_close()
+{
+   if (wal_fd < 0) {
+      return;
+   }
+   thread_lsn = appended_lsn;
+   wal_commit();
+
+   pthread_mutex_lock(&wal_lock);
+   close(wal_fd);
+   wal_fd = -1;
+   free(buffer);
+   free(spare);
+   buffer = spare = NULL;
+   buffer_used = buffer_capacity = spare_capacity = 0;
+   pthread_mutex_unlock(&wal_lock);
+}
+
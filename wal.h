@@ -0,0 +1,111 @@
+/**
+ * @file wal.h
+ * @author Lehem Temesgen
+ * @version 10/17/2026
+ * @brief A text-based simulation of basic Facebook functionalities.
+ *
+ * This header file declares the write-ahead log. Every change made to the
+ * users, their friends and posts is appended to the log, which is read back
+ * on startup on top of the users loaded from the CSV file or the snapshot.
+ *
+ * The log is a header followed by records. A record is its payload length
+ * and a CRC-32 of the payload, then the payload: the kind of change, a number,
+ * a time and two NUL terminated strings. Only the last record can be
+ * incomplete or not match its checksum, after a crash; reading stops there.
+ * Such a record anywhere else means the file is damaged, and it is not read.
+ */
+
+#ifndef __A2_WAL_H__
+#define __A2_WAL_H__
+#include <stddef.h>
+#include <stdint.h>
+#include "nodes.h"
+
+#define WAL_MAGIC "FBWAL003"
+
+// The kinds of changes
+typedef enum wal_type
+{
+    WAL_ADD_USER = 1,       // name: username, text: credential, see credential_encode
+    WAL_PASSWORD,           // name: username, text: new credential
+    WAL_POST,               // name: author, text: content, number: post id, time: creation time
+    WAL_DELETE_POST,        // name: username, number: post id
+    WAL_FRIEND,             // name: username, text: friend's username
+    WAL_UNFRIEND            // name: username, text: friend's username
+} wal_type_t;
+
+// When the records are written to the disk
+typedef enum wal_sync
+{
+    WAL_SYNC_EACH,          // every record is written and synced on its own
+    WAL_SYNC_GROUP          // the records of all the threads waiting for a commit share one sync
+} wal_sync_t;
+
+// Statistics of the log since it was opened
+typedef struct wal_stats
+{
+    uint64_t records;
+    uint64_t syncs;
+    uint64_t bytes;
+} wal_stats_t;
+
+// Statistics of a replay
+typedef struct wal_replay_stats
+{
+    size_t records;         // records read from the log
+    size_t skipped;         // records already included in the snapshot the users were loaded from
+    size_t failed;          // records that could not be applied
+    size_t bytes;           // bytes of valid records
+    size_t truncated;       // bytes of an incomplete or corrupted record cut from the end of the log
+    size_t damaged;         // offset of a damaged record followed by others, 0 if there is none
+} wal_replay_stats_t;
+
+/*
+   Function that reads every record of a log and applies the changes to the users,
+   except the first skip records, which the users already include.
+   An incomplete or corrupted last record, left by a crash, is cut from the file. A damaged
+   record followed by others is an error: the file is left as it is and the offset of the
+   record is stored in stats->damaged. A log that does not exist yet is empty.
+   Return 0 on success and -1 on error.
+*/
+int wal_replay(const char *path, user_t **users, uint64_t skip, wal_replay_stats_t *stats);
+
+/*
+   Function that opens a log to append the changes to it, creating it if needed.
+   records is the number of records already in the log, as counted by wal_replay.
+   Return 0 on success and -1 on error.
+*/
+int wal_open(const char *path, wal_sync_t mode, uint64_t records);
+
+/*
+   Function that returns the number of records in the log once every appended record is
+   written, or 0 if the log is not open.
+*/
+uint64_t wal_position();
+
+/*
+   Function that appends a change to the log, if it is open. With WAL_SYNC_EACH the
+   record is on the disk when the function returns, otherwise it is only when
+   wal_commit is called.
+*/
+void wal_log(wal_type_t type, const char *name, const char *text, uint64_t number, int64_t time);
+
+/*
+   Function that waits until every record appended by the calling thread is on the disk.
+   Return 0 on success and -1 if the log could not be written; the records that were not
+   written are written again by the next commit.
+*/
+int wal_commit();
+
+/*
+   Function that copies the statistics of the log.
+*/
+void wal_get_stats(wal_stats_t *stats);
+
+/*
+   Function that writes the remaining records and closes the log.
+*/
+void wal_close();
+
+
+#endif